@@ -1,6 +1,7 @@
 #include "vulkan_include.hpp"
 
 #include <mutex>
+#include <shared_mutex>
 #include <map>
 #include <set>
 #include <chrono>
@@ -10,6 +11,8 @@
 #include <string>
 #include <memory>
 #include <cstring>
+#include <string_view>
+#include <iterator>
 #include <filesystem>
 #include <algorithm>
 
@@ -33,6 +36,10 @@
 #include "settings_manager.hpp"
 #include "fake_swapchain.hpp"
 #include "renderpass.hpp"
+#include "pipeline_cache.hpp"
+#include "frame_sync.hpp"
+#include "frame_context.hpp"
+#include "uniform_ring.hpp"
 #include "format.hpp"
 #include "logger.hpp"
 
@@ -55,9 +62,9 @@ namespace vkBasalt
 {
     std::shared_ptr<Config> pBaseConfig = nullptr;  // Always vkBasalt.conf
     std::shared_ptr<Config> pConfig = nullptr;      // Current config (base + overlay)
-    EffectRegistry effectRegistry;                   // Single source of truth for effect configs
+    Logger Logger::s_instance;  // Defined first so it outlives the registry's compile thread at unload
 
-    Logger Logger::s_instance;
+    EffectRegistry effectRegistry;                   // Single source of truth for effect configs
 
     // layer book-keeping information, to store dispatch tables by key
     std::unordered_map<void*, InstanceDispatch>                           instanceDispatchMap;
@@ -66,12 +73,18 @@ namespace vkBasalt
     std::unordered_map<void*, std::shared_ptr<LogicalDevice>>             deviceMap;
     std::unordered_map<VkSwapchainKHR, std::shared_ptr<LogicalSwapchain>> swapchainMap;
 
-    std::mutex globalLock;
+    // globalLock serializes swapchains, present and everything effects and the overlay use (swapchainMap included).
+    // The instance and device maps only change on creation/destruction, so lookups take mapLock shared and don't wait
+    // for a present. LogicalDevice::depthLock guards depth tracking, taken after globalLock when both are needed.
+    std::mutex        globalLock;
+    std::shared_mutex mapLock;
 #ifdef _GCC_
     using scoped_lock __attribute__((unused)) = std::lock_guard<std::mutex>;
 #else
     using scoped_lock = std::lock_guard<std::mutex>;
 #endif
+    using shared_map_lock = std::shared_lock<std::shared_mutex>;
+    using unique_map_lock = std::unique_lock<std::shared_mutex>;
 
     template<typename DispatchableType>
     void* GetKey(DispatchableType inst)
@@ -79,6 +92,22 @@ namespace vkBasalt
         return *(void**) inst;
     }
 
+    // Map lookups, entries stay valid while the app uses the instance/device (rehashing doesn't move them)
+    template<typename DispatchableType>
+    LogicalDevice* getLogicalDevice(DispatchableType dispatchable)
+    {
+        shared_map_lock l(mapLock);
+        auto            it = deviceMap.find(GetKey(dispatchable));
+        return it != deviceMap.end() ? it->second.get() : nullptr;
+    }
+
+    template<typename DispatchableType>
+    InstanceDispatch& getInstanceDispatch(DispatchableType dispatchable)
+    {
+        shared_map_lock l(mapLock);
+        return instanceDispatchMap.at(GetKey(dispatchable));
+    }
+
     // Cached available effects data (to avoid re-parsing config every frame)
     struct CachedEffectsData
     {
@@ -107,8 +136,23 @@ namespace vkBasalt
         bool pending = false;
     };
     ResizeDebounceState resizeDebounce;
+
+    // The overlay edits parameters in place. Up to the frame after it closes they may have changed,
+    // after that the effects keep the parameter uniforms they already wrote
+    bool overlayWasVisible = false;
+
+    // Clock and input as the uniforms of this frame see them
+    FrameContext frameContext;
     constexpr int64_t RESIZE_DEBOUNCE_MS = 200;
 
+    // Chain rebuild waiting for background compiles, the current chain keeps presenting meanwhile
+    struct PendingReloadState
+    {
+        std::vector<std::string> effects;
+        bool pending = false;
+    };
+    PendingReloadState pendingReload;
+
     // Helper for key press with debounce - returns true on key-down edge
     bool handleKeyPress(uint32_t keySymbol, bool& wasPressed)
     {
@@ -138,6 +182,8 @@ namespace vkBasalt
     // Get depth state from logical device (returns null handles if no depth images)
     DepthState getDepthState(LogicalDevice* pLogicalDevice)
     {
+        std::lock_guard<std::mutex> l(pLogicalDevice->depthLock);
+
         DepthState state;
         if (!pLogicalDevice->depthImageViews.empty())
         {
@@ -148,29 +194,35 @@ namespace vkBasalt
         return state;
     }
 
+    // Lay out the uniforms of the current effects in a new ring, the old one is destroyed once the frames reading it are done
+    void rebuildUniformRing(LogicalDevice* pLogicalDevice, LogicalSwapchain* pLogicalSwapchain)
+    {
+        if (pLogicalSwapchain->uniformRing)
+            retireResources(pLogicalDevice, [oldRing = std::move(pLogicalSwapchain->uniformRing)]() {});
+        pLogicalSwapchain->uniformRing = createUniformRing(pLogicalDevice, pLogicalSwapchain->imageCount, pLogicalSwapchain->effects);
+    }
+
     // Helper to reallocate and rewrite command buffers for a swapchain
     void reallocateCommandBuffers(
         LogicalDevice* pLogicalDevice,
         LogicalSwapchain* pLogicalSwapchain,
         const DepthState& depth)
     {
-        // Free existing command buffers
-        if (!pLogicalSwapchain->commandBuffersEffect.empty())
-        {
-            pLogicalDevice->vkd.FreeCommandBuffers(
-                pLogicalDevice->device, pLogicalDevice->commandPool,
-                pLogicalSwapchain->commandBuffersEffect.size(),
-                pLogicalSwapchain->commandBuffersEffect.data());
-        }
-        if (!pLogicalSwapchain->commandBuffersNoEffect.empty())
+        // Free existing command buffers once the frames using them are done
+        std::vector<VkCommandBuffer> oldCommandBuffers = pLogicalSwapchain->commandBuffersEffect;
+        oldCommandBuffers.insert(oldCommandBuffers.end(),
+                                 pLogicalSwapchain->commandBuffersNoEffect.begin(),
+                                 pLogicalSwapchain->commandBuffersNoEffect.end());
+        if (!oldCommandBuffers.empty())
         {
-            pLogicalDevice->vkd.FreeCommandBuffers(
-                pLogicalDevice->device, pLogicalDevice->commandPool,
-                pLogicalSwapchain->commandBuffersNoEffect.size(),
-                pLogicalSwapchain->commandBuffersNoEffect.data());
+            retireResources(pLogicalDevice, [pLogicalDevice, oldCommandBuffers]() {
+                pLogicalDevice->vkd.FreeCommandBuffers(
+                    pLogicalDevice->device, pLogicalDevice->commandPool, oldCommandBuffers.size(), oldCommandBuffers.data());
+            });
         }
 
         // Allocate and write effect command buffers
+        rebuildUniformRing(pLogicalDevice, pLogicalSwapchain);
         pLogicalSwapchain->commandBuffersEffect = allocateCommandBuffer(pLogicalDevice, pLogicalSwapchain->imageCount);
         writeCommandBuffers(pLogicalDevice, pLogicalSwapchain->effects,
                            depth.image, depth.imageView, depth.format,
@@ -361,6 +413,134 @@ namespace vkBasalt
         cachedEffects.initialized = true;
     }
 
+    // Color depth ReShade effects are compiled for (BUFFER_COLOR_BIT_DEPTH)
+    uint32_t getColorDepth(VkFormat format)
+    {
+        return convertToUNORM(format) == VK_FORMAT_A2R10G10B10_UNORM_PACK32 ? 10 : 8;
+    }
+
+    // Effects making up the chain (overlay selection, or the config without overlay)
+    std::vector<std::string> getActiveEffects(LogicalDevice* pLogicalDevice)
+    {
+        return pLogicalDevice->imguiOverlay
+            ? pLogicalDevice->imguiOverlay->getActiveEffects()
+            : pConfig->getOption<std::vector<std::string>>("effects", {});
+    }
+
+    // Rebuild the chain with these effects once all of them are compiled (see QueuePresentKHR)
+    void requestReload(const std::vector<std::string>& effects)
+    {
+        pendingReload.effects = effects;
+        pendingReload.pending = true;
+    }
+
+    // Queue background compiles for everything the chain needs on every swapchain.
+    // Returns true once all modules are ready and the chain can be rebuilt without compiling.
+    bool prepareEffects(const std::vector<std::string>& effects)
+    {
+        bool ready = true;
+        for (auto& [_, pLogicalSwapchain] : swapchainMap)
+        {
+            if (pLogicalSwapchain->fakeImages.empty())
+                continue;
+
+            uint32_t colorDepth = getColorDepth(pLogicalSwapchain->format);
+            for (const auto& name : effects)
+            {
+                if (!effectRegistry.isEffectEnabled(name))
+                    continue;
+                // No short-circuit, so all compiles are queued at once
+                if (effectRegistry.ensureCompiled(name, pLogicalSwapchain->imageExtent.width, pLogicalSwapchain->imageExtent.height, colorDepth))
+                    ready = false;
+            }
+        }
+        return ready;
+    }
+
+    // Identity of a configured effect, an effect object with the same key can be kept across reloads.
+    // Extent and format are implied, effects are only reused within their own swapchain.
+    std::string getEffectKey(const std::string& effectName)
+    {
+        bool isReshade  = !effectRegistry.isEffectBuiltIn(effectName);
+        bool liveParams = isReshade && settingsManager.getLiveParams();
+
+        std::string key = effectName + "|" + effectRegistry.getEffectType(effectName);
+        if (isReshade)
+        {
+            key += liveParams ? "|live" : "|spec";
+            for (const auto& def : effectRegistry.getPreprocessorDefs(effectName))
+                key += "|" + def.name + "=" + def.value;
+        }
+
+        // Parameters are baked into the pipelines unless they are read live from the uniform buffer
+        if (!liveParams)
+        {
+            for (const auto* param : effectRegistry.getParametersForEffect(effectName))
+            {
+                for (const auto& [suffix, value] : param->serialize())
+                    key += "|" + (suffix.empty() ? param->name : suffix) + "=" + value;
+            }
+        }
+        return key;
+    }
+
+    // Drop the effects kept for incremental reloads, so the next reload rebuilds everything
+    // (needed when the config file changed under effects that read it at creation)
+    void forgetReusableEffects()
+    {
+        for (auto& [_, pLogicalSwapchain] : swapchainMap)
+            pLogicalSwapchain->effectBindings.clear();
+    }
+
+    // The app renders into the first fake image set and effects ping-pong between two sets after it
+    // (effects run one after another, so only an input and an output are live at once).
+    // The set an effect writes is the one the previous effect read, the effect barriers order that write-after-read.
+    constexpr size_t maxPingPongSets = 2;
+
+    // Allocate the ping-pong sets a chain of effectCount effects needs, sets it no longer needs are
+    // freed once the frames in flight are done with them
+    void resizePingPongSets(LogicalSwapchain* pLogicalSwapchain, size_t effectCount)
+    {
+        LogicalDevice* pLogicalDevice = pLogicalSwapchain->pLogicalDevice;
+        size_t         setCount       = std::min(effectCount > 0 ? effectCount - 1 : 0, maxPingPongSets);
+
+        while (pLogicalSwapchain->pingPongSets.size() > setCount)
+        {
+            FakeImageSet set = std::move(pLogicalSwapchain->pingPongSets.back());
+            pLogicalSwapchain->pingPongSets.pop_back();
+            untrackStorageImages(pLogicalDevice, set.images);
+            retireResources(pLogicalDevice, [pLogicalDevice, set]() { destroyFakeImageSet(pLogicalDevice, set); });
+            Logger::debug("released ping-pong image set " + std::to_string(pLogicalSwapchain->pingPongSets.size()));
+        }
+        while (pLogicalSwapchain->pingPongSets.size() < setCount)
+        {
+            Logger::debug("allocating ping-pong image set " + std::to_string(pLogicalSwapchain->pingPongSets.size()));
+            pLogicalSwapchain->pingPongSets.push_back(
+                createFakeImageSet(pLogicalDevice, pLogicalSwapchain->swapchainCreateInfo, pLogicalSwapchain->imageCount));
+        }
+    }
+
+    // Effect type of a configured effect (handles instance names like "cas.2")
+    std::string getEffectTypeName(const std::string& effectName)
+    {
+        std::string effectType = effectRegistry.getEffectType(effectName);
+        return effectType.empty() ? effectName : effectType;
+    }
+
+    // A lut directly after a built-in that supports it runs in that effect's pass,
+    // which saves writing and reading back a full-resolution image
+    bool canFuseLut(const std::string& effectName, const std::string& nextName, bool checkEnabledState)
+    {
+        for (const auto& name : {effectName, nextName})
+        {
+            if (effectRegistry.hasEffectFailed(name) || (checkEnabledState && !effectRegistry.isEffectEnabled(name)))
+                return false;
+        }
+
+        const auto* def = BuiltInEffects::instance().getDef(getEffectTypeName(effectName));
+        return def && def->fusesLut && getEffectTypeName(nextName) == "lut";
+    }
+
     // Helper function to create effects for a swapchain
     // This centralizes the effect creation logic used by both initial swapchain setup and hot-reload
     void createEffectsForSwapchain(
@@ -368,33 +548,53 @@ namespace vkBasalt
         LogicalDevice* pLogicalDevice,
         Config* pConfig,
         const std::vector<std::string>& effectStrings,
-        bool checkEnabledState = true)
+        bool checkEnabledState = true,
+        std::map<std::string, EffectBinding> reusableEffects = {})
     {
         VkFormat unormFormat = convertToUNORM(pLogicalSwapchain->format);
         VkFormat srgbFormat = convertToSRGB(pLogicalSwapchain->format);
 
+        // Effect i takes effect i + 1 into its pass, the chain has one pass less per fused pair
+        std::vector<bool> lutFused(effectStrings.size(), false);
+        size_t            passCount = effectStrings.size();
+        for (size_t i = 0; i + 1 < effectStrings.size(); i++)
+        {
+            if (canFuseLut(effectStrings[i], effectStrings[i + 1], checkEnabledState))
+            {
+                lutFused[i] = true;
+                passCount--;
+                i++;
+            }
+        }
+
+        resizePingPongSets(pLogicalSwapchain, passCount);
+        if (!pLogicalSwapchain->stencilAttachment)
+            pLogicalSwapchain->stencilAttachment = std::make_shared<StencilAttachment>(pLogicalDevice, pLogicalSwapchain->imageExtent);
+        if (!pLogicalSwapchain->renderTargetPool)
+            pLogicalSwapchain->renderTargetPool = std::make_shared<RenderTargetPool>(pLogicalDevice);
+        std::vector<VkImage> appImages(pLogicalSwapchain->fakeImages.begin(),
+                                       pLogicalSwapchain->fakeImages.begin() + pLogicalSwapchain->imageCount);
+
         // If no effects, add pass-through so rendering still works
         if (effectStrings.empty())
         {
-            std::vector<VkImage> firstImages(pLogicalSwapchain->fakeImages.begin(),
-                                             pLogicalSwapchain->fakeImages.begin() + pLogicalSwapchain->imageCount);
             pLogicalSwapchain->effects.push_back(std::shared_ptr<Effect>(new TransferEffect(
                 pLogicalDevice, pLogicalSwapchain->format, pLogicalSwapchain->imageExtent,
-                firstImages, pLogicalSwapchain->images, pConfig)));
+                appImages, pLogicalSwapchain->images, pConfig)));
             return;
         }
 
-        for (uint32_t i = 0; i < effectStrings.size(); i++)
+        for (size_t i = 0, pass = 0; i < effectStrings.size(); i += lutFused[i] ? 2 : 1, pass++)
         {
-            Logger::debug("creating effect " + std::to_string(i) + ": " + effectStrings[i]);
+            Logger::debug("creating effect " + std::to_string(i) + ": " + effectStrings[i]
+                          + (lutFused[i] ? " with fused " + effectStrings[i + 1] : ""));
 
-            // Calculate input images for this effect
-            std::vector<VkImage> firstImages(pLogicalSwapchain->fakeImages.begin() + pLogicalSwapchain->imageCount * i,
-                                             pLogicalSwapchain->fakeImages.begin() + pLogicalSwapchain->imageCount * (i + 1));
+            // Calculate input images for this effect - the app's images, then the ping-pong set the previous effect wrote
+            std::vector<VkImage> firstImages = pass == 0 ? appImages : pLogicalSwapchain->pingPongSets[(pass - 1) % maxPingPongSets].images;
 
             // Calculate output images - last effect writes to swapchain or final fake images
             std::vector<VkImage> secondImages;
-            if (i == effectStrings.size() - 1)
+            if (pass == passCount - 1)
             {
                 secondImages = pLogicalDevice->supportsMutableFormat
                     ? pLogicalSwapchain->images
@@ -403,26 +603,51 @@ namespace vkBasalt
             }
             else
             {
-                secondImages = std::vector<VkImage>(pLogicalSwapchain->fakeImages.begin() + pLogicalSwapchain->imageCount * (i + 1),
-                                                    pLogicalSwapchain->fakeImages.begin() + pLogicalSwapchain->imageCount * (i + 2));
+                secondImages = pLogicalSwapchain->pingPongSets[pass % maxPingPongSets].images;
             }
 
-            // Check if effect should be skipped (disabled or failed)
+            // Check if effect should be skipped (disabled, failed or still compiling)
             bool effectFailed = effectRegistry.hasEffectFailed(effectStrings[i]);
             bool effectDisabled = checkEnabledState && !effectRegistry.isEffectEnabled(effectStrings[i]);
+            bool effectCompiling = !effectFailed && !effectDisabled
+                && effectRegistry.ensureCompiled(effectStrings[i], pLogicalSwapchain->imageExtent.width,
+                                                 pLogicalSwapchain->imageExtent.height, getColorDepth(pLogicalSwapchain->format));
 
-            if (effectFailed || effectDisabled)
+            // Swapped for the real effect once its background compile is done
+            if (effectCompiling)
+                requestReload(effectStrings);
+
+            if (effectFailed || effectDisabled || effectCompiling)
             {
-                Logger::debug("effect " + std::string(effectFailed ? "failed" : "disabled") + ", using pass-through: " + effectStrings[i]);
+                Logger::debug("effect " + std::string(effectFailed ? "failed" : effectDisabled ? "disabled" : "compiling") +
+                              ", using pass-through: " + effectStrings[i]);
                 pLogicalSwapchain->effects.push_back(std::shared_ptr<Effect>(
                     new TransferEffect(pLogicalDevice, pLogicalSwapchain->format, pLogicalSwapchain->imageExtent, firstImages, secondImages, pConfig)));
                 continue;
             }
 
-            // Get effect type from registry (handles instance names like "cas.2")
-            std::string effectType = effectRegistry.getEffectType(effectStrings[i]);
-            if (effectType.empty())
-                effectType = effectStrings[i];
+            // Keep the effect from the previous chain if nothing it was built from changed,
+            // moving it to its new slot if it supports that
+            std::string effectKey = getEffectKey(effectStrings[i]) + (lutFused[i] ? "+" + getEffectKey(effectStrings[i + 1]) : "");
+            auto        previous  = reusableEffects.find(effectKey);
+            if (previous != reusableEffects.end())
+            {
+                EffectBinding binding = std::move(previous->second);
+                reusableEffects.erase(previous);
+
+                bool sameSlots = binding.input == firstImages[0] && binding.output == secondImages[0];
+                if (sameSlots || binding.effect->rebindImages(firstImages, secondImages))
+                {
+                    Logger::debug("keeping unchanged effect: " + effectStrings[i]);
+                    binding.input  = firstImages[0];
+                    binding.output = secondImages[0];
+                    pLogicalSwapchain->effects.push_back(binding.effect);
+                    pLogicalSwapchain->effectBindings.push_back(std::move(binding));
+                    continue;
+                }
+            }
+
+            std::string effectType = getEffectTypeName(effectStrings[i]);
 
             // Create the appropriate effect type
             const auto* def = BuiltInEffects::instance().getDef(effectType);
@@ -433,12 +658,22 @@ namespace vkBasalt
                 {
                     VkFormat format = def->usesSrgbFormat ? srgbFormat : unormFormat;
                     pLogicalSwapchain->effects.push_back(
-                        def->factory(pLogicalDevice, format, pLogicalSwapchain->imageExtent, firstImages, secondImages, pConfig));
+                        def->factory(pLogicalDevice, format, pLogicalSwapchain->imageExtent, firstImages, secondImages, pConfig, lutFused[i]));
+                    pLogicalSwapchain->effectBindings.push_back({effectKey, firstImages[0], secondImages[0], pLogicalSwapchain->effects.back()});
                 }
                 catch (const std::exception& e)
                 {
                     Logger::err("Failed to create built-in effect " + effectStrings[i] + ": " + e.what());
-                    effectRegistry.setEffectError(effectStrings[i], e.what());
+                    // Most likely the lut file, the effect itself gets its own pass after the reload
+                    if (lutFused[i])
+                    {
+                        effectRegistry.setEffectError(effectStrings[i + 1], e.what());
+                        requestReload(effectStrings);
+                    }
+                    else
+                    {
+                        effectRegistry.setEffectError(effectStrings[i], e.what());
+                    }
                     pLogicalSwapchain->effects.push_back(std::shared_ptr<Effect>(
                         new TransferEffect(pLogicalDevice, pLogicalSwapchain->format, pLogicalSwapchain->imageExtent, firstImages, secondImages, pConfig)));
                 }
@@ -452,7 +687,8 @@ namespace vkBasalt
                 {
                     pLogicalSwapchain->effects.push_back(std::shared_ptr<Effect>(new ReshadeEffect(
                         pLogicalDevice, pLogicalSwapchain->format, pLogicalSwapchain->imageExtent,
-                        firstImages, secondImages, &effectRegistry, effectStrings[i], effectPath, customDefs)));
+                        firstImages, secondImages, pLogicalSwapchain->stencilAttachment, pLogicalSwapchain->renderTargetPool.get(), &effectRegistry, effectStrings[i], effectPath, customDefs)));
+                    pLogicalSwapchain->effectBindings.push_back({effectKey, firstImages[0], secondImages[0], pLogicalSwapchain->effects.back()});
                 }
                 catch (const std::exception& e)
                 {
@@ -480,10 +716,17 @@ namespace vkBasalt
     {
         LogicalDevice* pLogicalDevice = pLogicalSwapchain->pLogicalDevice;
 
-        // Wait for GPU to finish
-        pLogicalDevice->vkd.QueueWaitIdle(pLogicalDevice->queue);
-
-        // Clear effects (command buffers will be freed by reallocateCommandBuffers)
+        // Effects of the old chain that can be kept, the rest is retired with the old chain below
+        std::map<std::string, EffectBinding> reusableEffects;
+        for (auto& binding : pLogicalSwapchain->effectBindings)
+            reusableEffects[binding.key] = std::move(binding);
+        pLogicalSwapchain->effectBindings.clear();
+
+        // Frames in flight may still use the old effects, they are destroyed once those complete
+        // (command buffers are retired by reallocateCommandBuffers)
+        std::vector<std::shared_ptr<Effect>> oldEffects = std::move(pLogicalSwapchain->effects);
+        oldEffects.push_back(std::move(pLogicalSwapchain->defaultTransfer));
+        retireResources(pLogicalDevice, [oldEffects = std::move(oldEffects)]() {});
         pLogicalSwapchain->effects.clear();
         pLogicalSwapchain->defaultTransfer.reset();
 
@@ -491,20 +734,10 @@ namespace vkBasalt
         // Registry is the single source of truth (initialized at first swapchain creation)
         std::vector<std::string> effectStrings = activeEffects;
 
-        // Check if we have enough fake images for the effects
-        // Fake images are allocated at swapchain creation based on maxEffectSlots
-        if (effectStrings.size() > pLogicalSwapchain->maxEffectSlots)
-        {
-            Logger::warn("Cannot add more effects than maxEffectSlots (" +
-                        std::to_string(effectStrings.size()) + " > " + std::to_string(pLogicalSwapchain->maxEffectSlots) +
-                        "). Increase maxEffects in config.");
-            effectStrings.resize(pLogicalSwapchain->maxEffectSlots);
-        }
-
         Logger::info("reloading " + std::to_string(effectStrings.size()) + " effects");
 
         // Create effects using centralized helper
-        createEffectsForSwapchain(pLogicalSwapchain, pLogicalDevice, pConfig, effectStrings, true);
+        createEffectsForSwapchain(pLogicalSwapchain, pLogicalDevice, pConfig, effectStrings, true, std::move(reusableEffects));
 
         // Create default transfer effect (needed for no-effect command buffers)
         pLogicalSwapchain->defaultTransfer = std::shared_ptr<Effect>(new TransferEffect(
@@ -519,6 +752,9 @@ namespace vkBasalt
         DepthState depth = getDepthState(pLogicalDevice);
         reallocateCommandBuffers(pLogicalDevice, pLogicalSwapchain, depth);
 
+        // Persist newly compiled pipelines now, games are often killed without DestroyDevice
+        savePipelineCacheInBackground(pLogicalDevice);
+
         Logger::info("effects reloaded successfully");
     }
 
@@ -549,6 +785,12 @@ namespace vkBasalt
         overlayState.configPath = pConfig->getConfigFilePath();
         overlayState.configName = std::filesystem::path(overlayState.configPath).filename().string();
         overlayState.effectsEnabled = effectsEnabled;
+        for (const auto& [_, pLogicalSwapchain] : swapchainMap)
+        {
+            overlayState.effectImageMemory += pLogicalSwapchain->fakeImageMemorySize;
+            for (const auto& set : pLogicalSwapchain->pingPongSets)
+                overlayState.effectImageMemory += set.memorySize;
+        }
 
         // Ensure all selected effects are in the registry
         for (const auto& effectName : pLogicalDevice->imguiOverlay->getSelectedEffects())
@@ -564,40 +806,15 @@ namespace vkBasalt
         pLogicalDevice->imguiOverlay->updateState(std::move(overlayState));
     }
 
-    // Submit overlay command buffer if visible, returns semaphore to wait on
-    VkResult submitOverlayFrame(LogicalDevice* pLogicalDevice, LogicalSwapchain* pSwapchain,
-                                uint32_t index, VkSemaphore& outSemaphore)
+    // Record the overlay for this image if visible, it is submitted in the same batch right after the effects
+    VkCommandBuffer recordOverlayFrame(LogicalDevice* pLogicalDevice, LogicalSwapchain* pSwapchain, uint32_t index)
     {
-        outSemaphore = pSwapchain->semaphores[index];  // Default: wait on effects semaphore
-
         if (!pLogicalDevice->imguiOverlay)
-            return VK_SUCCESS;
+            return VK_NULL_HANDLE;
 
-        VkCommandBuffer overlayCmd = pLogicalDevice->imguiOverlay->recordFrame(
+        return pLogicalDevice->imguiOverlay->recordFrame(
             index, pSwapchain->imageViews[index],
             pSwapchain->imageExtent.width, pSwapchain->imageExtent.height);
-
-        if (overlayCmd == VK_NULL_HANDLE)
-            return VK_SUCCESS;
-
-        VkPipelineStageFlags overlayWaitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        VkSubmitInfo overlaySubmit = {};
-        overlaySubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        overlaySubmit.waitSemaphoreCount = 1;
-        overlaySubmit.pWaitSemaphores = &pSwapchain->semaphores[index];
-        overlaySubmit.pWaitDstStageMask = &overlayWaitStage;
-        overlaySubmit.commandBufferCount = 1;
-        overlaySubmit.pCommandBuffers = &overlayCmd;
-        overlaySubmit.signalSemaphoreCount = 1;
-        overlaySubmit.pSignalSemaphores = &pSwapchain->overlaySemaphores[index];
-
-        // Use fence to track command buffer completion (prevents reuse while in flight)
-        VkFence overlayFence = pLogicalDevice->imguiOverlay->getCommandBufferFence(index);
-        VkResult vr = pLogicalDevice->vkd.QueueSubmit(pLogicalDevice->queue, 1, &overlaySubmit, overlayFence);
-        if (vr == VK_SUCCESS)
-            outSemaphore = pSwapchain->overlaySemaphores[index];
-
-        return vr;
     }
 
     VkResult VKAPI_CALL vkBasalt_CreateInstance(const VkInstanceCreateInfo*  pCreateInfo,
@@ -657,7 +874,7 @@ namespace vkBasalt
 
         // store the table by key
         {
-            scoped_lock l(globalLock);
+            unique_map_lock l(mapLock);
             instanceDispatchMap[GetKey(*pInstance)] = dispatchTable;
             instanceMap[GetKey(*pInstance)]         = *pInstance;
             instanceVersionMap[GetKey(*pInstance)]  = modifiedCreateInfo.pApplicationInfo->apiVersion;
@@ -671,17 +888,18 @@ namespace vkBasalt
         if (!instance)
             return;
 
-        scoped_lock l(globalLock);
-
         Logger::trace("vkDestroyInstance");
 
-        InstanceDispatch dispatchTable = instanceDispatchMap[GetKey(instance)];
+        InstanceDispatch dispatchTable;
+        {
+            unique_map_lock l(mapLock);
+            dispatchTable = instanceDispatchMap[GetKey(instance)];
+            instanceDispatchMap.erase(GetKey(instance));
+            instanceMap.erase(GetKey(instance));
+            instanceVersionMap.erase(GetKey(instance));
+        }
 
         dispatchTable.DestroyInstance(instance, pAllocator);
-
-        instanceDispatchMap.erase(GetKey(instance));
-        instanceMap.erase(GetKey(instance));
-        instanceVersionMap.erase(GetKey(instance));
     }
 
     VkResult VKAPI_CALL vkBasalt_CreateDevice(VkPhysicalDevice             physicalDevice,
@@ -713,27 +931,44 @@ namespace vkBasalt
 
         PFN_vkCreateDevice createFunc = (PFN_vkCreateDevice) gipa(VK_NULL_HANDLE, "vkCreateDevice");
 
+        InstanceDispatch& vki = getInstanceDispatch(physicalDevice);
+        VkInstance        instance;
+        uint32_t          instanceVersion;
+        {
+            shared_map_lock l(mapLock);
+            instance        = instanceMap.at(GetKey(physicalDevice));
+            instanceVersion = instanceVersionMap.at(GetKey(physicalDevice));
+        }
+
         // check and activate extentions
         uint32_t extensionCount = 0;
 
-        instanceDispatchMap[GetKey(physicalDevice)].EnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+        vki.EnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
         std::vector<VkExtensionProperties> extensionProperties(extensionCount);
-        instanceDispatchMap[GetKey(physicalDevice)].EnumerateDeviceExtensionProperties(
-            physicalDevice, nullptr, &extensionCount, extensionProperties.data());
+        vki.EnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensionProperties.data());
 
-        bool supportsMutableFormat = false;
+        bool supportsMutableFormat        = false;
+        bool hasDynamicRenderingExtension = false;
         for (VkExtensionProperties properties : extensionProperties)
         {
             if (properties.extensionName == std::string("VK_KHR_swapchain_mutable_format"))
             {
                 Logger::debug("device supports VK_KHR_swapchain_mutable_format");
                 supportsMutableFormat = true;
-                break;
+            }
+            else if (properties.extensionName == std::string("VK_KHR_dynamic_rendering"))
+            {
+                hasDynamicRenderingExtension = true;
             }
         }
 
         VkPhysicalDeviceProperties deviceProps;
-        instanceDispatchMap[GetKey(physicalDevice)].GetPhysicalDeviceProperties(physicalDevice, &deviceProps);
+        vki.GetPhysicalDeviceProperties(physicalDevice, &deviceProps);
+
+        // Dynamic rendering is core in 1.3, the extension's dependencies are core in 1.2 (its feature is mandatory either way)
+        bool dynamicRenderingCore      = deviceProps.apiVersion >= VK_API_VERSION_1_3 && instanceVersion >= VK_API_VERSION_1_3;
+        bool dynamicRenderingExtension = !dynamicRenderingCore && hasDynamicRenderingExtension && deviceProps.apiVersion >= VK_API_VERSION_1_2
+                                         && instanceVersion >= VK_API_VERSION_1_2;
 
         VkDeviceCreateInfo       modifiedCreateInfo = *pCreateInfo;
         std::vector<const char*> enabledExtensionNames;
@@ -748,52 +983,153 @@ namespace vkBasalt
             Logger::debug("activating mutable_format");
             addUniqueCString(enabledExtensionNames, "VK_KHR_swapchain_mutable_format");
         }
-        if (deviceProps.apiVersion < VK_API_VERSION_1_2 || instanceVersionMap[GetKey(physicalDevice)] < VK_API_VERSION_1_2)
+        if (deviceProps.apiVersion < VK_API_VERSION_1_2 || instanceVersion < VK_API_VERSION_1_2)
         {
             addUniqueCString(enabledExtensionNames, "VK_KHR_image_format_list");
         }
+
+        // The feature has to be enabled too. If the app already chains a struct for it we can't add ours, but use what it enabled.
+        bool supportsDynamicRendering  = dynamicRenderingCore || dynamicRenderingExtension;
+        bool appChainsDynamicRendering = false;
+        for (auto* pStruct = reinterpret_cast<const VkBaseInStructure*>(modifiedCreateInfo.pNext); pStruct; pStruct = pStruct->pNext)
+        {
+            if (pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES)
+            {
+                appChainsDynamicRendering = true;
+                supportsDynamicRendering &= reinterpret_cast<const VkPhysicalDeviceVulkan13Features*>(pStruct)->dynamicRendering == VK_TRUE;
+            }
+            else if (pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES)
+            {
+                appChainsDynamicRendering = true;
+                supportsDynamicRendering &= reinterpret_cast<const VkPhysicalDeviceDynamicRenderingFeatures*>(pStruct)->dynamicRendering == VK_TRUE;
+            }
+        }
+
+        VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures = {};
+        if (supportsDynamicRendering && !appChainsDynamicRendering)
+        {
+            Logger::debug("activating dynamic_rendering");
+            dynamicRenderingFeatures.sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+            dynamicRenderingFeatures.pNext            = const_cast<void*>(modifiedCreateInfo.pNext);
+            dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+            modifiedCreateInfo.pNext                  = &dynamicRenderingFeatures;
+        }
+        if (supportsDynamicRendering && dynamicRenderingExtension)
+            addUniqueCString(enabledExtensionNames, "VK_KHR_dynamic_rendering");
+
         modifiedCreateInfo.ppEnabledExtensionNames = enabledExtensionNames.data();
         modifiedCreateInfo.enabledExtensionCount   = enabledExtensionNames.size();
 
-        // Active needed Features
-        VkPhysicalDeviceFeatures deviceFeatures = {};
-        if (modifiedCreateInfo.pEnabledFeatures)
+        uint32_t queueFamilyCount;
+        vki.GetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> queueProperties(queueFamilyCount);
+        vki.GetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueProperties.data());
+
+        // Optionally request a queue of our own in the app's graphics family, so effects don't serialize with the app's submits.
+        // Same family as the app's queue, so swapchain and fake images need no ownership transfer
+        std::vector<VkDeviceQueueCreateInfo> queueCreateInfos(pCreateInfo->pQueueCreateInfos,
+                                                              pCreateInfo->pQueueCreateInfos + pCreateInfo->queueCreateInfoCount);
+        std::vector<float> queuePriorities;
+        bool               ownQueue = false;
+        if (settingsManager.getEffectQueue())
         {
-            deviceFeatures = *(modifiedCreateInfo.pEnabledFeatures);
+            for (auto& queueInfo : queueCreateInfos)
+            {
+                if (!(queueProperties[queueInfo.queueFamilyIndex].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+                    continue;
+
+                if (queueInfo.flags == 0 && queueInfo.queueCount < queueProperties[queueInfo.queueFamilyIndex].queueCount)
+                {
+                    queuePriorities.assign(queueInfo.pQueuePriorities, queueInfo.pQueuePriorities + queueInfo.queueCount);
+                    queuePriorities.push_back(queuePriorities[0]);
+                    queueInfo.pQueuePriorities = queuePriorities.data();
+                    queueInfo.queueCount++;
+                    ownQueue = true;
+                }
+                else
+                {
+                    Logger::warn("no spare graphics queue, effects share the application's queue");
+                }
+                break;
+            }
+        }
+        modifiedCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
+
+        // Compute effects store to images without a format qualifier, and restrict sRGB views of those images (Vulkan 1.1)
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vki.GetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+        bool supportsStorageWrite = supportedFeatures.shaderStorageImageWriteWithoutFormat && deviceProps.apiVersion >= VK_API_VERSION_1_1
+                                    && instanceVersion >= VK_API_VERSION_1_1;
+
+        // Active needed Features. An app chaining VkPhysicalDeviceFeatures2 has to leave pEnabledFeatures null,
+        // its struct is patched for the call and restored afterwards (the chain is the app's memory)
+        VkPhysicalDeviceFeatures2* pAppFeatures2 = nullptr;
+        for (auto* pStruct = reinterpret_cast<const VkBaseInStructure*>(modifiedCreateInfo.pNext); pStruct; pStruct = pStruct->pNext)
+        {
+            if (pStruct->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2)
+                pAppFeatures2 = reinterpret_cast<VkPhysicalDeviceFeatures2*>(const_cast<VkBaseInStructure*>(pStruct));
         }
+
+        VkPhysicalDeviceFeatures appFeatures = {};
+        if (pAppFeatures2)
+            appFeatures = pAppFeatures2->features;
+        else if (modifiedCreateInfo.pEnabledFeatures)
+            appFeatures = *(modifiedCreateInfo.pEnabledFeatures);
+        VkPhysicalDeviceFeatures deviceFeatures  = appFeatures;
         deviceFeatures.shaderImageGatherExtended = VK_TRUE;
-        modifiedCreateInfo.pEnabledFeatures      = &deviceFeatures;
+        if (supportsStorageWrite)
+            deviceFeatures.shaderStorageImageWriteWithoutFormat = VK_TRUE;
+
+        if (pAppFeatures2)
+            pAppFeatures2->features = deviceFeatures;
+        else
+            modifiedCreateInfo.pEnabledFeatures = &deviceFeatures;
 
         VkResult ret = createFunc(physicalDevice, &modifiedCreateInfo, pAllocator, pDevice);
+        if (pAppFeatures2)
+            pAppFeatures2->features = appFeatures;
 
         if (ret != VK_SUCCESS)
             return ret;
 
         std::shared_ptr<LogicalDevice> pLogicalDevice(new LogicalDevice());
-        pLogicalDevice->vki                   = instanceDispatchMap[GetKey(physicalDevice)];
+        pLogicalDevice->vki                   = vki;
         pLogicalDevice->device                = *pDevice;
         pLogicalDevice->physicalDevice        = physicalDevice;
-        pLogicalDevice->instance              = instanceMap[GetKey(physicalDevice)];
+        pLogicalDevice->instance              = instance;
         pLogicalDevice->queue                 = VK_NULL_HANDLE;
         pLogicalDevice->queueFamilyIndex      = 0;
         pLogicalDevice->commandPool           = VK_NULL_HANDLE;
+        pLogicalDevice->separateQueue         = false;
+        pLogicalDevice->queueHandoffSemaphore = VK_NULL_HANDLE;
+        pLogicalDevice->queueReturnSemaphore  = VK_NULL_HANDLE;
         pLogicalDevice->supportsMutableFormat = supportsMutableFormat;
+        pLogicalDevice->supportsStorageWrite  = supportsStorageWrite;
 
         fillDispatchTableDevice(*pDevice, gdpa, &pLogicalDevice->vkd);
 
-        uint32_t count;
-
-        pLogicalDevice->vki.GetPhysicalDeviceQueueFamilyProperties(pLogicalDevice->physicalDevice, &count, nullptr);
+        // Without 1.3 only the extension's entry points exist
+        if (supportsDynamicRendering && dynamicRenderingExtension)
+        {
+            pLogicalDevice->vkd.CmdBeginRendering = (PFN_vkCmdBeginRendering) gdpa(*pDevice, "vkCmdBeginRenderingKHR");
+            pLogicalDevice->vkd.CmdEndRendering   = (PFN_vkCmdEndRendering) gdpa(*pDevice, "vkCmdEndRenderingKHR");
+        }
+        pLogicalDevice->supportsDynamicRendering =
+            supportsDynamicRendering && pLogicalDevice->vkd.CmdBeginRendering && pLogicalDevice->vkd.CmdEndRendering;
+        Logger::debug(std::string("dynamic rendering: ") + (pLogicalDevice->supportsDynamicRendering ? "yes" : "no"));
 
-        std::vector<VkQueueFamilyProperties> queueProperties(count);
+        // Shared by all effect and overlay pipelines, warm across resizes, config switches and runs
+        pLogicalDevice->pipelineCache = createPipelineCache(pLogicalDevice.get());
 
-        pLogicalDevice->vki.GetPhysicalDeviceQueueFamilyProperties(pLogicalDevice->physicalDevice, &count, queueProperties.data());
         for (uint32_t i = 0; i < pCreateInfo->queueCreateInfoCount; i++)
         {
             auto& queueInfo = pCreateInfo->pQueueCreateInfos[i];
             if ((queueProperties[queueInfo.queueFamilyIndex].queueFlags & VK_QUEUE_GRAPHICS_BIT))
             {
-                pLogicalDevice->vkd.GetDeviceQueue(pLogicalDevice->device, queueInfo.queueFamilyIndex, 0, &pLogicalDevice->queue);
+                // Our own queue comes after the app's queues of the family
+                uint32_t queueIndex = ownQueue ? queueInfo.queueCount : 0;
+                pLogicalDevice->vkd.GetDeviceQueue(pLogicalDevice->device, queueInfo.queueFamilyIndex, queueIndex, &pLogicalDevice->queue);
+                pLogicalDevice->separateQueue = ownQueue;
 
                 VkCommandPoolCreateInfo commandPoolCreateInfo;
                 commandPoolCreateInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -801,7 +1137,7 @@ namespace vkBasalt
                 commandPoolCreateInfo.flags            = 0;
                 commandPoolCreateInfo.queueFamilyIndex = queueInfo.queueFamilyIndex;
 
-                Logger::debug("Found graphics capable queue");
+                Logger::debug(ownQueue ? "Using a separate graphics queue for effects" : "Found graphics capable queue");
                 pLogicalDevice->vkd.CreateCommandPool(pLogicalDevice->device, &commandPoolCreateInfo, nullptr, &pLogicalDevice->commandPool);
                 pLogicalDevice->queueFamilyIndex = queueInfo.queueFamilyIndex;
 
@@ -814,7 +1150,10 @@ namespace vkBasalt
         if (!pLogicalDevice->queue)
             Logger::err("Did not find a graphics queue!");
 
-        deviceMap[GetKey(*pDevice)] = pLogicalDevice;
+        {
+            unique_map_lock l(mapLock);
+            deviceMap[GetKey(*pDevice)] = pLogicalDevice;
+        }
 
         return VK_SUCCESS;
     }
@@ -828,11 +1167,21 @@ namespace vkBasalt
 
         Logger::trace("vkDestroyDevice");
 
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(device)].get();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(device);
 
         // Destroy ImGui overlay before device (it uses device resources)
         pLogicalDevice->imguiOverlay.reset();
 
+        // Release everything still waiting for frames in flight
+        destroyFrameSync(pLogicalDevice);
+
+        destroyPipelineCache(pLogicalDevice);
+
+        if (pLogicalDevice->queueHandoffSemaphore != VK_NULL_HANDLE)
+            pLogicalDevice->vkd.DestroySemaphore(device, pLogicalDevice->queueHandoffSemaphore, nullptr);
+        if (pLogicalDevice->queueReturnSemaphore != VK_NULL_HANDLE)
+            pLogicalDevice->vkd.DestroySemaphore(device, pLogicalDevice->queueReturnSemaphore, nullptr);
+
         if (pLogicalDevice->commandPool != VK_NULL_HANDLE)
         {
             Logger::debug("DestroyCommandPool");
@@ -841,6 +1190,7 @@ namespace vkBasalt
 
         pLogicalDevice->vkd.DestroyDevice(device, pAllocator);
 
+        unique_map_lock ml(mapLock);
         deviceMap.erase(GetKey(device));
     }
 
@@ -853,7 +1203,7 @@ namespace vkBasalt
 
         Logger::trace("vkCreateSwapchainKHR");
 
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(device)].get();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(device);
 
         VkSwapchainCreateInfoKHR modifiedCreateInfo = *pCreateInfo;
 
@@ -881,6 +1231,18 @@ namespace vkBasalt
             modifiedCreateInfo.pNext = &imageFormatListCreateInfo;
         }
 
+        // The last effect writes the swapchain images (mutable format only), let compute effects do that if the surface allows
+        bool storageUsage = false;
+        if (pLogicalDevice->supportsMutableFormat && isStorageFormat(pLogicalDevice, format))
+        {
+            VkSurfaceCapabilitiesKHR surfaceCapabilities;
+            VkResult                 result = pLogicalDevice->vki.GetPhysicalDeviceSurfaceCapabilitiesKHR(
+                pLogicalDevice->physicalDevice, modifiedCreateInfo.surface, &surfaceCapabilities);
+            storageUsage = result == VK_SUCCESS && (surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_STORAGE_BIT);
+            if (storageUsage)
+                modifiedCreateInfo.imageUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+        }
+
         modifiedCreateInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
         Logger::debug("format " + std::to_string(modifiedCreateInfo.imageFormat));
@@ -890,6 +1252,7 @@ namespace vkBasalt
         pLogicalSwapchain->imageExtent         = modifiedCreateInfo.imageExtent;
         pLogicalSwapchain->format              = modifiedCreateInfo.imageFormat;
         pLogicalSwapchain->imageCount          = 0;
+        pLogicalSwapchain->storageUsage        = storageUsage;
 
         VkResult result = pLogicalDevice->vkd.CreateSwapchainKHR(device, &modifiedCreateInfo, pAllocator, pSwapchain);
 
@@ -906,7 +1269,7 @@ namespace vkBasalt
         scoped_lock l(globalLock);
         Logger::trace("vkGetSwapchainImagesKHR " + std::to_string(*pCount));
 
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(device)].get();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(device);
 
         if (pSwapchainImages == nullptr)
         {
@@ -926,6 +1289,8 @@ namespace vkBasalt
         pLogicalDevice->vkd.GetSwapchainImagesKHR(device, swapchain, &pLogicalSwapchain->imageCount, nullptr);
         pLogicalSwapchain->images.resize(pLogicalSwapchain->imageCount);
         pLogicalDevice->vkd.GetSwapchainImagesKHR(device, swapchain, &pLogicalSwapchain->imageCount, pLogicalSwapchain->images.data());
+        if (pLogicalSwapchain->storageUsage)
+            pLogicalDevice->storageImages.insert(pLogicalSwapchain->images.begin(), pLogicalSwapchain->images.end());
 
         // Create image views for overlay rendering
         pLogicalSwapchain->imageViews.resize(pLogicalSwapchain->imageCount);
@@ -944,6 +1309,10 @@ namespace vkBasalt
             pLogicalDevice->vkd.CreateImageView(pLogicalDevice->device, &viewInfo, nullptr, &pLogicalSwapchain->imageViews[i]);
         }
 
+        // Effects registered from now on are compiled for this swapchain, so ReshadeEffect can reuse the module
+        effectRegistry.setCompileTarget(pLogicalSwapchain->imageExtent.width, pLogicalSwapchain->imageExtent.height,
+                                        getColorDepth(pLogicalSwapchain->format));
+
         // Initialize registry from config on first run (before calculating effect slots)
         bool isFirstRun = !effectRegistry.isInitializedFromConfig();
         if (isFirstRun)
@@ -951,17 +1320,15 @@ namespace vkBasalt
 
         const auto& selectedEffects = effectRegistry.getSelectedEffects();
 
-        // Allow dynamic effect loading by allocating for more effects than configured
-        // maxEffects defaults to 10, allowing users to enable additional effects at runtime
-        int32_t maxEffects = settingsManager.getMaxEffects();
-        size_t effectSlots = std::max(selectedEffects.size(), (size_t)maxEffects);
-        pLogicalSwapchain->maxEffectSlots = effectSlots;
-
+        // The images the app renders into, the images between effects are allocated with the chain
         // create 1 more set of images when we can't use the swapchain it self
-        uint32_t fakeImageCount = pLogicalSwapchain->imageCount * (effectSlots + !pLogicalDevice->supportsMutableFormat);
+        uint32_t fakeImageCount = pLogicalSwapchain->imageCount * (1 + !pLogicalDevice->supportsMutableFormat);
 
-        pLogicalSwapchain->fakeImages =
-            createFakeSwapchainImages(pLogicalDevice, pLogicalSwapchain->swapchainCreateInfo, fakeImageCount, pLogicalSwapchain->fakeImageMemory);
+        pLogicalSwapchain->fakeImages = createFakeSwapchainImages(pLogicalDevice,
+                                                                  pLogicalSwapchain->swapchainCreateInfo,
+                                                                  fakeImageCount,
+                                                                  pLogicalSwapchain->fakeImageMemory,
+                                                                  pLogicalSwapchain->fakeImageMemorySize);
         Logger::debug("created fake swapchain images");
 
         if (!isFirstRun && !selectedEffects.empty())
@@ -981,6 +1348,7 @@ namespace vkBasalt
         {
             // First run OR empty effects - create effects from registry
             createEffectsForSwapchain(pLogicalSwapchain, pLogicalDevice, pConfig.get(), selectedEffects, true);
+            savePipelineCacheInBackground(pLogicalDevice);
         }
 
         DepthState depth = getDepthState(pLogicalDevice);
@@ -988,6 +1356,7 @@ namespace vkBasalt
         Logger::debug("selected effect count: " + std::to_string(selectedEffects.size()));
         Logger::debug("effect count: " + std::to_string(pLogicalSwapchain->effects.size()));
 
+        rebuildUniformRing(pLogicalDevice, pLogicalSwapchain);
         pLogicalSwapchain->commandBuffersEffect = allocateCommandBuffer(pLogicalDevice, pLogicalSwapchain->imageCount);
         Logger::debug("allocated ComandBuffers " + std::to_string(pLogicalSwapchain->commandBuffersEffect.size()) + " for swapchain "
                       + convertToString(swapchain));
@@ -997,7 +1366,6 @@ namespace vkBasalt
         Logger::debug("wrote CommandBuffers");
 
         pLogicalSwapchain->semaphores = createSemaphores(pLogicalDevice, pLogicalSwapchain->imageCount);
-        pLogicalSwapchain->overlaySemaphores = createSemaphores(pLogicalDevice, pLogicalSwapchain->imageCount);
         Logger::debug("created semaphores");
         for (unsigned int i = 0; i < pLogicalSwapchain->imageCount; i++)
         {
@@ -1053,6 +1421,22 @@ namespace vkBasalt
         return *pCount < pLogicalSwapchain->imageCount ? VK_INCOMPLETE : VK_SUCCESS;
     }
 
+    // Wait on a signaled binary semaphore whose waiter was never submitted, so it can be signaled again
+    void consumeSemaphore(LogicalDevice* pLogicalDevice, VkQueue queue, VkSemaphore semaphore)
+    {
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+        VkSubmitInfo submitInfo       = {};
+        submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores    = &semaphore;
+        submitInfo.pWaitDstStageMask  = &waitStage;
+
+        VkResult result = pLogicalDevice->vkd.QueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+        if (result != VK_SUCCESS)
+            Logger::err("could not consume semaphore after a failed submit: " + std::to_string(result));
+    }
+
     VKAPI_ATTR VkResult VKAPI_CALL vkBasalt_QueuePresentKHR(VkQueue queue, const VkPresentInfoKHR* pPresentInfo)
     {
         scoped_lock l(globalLock);
@@ -1069,7 +1453,7 @@ namespace vkBasalt
         static bool overlayPressed = false;
 
         // Check if settings were saved (re-read from settingsManager which is already updated by UI)
-        LogicalDevice* pDeviceForSettings = deviceMap[GetKey(queue)].get();
+        LogicalDevice* pDeviceForSettings = getLogicalDevice(queue);
         if (pDeviceForSettings && pDeviceForSettings->imguiOverlay && pDeviceForSettings->imguiOverlay->hasSettingsSaved())
         {
             // settingsManager is already updated by the UI, just re-read the values
@@ -1101,27 +1485,33 @@ namespace vkBasalt
 
         // Hot-reload: check for key press or config file change
         bool shouldReload = false;
+        bool fullReload   = false;  // Rebuild everything (shader or config files may have changed), not just what the overlay changed
         if (handleKeyPress(reloadKeySymbol, reloadPressed))
         {
             Logger::debug("reload key pressed");
             shouldReload = true;
+            fullReload   = true;
         }
         if (pConfig->hasConfigChanged())
         {
             Logger::debug("config file changed detected");
             shouldReload = true;
+            fullReload   = true;
         }
 
         // Toggle overlay on/off
         if (handleKeyPress(overlayKeySymbol, overlayPressed))
         {
-            LogicalDevice* pDevice = deviceMap[GetKey(queue)].get();
+            LogicalDevice* pDevice = getLogicalDevice(queue);
             if (pDevice->imguiOverlay)
                 pDevice->imguiOverlay->toggle();
         }
 
         // Check for Apply button press in overlay (overlay is at device level)
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(queue)].get();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(queue);
+
+        // Destroy what earlier reloads replaced once the frames using it are done
+        releaseRetiredResources(pLogicalDevice);
 
         // Toggle effects on/off via overlay checkbox
         if (pLogicalDevice->imguiOverlay && pLogicalDevice->imguiOverlay->hasToggleEffectsRequest())
@@ -1162,11 +1552,13 @@ namespace vkBasalt
                 cachedEffects.initialized = false;
                 cachedParams.dirty = true;
 
-                std::vector<std::string> activeEffects = pLogicalDevice->imguiOverlay
-                    ? pLogicalDevice->imguiOverlay->getActiveEffects()
-                    : pConfig->getOption<std::vector<std::string>>("effects", {});
+                if (fullReload)
+                {
+                    forgetReusableEffects();
+                    effectRegistry.clearCompiledEffects();
+                }
 
-                reloadAllSwapchains(pLogicalDevice, activeEffects);
+                requestReload(getActiveEffects(pLogicalDevice));
             }
         }
 
@@ -1180,19 +1572,66 @@ namespace vkBasalt
             resizeDebounce.pending = false;
 
             // Get selected effects from registry (single source of truth)
-            const auto& selectedEffects = effectRegistry.getSelectedEffects();
-            for (auto& [_, pSwapchain] : swapchainMap)
-            {
-                if (pSwapchain->fakeImages.empty())
-                    continue;
-                reloadEffectsForSwapchain(pSwapchain.get(), pConfig.get(), selectedEffects);
-            }
+            requestReload(effectRegistry.getSelectedEffects());
+        }
+
+        // Effects that finished compiling in the background replace their pass-through
+        if (effectRegistry.processCompiledEffects() && !pendingReload.pending)
+            requestReload(getActiveEffects(pLogicalDevice));
+
+        // Swap in the rebuilt chain once everything it needs is compiled, until then the current one keeps presenting
+        if (pendingReload.pending && prepareEffects(pendingReload.effects))
+        {
+            std::vector<std::string> effects = std::move(pendingReload.effects);
+            pendingReload.pending = false;
+            reloadAllSwapchains(pLogicalDevice, effects);
+        }
+
+        // Texture uploads and layout changes of newly created effects, ahead of the frames that sample them
+        flushUploads(pLogicalDevice);
+
+        // Effects and overlay of every swapchain go in a single submit, one batch per swapchain
+        std::vector<VkSubmitInfo>    submitInfos(pPresentInfo->swapchainCount);
+        std::vector<VkCommandBuffer> commandBuffers(pPresentInfo->swapchainCount * 2);  // Effect and overlay
+        std::vector<VkSemaphore>     presentSemaphores(pPresentInfo->swapchainCount);
+        VkCommandBuffer              overlayCommandBuffer = VK_NULL_HANDLE;
+
+        std::vector<VkSemaphore> waitSemaphores(pPresentInfo->pWaitSemaphores, pPresentInfo->pWaitSemaphores + pPresentInfo->waitSemaphoreCount);
+
+        // Submit order only holds on one queue, without semaphores from the app ours must be told when its work is done
+        bool handoffFromApp = pLogicalDevice->separateQueue && waitSemaphores.empty();
+        if (handoffFromApp)
+        {
+            if (pLogicalDevice->queueHandoffSemaphore == VK_NULL_HANDLE)
+                pLogicalDevice->queueHandoffSemaphore = createSemaphores(pLogicalDevice, 1)[0];
+
+            VkSubmitInfo handoffInfo         = {};
+            handoffInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            handoffInfo.signalSemaphoreCount = 1;
+            handoffInfo.pSignalSemaphores    = &pLogicalDevice->queueHandoffSemaphore;
+
+            VkResult vr = pLogicalDevice->vkd.QueueSubmit(queue, 1, &handoffInfo, VK_NULL_HANDLE);
+            if (vr != VK_SUCCESS)
+                return vr;
+            waitSemaphores.push_back(pLogicalDevice->queueHandoffSemaphore);
         }
 
-        std::vector<VkSemaphore> presentSemaphores;
-        presentSemaphores.reserve(pPresentInfo->swapchainCount);
+        // Every command of the batch reads or writes the app's image, whether the first effect is a draw, a dispatch or a copy
+        std::vector<VkPipelineStageFlags> waitStages(waitSemaphores.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+        bool overlayVisible = pLogicalDevice->imguiOverlay && pLogicalDevice->imguiOverlay->isVisible();
+        if (overlayVisible || overlayWasVisible)
+            effectRegistry.touchParameters();
+        overlayWasVisible = overlayVisible;
 
-        std::vector<VkPipelineStageFlags> waitStages(pPresentInfo->waitSemaphoreCount, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        FrameOverlayState frameOverlay;
+        frameOverlay.open = overlayVisible;
+        if (overlayVisible)
+        {
+            frameOverlay.activeParamEffect = pLogicalDevice->imguiOverlay->getActiveParamEffect();
+            frameOverlay.activeParamIndex  = pLogicalDevice->imguiOverlay->getActiveParamIndex();
+        }
+        updateFrameContext(frameContext, frameOverlay);
 
         for (unsigned int i = 0; i < pPresentInfo->swapchainCount; i++)
         {
@@ -1200,38 +1639,94 @@ namespace vkBasalt
             VkSwapchainKHR    swapchain         = pPresentInfo->pSwapchains[i];
             LogicalSwapchain* pLogicalSwapchain = swapchainMap[swapchain].get();
 
-            // Update all effects for this frame
+            // Update all effects for this frame, in the ring slice of this image once its previous frame is done with it
+            if (pLogicalSwapchain->uniformRing)
+                pLogicalSwapchain->uniformRing->waitForSlice(index);
             for (auto& effect : pLogicalSwapchain->effects)
-                effect->updateEffect();
-
-            // Submit effect command buffer
-            VkSubmitInfo submitInfo = {};
-            submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.waitSemaphoreCount = i == 0 ? pPresentInfo->waitSemaphoreCount : 0;
-            submitInfo.pWaitSemaphores    = i == 0 ? pPresentInfo->pWaitSemaphores : nullptr;
-            submitInfo.pWaitDstStageMask  = i == 0 ? waitStages.data() : nullptr;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers    = presentEffect
-                ? &pLogicalSwapchain->commandBuffersEffect[index]
-                : &pLogicalSwapchain->commandBuffersNoEffect[index];
+                effect->updateEffect(index, frameContext);
+
+            VkCommandBuffer* pCommandBuffers = &commandBuffers[i * 2];
+            uint32_t         bufferCount     = 0;
+            pCommandBuffers[bufferCount++]   = presentEffect
+                ? pLogicalSwapchain->commandBuffersEffect[index]
+                : pLogicalSwapchain->commandBuffersNoEffect[index];
+
+            // The overlay has one set of command buffers, it is drawn on the first swapchain of the present.
+            // Its render pass waits for everything before it, so it follows the effects without a semaphore
+            if (i == 0)
+            {
+                updateOverlayState(pLogicalDevice, presentEffect);
+                overlayCommandBuffer = recordOverlayFrame(pLogicalDevice, pLogicalSwapchain, index);
+                if (overlayCommandBuffer != VK_NULL_HANDLE)
+                    pCommandBuffers[bufferCount++] = overlayCommandBuffer;
+            }
+
+            VkSubmitInfo& submitInfo        = submitInfos[i];
+            submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.waitSemaphoreCount   = i == 0 ? waitSemaphores.size() : 0;
+            submitInfo.pWaitSemaphores      = i == 0 ? waitSemaphores.data() : nullptr;
+            submitInfo.pWaitDstStageMask    = i == 0 ? waitStages.data() : nullptr;
+            submitInfo.commandBufferCount   = bufferCount;
+            submitInfo.pCommandBuffers      = pCommandBuffers;
             submitInfo.signalSemaphoreCount = 1;
             submitInfo.pSignalSemaphores    = &pLogicalSwapchain->semaphores[index];
 
-            VkResult vr = pLogicalDevice->vkd.QueueSubmit(pLogicalDevice->queue, 1, &submitInfo, VK_NULL_HANDLE);
-            if (vr != VK_SUCCESS)
-                return vr;
+            presentSemaphores[i] = pLogicalSwapchain->semaphores[index];
+        }
 
-            // Update and render overlay
-            updateOverlayState(pLogicalDevice, presentEffect);
+        // On our own queue the effects read the app's depth and fake images behind its back. The app's queue waits for
+        // them before anything submitted after this present, so its next frame's writes and its fences come after our work
+        // (same family, so the images need no ownership transfer between the two queues)
+        bool                     returnToApp = pLogicalDevice->separateQueue;
+        std::vector<VkSemaphore> lastSignalSemaphores;
+        if (returnToApp)
+        {
+            if (pLogicalDevice->queueReturnSemaphore == VK_NULL_HANDLE)
+                pLogicalDevice->queueReturnSemaphore = createSemaphores(pLogicalDevice, 1)[0];
 
-            VkSemaphore finalSemaphore;
-            vr = submitOverlayFrame(pLogicalDevice, pLogicalSwapchain, index, finalSemaphore);
+            VkSubmitInfo& lastSubmitInfo        = submitInfos.back();
+            lastSignalSemaphores                = {*lastSubmitInfo.pSignalSemaphores, pLogicalDevice->queueReturnSemaphore};
+            lastSubmitInfo.signalSemaphoreCount = lastSignalSemaphores.size();
+            lastSubmitInfo.pSignalSemaphores    = lastSignalSemaphores.data();
+        }
+
+        VkResult vr = pLogicalDevice->vkd.QueueSubmit(pLogicalDevice->queue, submitInfos.size(), submitInfos.data(), getSubmitFence(pLogicalDevice));
+        if (vr != VK_SUCCESS)
+        {
+            // The handoff was signaled for this submit, nothing else waits on it
+            if (handoffFromApp)
+                consumeSemaphore(pLogicalDevice, pLogicalDevice->queue, pLogicalDevice->queueHandoffSemaphore);
+            return vr;
+        }
+
+        if (returnToApp)
+        {
+            VkPipelineStageFlags returnStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+            VkSubmitInfo returnInfo       = {};
+            returnInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            returnInfo.waitSemaphoreCount = 1;
+            returnInfo.pWaitSemaphores    = &pLogicalDevice->queueReturnSemaphore;
+            returnInfo.pWaitDstStageMask  = &returnStage;
+
+            vr = pLogicalDevice->vkd.QueueSubmit(queue, 1, &returnInfo, VK_NULL_HANDLE);
             if (vr != VK_SUCCESS)
+            {
+                consumeSemaphore(pLogicalDevice, pLogicalDevice->queue, pLogicalDevice->queueReturnSemaphore);
                 return vr;
+            }
+        }
 
-            presentSemaphores.push_back(finalSemaphore);
+        for (unsigned int i = 0; i < pPresentInfo->swapchainCount; i++)
+        {
+            LogicalSwapchain* pLogicalSwapchain = swapchainMap[pPresentInfo->pSwapchains[i]].get();
+            if (pLogicalSwapchain->uniformRing)
+                pLogicalSwapchain->uniformRing->sliceSubmits[pPresentInfo->pImageIndices[i]] = pLogicalDevice->frameSync.submitSerial;
         }
 
+        if (overlayCommandBuffer != VK_NULL_HANDLE)
+            pLogicalDevice->imguiOverlay->setFrameSubmitted(pPresentInfo->pImageIndices[0], pLogicalDevice->frameSync.submitSerial);
+
         VkPresentInfoKHR presentInfo   = *pPresentInfo;
         presentInfo.waitSemaphoreCount = presentSemaphores.size();
         presentInfo.pWaitSemaphores    = presentSemaphores.data();
@@ -1248,21 +1743,47 @@ namespace vkBasalt
         // we need to delete the infos of the oldswapchain
 
         Logger::trace("vkDestroySwapchainKHR " + convertToString(swapchain));
-        swapchainMap[swapchain]->destroy();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(device);
+
+        // Our own submits for this swapchain may still be running, destroy the layer side once they are done.
+        // The swapchain images are the app's and go right away, the app's fences don't cover our last submit
+        // (it comes after the app's, and may be on our own queue), so wait for it.
+        std::shared_ptr<LogicalSwapchain> pLogicalSwapchain = swapchainMap[swapchain];
+        waitForSubmit(pLogicalDevice, pLogicalDevice->frameSync.submitSerial);
         swapchainMap.erase(swapchain);
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(device)].get();
+        untrackStorageImages(pLogicalDevice, pLogicalSwapchain->images);
+        untrackStorageImages(pLogicalDevice, pLogicalSwapchain->fakeImages);
+        for (const auto& set : pLogicalSwapchain->pingPongSets)
+            untrackStorageImages(pLogicalDevice, set.images);
+        retireResources(pLogicalDevice, [pLogicalSwapchain]() { pLogicalSwapchain->destroy(); });
 
         pLogicalDevice->vkd.DestroySwapchainKHR(device, swapchain, pAllocator);
     }
 
+    // Rewrite the effect command buffers of a device's swapchains after the depth image changed (needs globalLock)
+    void updateDepthForSwapchains(LogicalDevice* pLogicalDevice)
+    {
+        DepthState depth = getDepthState(pLogicalDevice);
+        for (auto& [swapchainHandle, pLogicalSwapchain] : swapchainMap)
+        {
+            if (pLogicalSwapchain->pLogicalDevice != pLogicalDevice)
+                continue;
+            if (pLogicalSwapchain->commandBuffersEffect.empty())
+                continue;
+
+            reallocateCommandBuffers(pLogicalDevice, pLogicalSwapchain.get(), depth);
+            Logger::debug("reallocated CommandBuffers for swapchain " + convertToString(swapchainHandle));
+        }
+    }
+
+    // The image functions are called from the game's streaming threads, they only take globalLock
+    // when the depth image the effects sample changes
     VKAPI_ATTR VkResult VKAPI_CALL vkBasalt_CreateImage(VkDevice                     device,
                                                         const VkImageCreateInfo*     pCreateInfo,
                                                         const VkAllocationCallbacks* pAllocator,
                                                         VkImage*                     pImage)
     {
-        scoped_lock l(globalLock);
-
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(device)].get();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(device);
         if (isDepthFormat(pCreateInfo->format) && pCreateInfo->samples == VK_SAMPLE_COUNT_1_BIT
             && ((pCreateInfo->usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) == VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
         {
@@ -1274,6 +1795,8 @@ namespace vkBasalt
             VkImageCreateInfo modifiedCreateInfo = *pCreateInfo;
             modifiedCreateInfo.usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
             VkResult result = pLogicalDevice->vkd.CreateImage(device, &modifiedCreateInfo, pAllocator, pImage);
+
+            std::lock_guard<std::mutex> l(pLogicalDevice->depthLock);
             pLogicalDevice->depthImages.push_back(*pImage);
             pLogicalDevice->depthFormats.push_back(pCreateInfo->format);
 
@@ -1287,40 +1810,33 @@ namespace vkBasalt
 
     VKAPI_ATTR VkResult VKAPI_CALL vkBasalt_BindImageMemory(VkDevice device, VkImage image, VkDeviceMemory memory, VkDeviceSize memoryOffset)
     {
-        scoped_lock l(globalLock);
-
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(device)].get();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(device);
         VkResult result = pLogicalDevice->vkd.BindImageMemory(device, image, memory, memoryOffset);
 
-        // TODO what if the application creates more than one image before binding memory?
-        if (pLogicalDevice->depthImages.empty() || image != pLogicalDevice->depthImages.back())
-            return result;
+        {
+            std::lock_guard<std::mutex> l(pLogicalDevice->depthLock);
 
-        // Create depth image view for the newly bound depth image
-        Logger::debug("before creating depth image view");
-        VkFormat depthFormat = pLogicalDevice->depthFormats[pLogicalDevice->depthImages.size() - 1];
-        VkImageView depthImageView = createImageViews(pLogicalDevice, depthFormat, {image},
-                                                      VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_DEPTH_BIT)[0];
-        Logger::debug("created depth image view");
-        pLogicalDevice->depthImageViews.push_back(depthImageView);
+            // TODO what if the application creates more than one image before binding memory?
+            if (pLogicalDevice->depthImages.empty() || image != pLogicalDevice->depthImages.back())
+                return result;
 
-        // Only update command buffers for the first depth image
-        if (pLogicalDevice->depthImageViews.size() > 1)
-            return result;
+            // Create depth image view for the newly bound depth image
+            Logger::debug("before creating depth image view");
+            VkFormat depthFormat = pLogicalDevice->depthFormats[pLogicalDevice->depthImages.size() - 1];
+            VkImageView depthImageView = createImageViews(pLogicalDevice, depthFormat, {image},
+                                                          VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_DEPTH_BIT)[0];
+            Logger::debug("created depth image view");
+            pLogicalDevice->depthImageViews.push_back(depthImageView);
 
-        // Update all swapchains for this device with the new depth state
-        DepthState depth = getDepthState(pLogicalDevice);
-        for (auto& [swapchainHandle, pLogicalSwapchain] : swapchainMap)
-        {
-            if (pLogicalSwapchain->pLogicalDevice != pLogicalDevice)
-                continue;
-            if (pLogicalSwapchain->commandBuffersEffect.empty())
-                continue;
-
-            reallocateCommandBuffers(pLogicalDevice, pLogicalSwapchain.get(), depth);
-            Logger::debug("reallocated CommandBuffers for swapchain " + convertToString(swapchainHandle));
+            // Only update command buffers for the first depth image
+            if (pLogicalDevice->depthImageViews.size() > 1)
+                return result;
         }
 
+        // Update all swapchains for this device with the new depth state
+        scoped_lock l(globalLock);
+        updateDepthForSwapchains(pLogicalDevice);
+
         return result;
     }
 
@@ -1329,41 +1845,50 @@ namespace vkBasalt
         if (!image)
             return;
 
-        scoped_lock l(globalLock);
-
-        LogicalDevice* pLogicalDevice = deviceMap[GetKey(device)].get();
+        LogicalDevice* pLogicalDevice = getLogicalDevice(device);
 
         // Check if this is a tracked depth image
-        auto it = std::find(pLogicalDevice->depthImages.begin(), pLogicalDevice->depthImages.end(), image);
-        if (it != pLogicalDevice->depthImages.end())
+        bool        wasDepthImage  = false;
+        VkImageView depthImageView = VK_NULL_HANDLE;
         {
-            size_t i = std::distance(pLogicalDevice->depthImages.begin(), it);
-
-            // Remove from tracking lists
-            pLogicalDevice->depthImages.erase(it);
-            // TODO what if an image gets destroyed before binding memory?
-            if (i < pLogicalDevice->depthImageViews.size())
-            {
-                pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, pLogicalDevice->depthImageViews[i], nullptr);
-                pLogicalDevice->depthImageViews.erase(pLogicalDevice->depthImageViews.begin() + i);
-            }
-            if (i < pLogicalDevice->depthFormats.size())
-                pLogicalDevice->depthFormats.erase(pLogicalDevice->depthFormats.begin() + i);
-
-            // Update all swapchains with new depth state
-            DepthState depth = getDepthState(pLogicalDevice);
-            for (auto& [swapchainHandle, pLogicalSwapchain] : swapchainMap)
+            std::lock_guard<std::mutex> l(pLogicalDevice->depthLock);
+            auto it = std::find(pLogicalDevice->depthImages.begin(), pLogicalDevice->depthImages.end(), image);
+            if (it != pLogicalDevice->depthImages.end())
             {
-                if (pLogicalSwapchain->pLogicalDevice != pLogicalDevice)
-                    continue;
-                if (pLogicalSwapchain->commandBuffersEffect.empty())
-                    continue;
+                size_t i      = std::distance(pLogicalDevice->depthImages.begin(), it);
+                wasDepthImage = true;
 
-                reallocateCommandBuffers(pLogicalDevice, pLogicalSwapchain.get(), depth);
-                Logger::debug("reallocated CommandBuffers for swapchain " + convertToString(swapchainHandle));
+                // Remove from tracking lists
+                pLogicalDevice->depthImages.erase(it);
+                // TODO what if an image gets destroyed before binding memory?
+                if (i < pLogicalDevice->depthImageViews.size())
+                {
+                    depthImageView = pLogicalDevice->depthImageViews[i];
+                    pLogicalDevice->depthImageViews.erase(pLogicalDevice->depthImageViews.begin() + i);
+                }
+                if (i < pLogicalDevice->depthFormats.size())
+                    pLogicalDevice->depthFormats.erase(pLogicalDevice->depthFormats.begin() + i);
             }
         }
 
+        if (wasDepthImage)
+        {
+            // Update all swapchains with new depth state. Our last submit may still sample the image and comes after
+            // anything the app waited for, so the view and the image itself go once our frames using them are done
+            // (instead of stalling the app's thread on the GPU)
+            scoped_lock l(globalLock);
+            updateDepthForSwapchains(pLogicalDevice);
+
+            bool                  hasAllocator = pAllocator != nullptr;
+            VkAllocationCallbacks allocator    = hasAllocator ? *pAllocator : VkAllocationCallbacks{};
+            retireResources(pLogicalDevice, [pLogicalDevice, depthImageView, image, hasAllocator, allocator]() {
+                if (depthImageView != VK_NULL_HANDLE)
+                    pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, depthImageView, nullptr);
+                pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, image, hasAllocator ? &allocator : nullptr);
+            });
+            return;
+        }
+
         pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, image, pAllocator);
     }
 
@@ -1423,8 +1948,7 @@ namespace vkBasalt
                 return VK_SUCCESS;
             }
 
-            scoped_lock l(globalLock);
-            return instanceDispatchMap[GetKey(physicalDevice)].EnumerateDeviceExtensionProperties(
+            return getInstanceDispatch(physicalDevice).EnumerateDeviceExtensionProperties(
                 physicalDevice, pLayerName, pPropertyCount, pProperties);
         }
 
@@ -1443,65 +1967,140 @@ extern "C"
     VK_BASALT_EXPORT PFN_vkVoidFunction VKAPI_CALL vkBasalt_GetDeviceProcAddr(VkDevice device, const char* pName);
     VK_BASALT_EXPORT PFN_vkVoidFunction VKAPI_CALL vkBasalt_GetInstanceProcAddr(VkInstance instance, const char* pName);
 
-#define GETPROCADDR(func) \
-    if (!std::strcmp(pName, "vk" #func)) \
-        return (PFN_vkVoidFunction) &vkBasalt::vkBasalt_##func;
-    /*
-    Return our funktions for the funktions we want to intercept
-    the macro takes the name and returns our vkBasalt_##func, if the name is equal
-    */
+} // extern "C"
+
+namespace
+{
+    // Functions our GetProcAddr returns instead of the next layer's.
+    // Games resolve thousands of entry points at startup, so lookups go through a perfect hash built at compile time:
+    // one hash, one table load and one string compare instead of a strcmp per intercepted function.
+    struct InterceptedName
+    {
+        std::string_view name;
+        bool             depthCapture;  // Only intercepted with depth capture on
+    };
 
     // vkGetDeviceProcAddr needs to behave like vkGetInstanceProcAddr thanks to some games
-#define INTERCEPT_CALLS \
-    /* instance chain functions we intercept */ \
-    if (!std::strcmp(pName, "vkGetInstanceProcAddr")) \
-        return (PFN_vkVoidFunction) &vkBasalt_GetInstanceProcAddr; \
-    GETPROCADDR(EnumerateInstanceLayerProperties); \
-    GETPROCADDR(EnumerateInstanceExtensionProperties); \
-    GETPROCADDR(CreateInstance); \
-    GETPROCADDR(DestroyInstance); \
-\
-    /* device chain functions we intercept*/ \
-    if (!std::strcmp(pName, "vkGetDeviceProcAddr")) \
-        return (PFN_vkVoidFunction) &vkBasalt_GetDeviceProcAddr; \
-    GETPROCADDR(EnumerateDeviceLayerProperties); \
-    GETPROCADDR(EnumerateDeviceExtensionProperties); \
-    GETPROCADDR(CreateDevice); \
-    GETPROCADDR(DestroyDevice); \
-    GETPROCADDR(CreateSwapchainKHR); \
-    GETPROCADDR(GetSwapchainImagesKHR); \
-    GETPROCADDR(QueuePresentKHR); \
-    GETPROCADDR(DestroySwapchainKHR); \
-\
-    if (vkBasalt::settingsManager.getDepthCapture()) \
-    { \
-        GETPROCADDR(CreateImage); \
-        GETPROCADDR(DestroyImage); \
-        GETPROCADDR(BindImageMemory); \
+    constexpr InterceptedName interceptedNames[] = {
+        // instance chain functions we intercept
+        {"vkGetInstanceProcAddr", false},
+        {"vkEnumerateInstanceLayerProperties", false},
+        {"vkEnumerateInstanceExtensionProperties", false},
+        {"vkCreateInstance", false},
+        {"vkDestroyInstance", false},
+        // device chain functions we intercept
+        {"vkGetDeviceProcAddr", false},
+        {"vkEnumerateDeviceLayerProperties", false},
+        {"vkEnumerateDeviceExtensionProperties", false},
+        {"vkCreateDevice", false},
+        {"vkDestroyDevice", false},
+        {"vkCreateSwapchainKHR", false},
+        {"vkGetSwapchainImagesKHR", false},
+        {"vkQueuePresentKHR", false},
+        {"vkDestroySwapchainKHR", false},
+        {"vkCreateImage", true},
+        {"vkDestroyImage", true},
+        {"vkBindImageMemory", true},
+    };
+
+    // Same order as interceptedNames (function pointer casts can't be constexpr)
+    const PFN_vkVoidFunction interceptedFunctions[] = {
+        (PFN_vkVoidFunction) &vkBasalt_GetInstanceProcAddr,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_EnumerateInstanceLayerProperties,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_EnumerateInstanceExtensionProperties,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_CreateInstance,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_DestroyInstance,
+        (PFN_vkVoidFunction) &vkBasalt_GetDeviceProcAddr,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_EnumerateDeviceLayerProperties,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_EnumerateDeviceExtensionProperties,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_CreateDevice,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_DestroyDevice,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_CreateSwapchainKHR,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_GetSwapchainImagesKHR,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_QueuePresentKHR,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_DestroySwapchainKHR,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_CreateImage,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_DestroyImage,
+        (PFN_vkVoidFunction) &vkBasalt::vkBasalt_BindImageMemory,
+    };
+    static_assert(std::size(interceptedNames) == std::size(interceptedFunctions), "intercepted names and functions out of sync");
+
+    constexpr uint32_t procTableSize = 64;  // Power of two, a few times the name count so a seed is found quickly
+    constexpr uint8_t  noProc        = 0xFF;
+    static_assert(std::size(interceptedNames) < procTableSize, "proc table too small");
+
+    // FNV-1a with a seed mixed into the offset basis
+    constexpr uint32_t hashProcName(std::string_view name, uint32_t seed)
+    {
+        uint32_t hash = 2166136261u ^ seed;
+        for (char c : name)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    struct ProcTable
+    {
+        uint32_t seed = 0;
+        uint8_t  slots[procTableSize] = {};  // Index into interceptedNames, noProc if empty
+    };
+
+    // First seed that maps every intercepted name to its own slot
+    constexpr ProcTable makeProcTable()
+    {
+        for (ProcTable table;; table.seed++)
+        {
+            for (auto& slot : table.slots)
+                slot = noProc;
+
+            bool collision = false;
+            for (uint8_t i = 0; i < std::size(interceptedNames) && !collision; i++)
+            {
+                uint8_t& slot = table.slots[hashProcName(interceptedNames[i].name, table.seed) & (procTableSize - 1)];
+                collision     = slot != noProc;
+                slot          = i;
+            }
+            if (!collision)
+                return table;
+        }
+    }
+
+    constexpr ProcTable procTable = makeProcTable();
+
+    PFN_vkVoidFunction getInterceptedProc(const char* pName)
+    {
+        std::string_view name(pName);
+        uint8_t          index = procTable.slots[hashProcName(name, procTable.seed) & (procTableSize - 1)];
+        if (index == noProc || interceptedNames[index].name != name)
+            return nullptr;
+        if (interceptedNames[index].depthCapture && !vkBasalt::settingsManager.getDepthCapture())
+            return nullptr;
+        return interceptedFunctions[index];
     }
+} // namespace
 
+extern "C"
+{
     VK_BASALT_EXPORT PFN_vkVoidFunction VKAPI_CALL vkBasalt_GetDeviceProcAddr(VkDevice device, const char* pName)
     {
         vkBasalt::initConfigs();
 
-        INTERCEPT_CALLS
+        if (PFN_vkVoidFunction function = getInterceptedProc(pName))
+            return function;
 
-        {
-            vkBasalt::scoped_lock l(vkBasalt::globalLock);
-            return vkBasalt::deviceMap[vkBasalt::GetKey(device)]->vkd.GetDeviceProcAddr(device, pName);
-        }
+        return vkBasalt::getLogicalDevice(device)->vkd.GetDeviceProcAddr(device, pName);
     }
 
     VK_BASALT_EXPORT PFN_vkVoidFunction VKAPI_CALL vkBasalt_GetInstanceProcAddr(VkInstance instance, const char* pName)
     {
         vkBasalt::initConfigs();
 
-        INTERCEPT_CALLS
+        if (PFN_vkVoidFunction function = getInterceptedProc(pName))
+            return function;
 
-        {
-            vkBasalt::scoped_lock l(vkBasalt::globalLock);
-            return vkBasalt::instanceDispatchMap[vkBasalt::GetKey(instance)].GetInstanceProcAddr(instance, pName);
-        }
+        return vkBasalt::getInstanceDispatch(instance).GetInstanceProcAddr(instance, pName);
     }
 
 } // extern "C"
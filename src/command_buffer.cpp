@@ -1,6 +1,7 @@
 #include "command_buffer.hpp"
 
 #include "format.hpp"
+#include "render_graph.hpp"
 #include "util.hpp"
 
 namespace vkBasalt
@@ -82,11 +83,7 @@ namespace vkBasalt
                                                        &memoryBarrier);
             }
 
-            for (uint32_t j = 0; j < effects.size(); j++)
-            {
-                Logger::debug("before applying effect " + convertToString(effects[j]));
-                effects[j]->applyEffect(i, commandBuffers[i]);
-            }
+            recordEffectChain(pLogicalDevice, effects, i, commandBuffers[i]);
 
             memoryBarrier.oldLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             memoryBarrier.newLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
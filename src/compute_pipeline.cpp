@@ -0,0 +1,36 @@
+#include "compute_pipeline.hpp"
+
+namespace vkBasalt
+{
+    VkPipeline createComputePipeline(LogicalDevice*        pLogicalDevice,
+                                     VkShaderModule        computeModule,
+                                     VkSpecializationInfo* specializationInfo,
+                                     std::string           entryPoint,
+                                     VkPipelineLayout      pipelineLayout)
+    {
+        VkPipelineShaderStageCreateInfo shaderStageCreateInfo;
+        shaderStageCreateInfo.sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        shaderStageCreateInfo.pNext               = nullptr;
+        shaderStageCreateInfo.flags               = 0;
+        shaderStageCreateInfo.stage               = VK_SHADER_STAGE_COMPUTE_BIT;
+        shaderStageCreateInfo.module              = computeModule;
+        shaderStageCreateInfo.pName               = entryPoint.c_str();
+        shaderStageCreateInfo.pSpecializationInfo = specializationInfo;
+
+        VkComputePipelineCreateInfo pipelineCreateInfo;
+        pipelineCreateInfo.sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.pNext              = nullptr;
+        pipelineCreateInfo.flags              = 0;
+        pipelineCreateInfo.stage              = shaderStageCreateInfo;
+        pipelineCreateInfo.layout             = pipelineLayout;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex  = -1;
+
+        VkPipeline pipeline;
+        VkResult   result =
+            pLogicalDevice->vkd.CreateComputePipelines(pLogicalDevice->device, pLogicalDevice->pipelineCache, 1, &pipelineCreateInfo, nullptr, &pipeline);
+        ASSERT_VULKAN(result);
+
+        return pipeline;
+    }
+} // namespace vkBasalt
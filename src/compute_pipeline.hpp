@@ -0,0 +1,20 @@
+#ifndef COMPUTE_PIPELINE_HPP_INCLUDED
+#define COMPUTE_PIPELINE_HPP_INCLUDED
+#include <vector>
+#include <string>
+
+#include "vulkan_include.hpp"
+
+#include "logical_device.hpp"
+
+namespace vkBasalt
+{
+    // Layouts are shared with graphics pipelines, see createGraphicsPipelineLayout
+    VkPipeline createComputePipeline(LogicalDevice*        pLogicalDevice,
+                                     VkShaderModule        computeModule,
+                                     VkSpecializationInfo* specializationInfo,
+                                     std::string           entryPoint,
+                                     VkPipelineLayout      pipelineLayout);
+} // namespace vkBasalt
+
+#endif // COMPUTE_PIPELINE_HPP_INCLUDED
@@ -251,9 +251,7 @@ namespace vkBasalt
             trimWs(key);
             trimWs(value);
 
-            if (key == "maxEffects")
-                settings.maxEffects = std::stoi(value);
-            else if (key == "overlayBlockInput")
+            if (key == "overlayBlockInput")
                 settings.overlayBlockInput = (value == "true" || value == "1");
             else if (key == "toggleKey")
                 settings.toggleKey = value;
@@ -265,12 +263,16 @@ namespace vkBasalt
                 settings.enableOnLaunch = (value == "true" || value == "1");
             else if (key == "depthCapture")
                 settings.depthCapture = (value == "on");
+            else if (key == "effectQueue")
+                settings.effectQueue = (value == "true" || value == "1");
             else if (key == "autoApply")
                 settings.autoApply = (value == "true" || value == "1");
             else if (key == "autoApplyDelay")
                 settings.autoApplyDelay = std::stoi(value);
             else if (key == "showDebugWindow")
                 settings.showDebugWindow = (value == "true" || value == "1");
+            else if (key == "liveParams")
+                settings.liveParams = (value == "true" || value == "1");
         }
 
         return settings;
@@ -300,9 +302,9 @@ namespace vkBasalt
 
         file << "# Overlay settings\n";
         file << "overlayBlockInput = " << (settings.overlayBlockInput ? "true" : "false") << "\n";
-        file << "maxEffects = " << settings.maxEffects << "\n";
         file << "autoApply = " << (settings.autoApply ? "true" : "false") << "\n";
         file << "autoApplyDelay = " << settings.autoApplyDelay << "\n";
+        file << "liveParams = " << (settings.liveParams ? "true" : "false") << "\n";
 
         file << "\n# Key bindings\n";
         file << "toggleKey = " << settings.toggleKey << "\n";
@@ -312,6 +314,7 @@ namespace vkBasalt
         file << "\n# Startup behavior\n";
         file << "enableOnLaunch = " << (settings.enableOnLaunch ? "true" : "false") << "\n";
         file << "depthCapture = " << (settings.depthCapture ? "on" : "off") << "\n";
+        file << "effectQueue = " << (settings.effectQueue ? "true" : "false") << "\n";
 
         file << "\n# Debug\n";
         file << "showDebugWindow = " << (settings.showDebugWindow ? "true" : "false") << "\n";
@@ -20,16 +20,17 @@ namespace vkBasalt
     // Global vkBasalt settings (from vkBasalt.conf)
     struct VkBasaltSettings
     {
-        int maxEffects = 10;
         bool overlayBlockInput = false;
         std::string toggleKey = "Home";
         std::string reloadKey = "F10";
         std::string overlayKey = "End";
         bool enableOnLaunch = true;
         bool depthCapture = false;
+        bool effectQueue = false;  // Run effects on a separate graphics queue when the GPU has one
         bool autoApply = true;  // Auto-apply changes without clicking Apply
         int autoApplyDelay = 200;  // ms delay before auto-applying changes
         bool showDebugWindow = false;  // Show debug window with raw effect registry data
+        bool liveParams = true;  // ReShade params live in the uniform buffer instead of spec constants (no recompile on edit)
     };
 
     // Shader Manager configuration (from shader_manager.conf)
@@ -32,7 +32,7 @@ namespace vkBasalt
 
         VkDescriptorSetLayoutBinding descriptorSetLayoutBinding;
         descriptorSetLayoutBinding.binding            = 0;
-        descriptorSetLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptorSetLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         descriptorSetLayoutBinding.descriptorCount    = 1;
         descriptorSetLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT;
         descriptorSetLayoutBinding.pImmutableSamplers = nullptr;
@@ -54,7 +54,8 @@ namespace vkBasalt
     VkDescriptorSet writeBufferDescriptorSet(LogicalDevice*        pLogicalDevice,
                                              VkDescriptorPool      descriptorPool,
                                              VkDescriptorSetLayout descriptorSetLayout,
-                                             VkBuffer              buffer)
+                                             VkBuffer              buffer,
+                                             VkDeviceSize          range)
     {
         VkDescriptorSet descriptorSet;
 
@@ -71,7 +72,7 @@ namespace vkBasalt
         VkDescriptorBufferInfo bufferInfo;
         bufferInfo.buffer = buffer;
         bufferInfo.offset = 0;
-        bufferInfo.range  = VK_WHOLE_SIZE;
+        bufferInfo.range  = range;
 
         VkWriteDescriptorSet writeDescriptorSet = {};
 
@@ -81,7 +82,7 @@ namespace vkBasalt
         writeDescriptorSet.dstBinding       = 0;
         writeDescriptorSet.dstArrayElement  = 0;
         writeDescriptorSet.descriptorCount  = 1;
-        writeDescriptorSet.descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writeDescriptorSet.descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         writeDescriptorSet.pImageInfo       = nullptr;
         writeDescriptorSet.pBufferInfo      = &bufferInfo;
         writeDescriptorSet.pTexelBufferView = nullptr;
@@ -103,7 +104,7 @@ namespace vkBasalt
             descriptorSetLayoutBinding.binding            = i;
             descriptorSetLayoutBinding.descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
             descriptorSetLayoutBinding.descriptorCount    = 1;
-            descriptorSetLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+            descriptorSetLayoutBinding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
             descriptorSetLayoutBinding.pImmutableSamplers = nullptr;
             bindigs[i]                                    = descriptorSetLayoutBinding;
         }
@@ -183,4 +184,78 @@ namespace vkBasalt
         }
         return descriptorSets;
     }
+
+    VkDescriptorSetLayout createComputeImageDescriptorSetLayout(LogicalDevice* pLogicalDevice)
+    {
+        VkDescriptorSetLayout descriptorSetLayout;
+
+        VkDescriptorSetLayoutBinding bindings[2];
+        bindings[0].binding            = 0;
+        bindings[0].descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount    = 1;
+        bindings[0].stageFlags         = VK_SHADER_STAGE_COMPUTE_BIT;
+        bindings[0].pImmutableSamplers = nullptr;
+        bindings[1]                    = bindings[0];
+        bindings[1].binding            = 1;
+        bindings[1].descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+        VkDescriptorSetLayoutCreateInfo descriptorSetCreateInfo;
+        descriptorSetCreateInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptorSetCreateInfo.pNext        = nullptr;
+        descriptorSetCreateInfo.flags        = 0;
+        descriptorSetCreateInfo.bindingCount = 2;
+        descriptorSetCreateInfo.pBindings    = bindings;
+
+        VkResult result =
+            pLogicalDevice->vkd.CreateDescriptorSetLayout(pLogicalDevice->device, &descriptorSetCreateInfo, nullptr, &descriptorSetLayout);
+        ASSERT_VULKAN(result)
+        return descriptorSetLayout;
+    }
+
+    std::vector<VkDescriptorSet> allocateAndWriteComputeImageDescriptorSets(LogicalDevice*                  pLogicalDevice,
+                                                                            VkDescriptorPool                descriptorPool,
+                                                                            VkDescriptorSetLayout           descriptorSetLayout,
+                                                                            VkSampler                       sampler,
+                                                                            const std::vector<VkImageView>& inputImageViews,
+                                                                            const std::vector<VkImageView>& storageImageViews)
+    {
+        std::vector<VkDescriptorSet> descriptorSets(inputImageViews.size());
+
+        std::vector<VkDescriptorSetLayout> layouts(descriptorSets.size(), descriptorSetLayout);
+        VkDescriptorSetAllocateInfo        descriptorSetAllocateInfo;
+        descriptorSetAllocateInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptorSetAllocateInfo.pNext              = nullptr;
+        descriptorSetAllocateInfo.descriptorPool     = descriptorPool;
+        descriptorSetAllocateInfo.descriptorSetCount = descriptorSets.size();
+        descriptorSetAllocateInfo.pSetLayouts        = layouts.data();
+
+        VkResult result = pLogicalDevice->vkd.AllocateDescriptorSets(pLogicalDevice->device, &descriptorSetAllocateInfo, descriptorSets.data());
+        ASSERT_VULKAN(result);
+
+        VkDescriptorImageInfo imageInfos[2];
+        imageInfos[0].sampler     = sampler;
+        imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos[1].sampler     = VK_NULL_HANDLE;
+        imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        VkWriteDescriptorSet writeDescriptorSets[2] = {};
+        for (uint32_t j = 0; j < 2; j++)
+        {
+            writeDescriptorSets[j].sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptorSets[j].dstBinding      = j;
+            writeDescriptorSets[j].descriptorCount = 1;
+            writeDescriptorSets[j].descriptorType  = j == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writeDescriptorSets[j].pImageInfo      = &imageInfos[j];
+        }
+
+        for (uint32_t i = 0; i < descriptorSets.size(); i++)
+        {
+            imageInfos[0].imageView        = inputImageViews[i];
+            imageInfos[1].imageView        = storageImageViews[i];
+            writeDescriptorSets[0].dstSet  = descriptorSets[i];
+            writeDescriptorSets[1].dstSet  = descriptorSets[i];
+            pLogicalDevice->vkd.UpdateDescriptorSets(pLogicalDevice->device, 2, writeDescriptorSets, 0, nullptr);
+        }
+        return descriptorSets;
+    }
 } // namespace vkBasalt
@@ -15,12 +15,14 @@ namespace vkBasalt
 {
     VkDescriptorPool createDescriptorPool(LogicalDevice* pLogicalDevice, const std::vector<VkDescriptorPoolSize>& poolSizes);
 
+    // Dynamic uniform buffer, the offset is given when binding (see UniformRing)
     VkDescriptorSetLayout createUniformBufferDescriptorSetLayout(LogicalDevice* pLogicalDevice);
 
     VkDescriptorSet writeBufferDescriptorSet(LogicalDevice*        pLogicalDevice,
                                              VkDescriptorPool      descriptorPool,
                                              VkDescriptorSetLayout descriptorSetLayout,
-                                             VkBuffer              buffer);
+                                             VkBuffer              buffer,
+                                             VkDeviceSize          range);
 
     VkDescriptorSetLayout createImageSamplerDescriptorSetLayout(LogicalDevice* pLogicalDevice, uint32_t count);
 
@@ -29,6 +31,16 @@ namespace vkBasalt
                                                                             VkDescriptorSetLayout                 descriptorSetLayout,
                                                                             std::vector<VkSampler>                samplers,
                                                                             std::vector<std::vector<VkImageView>> imageViewsVectors);
+
+    // Sampled input (binding 0) and storage output (binding 1) of a compute effect
+    VkDescriptorSetLayout createComputeImageDescriptorSetLayout(LogicalDevice* pLogicalDevice);
+
+    std::vector<VkDescriptorSet> allocateAndWriteComputeImageDescriptorSets(LogicalDevice*                  pLogicalDevice,
+                                                                            VkDescriptorPool                descriptorPool,
+                                                                            VkDescriptorSetLayout           descriptorSetLayout,
+                                                                            VkSampler                       sampler,
+                                                                            const std::vector<VkImageView>& inputImageViews,
+                                                                            const std::vector<VkImageView>& storageImageViews);
 } // namespace vkBasalt
 
 #endif // DESCRIPTOR_SET_HPP_INCLUDED
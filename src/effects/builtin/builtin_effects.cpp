@@ -41,12 +41,13 @@ namespace vkBasalt
         effects["cas"] = {
             "cas",
             false,  // uses UNORM
+            true,   // lut can be fused
             {
                 {"casSharpness", "Sharpness", ParamType::Float, 0.4f, 0.0f, 1.0f}
             },
             [](LogicalDevice* dev, VkFormat fmt, VkExtent2D ext,
-               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg) {
-                return std::make_shared<CasEffect>(dev, fmt, ext, in, out, cfg);
+               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg, bool fuseLut) {
+                return std::make_shared<CasEffect>(dev, fmt, ext, in, out, cfg, fuseLut);
             }
         };
 
@@ -54,13 +55,14 @@ namespace vkBasalt
         effects["dls"] = {
             "dls",
             false,  // uses UNORM
+            true,   // lut can be fused
             {
                 {"dlsSharpness", "Sharpness", ParamType::Float, 0.5f, 0.0f, 1.0f},
                 {"dlsDenoise", "Denoise", ParamType::Float, 0.17f, 0.0f, 1.0f}
             },
             [](LogicalDevice* dev, VkFormat fmt, VkExtent2D ext,
-               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg) {
-                return std::make_shared<DlsEffect>(dev, fmt, ext, in, out, cfg);
+               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg, bool fuseLut) {
+                return std::make_shared<DlsEffect>(dev, fmt, ext, in, out, cfg, fuseLut);
             }
         };
 
@@ -68,13 +70,14 @@ namespace vkBasalt
         effects["fxaa"] = {
             "fxaa",
             true,   // uses SRGB
+            false,  // no lut fusion
             {
                 {"fxaaQualitySubpix", "Quality Subpix", ParamType::Float, 0.75f, 0.0f, 1.0f},
                 {"fxaaQualityEdgeThreshold", "Edge Threshold", ParamType::Float, 0.125f, 0.0f, 0.5f},
                 {"fxaaQualityEdgeThresholdMin", "Edge Threshold Min", ParamType::Float, 0.0312f, 0.0f, 0.1f}
             },
             [](LogicalDevice* dev, VkFormat fmt, VkExtent2D ext,
-               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg) {
+               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg, bool fuseLut) {
                 return std::make_shared<FxaaEffect>(dev, fmt, ext, in, out, cfg);
             }
         };
@@ -83,6 +86,7 @@ namespace vkBasalt
         effects["smaa"] = {
             "smaa",
             false,  // uses UNORM
+            false,  // no lut fusion
             {
                 {"smaaThreshold", "Threshold", ParamType::Float, 0.05f, 0.0f, 0.5f},
                 {"smaaMaxSearchSteps", "Max Search Steps", ParamType::Int, 0, 0, 0, 32, 0, 112},
@@ -90,7 +94,7 @@ namespace vkBasalt
                 {"smaaCornerRounding", "Corner Rounding", ParamType::Int, 0, 0, 0, 25, 0, 100}
             },
             [](LogicalDevice* dev, VkFormat fmt, VkExtent2D ext,
-               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg) {
+               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg, bool fuseLut) {
                 return std::make_shared<SmaaEffect>(dev, fmt, ext, in, out, cfg);
             }
         };
@@ -99,6 +103,7 @@ namespace vkBasalt
         effects["deband"] = {
             "deband",
             false,  // uses UNORM
+            true,   // lut can be fused
             {
                 {"debandAvgdiff", "Avg Diff", ParamType::Float, 3.4f, 0.0f, 255.0f},
                 {"debandMaxdiff", "Max Diff", ParamType::Float, 6.8f, 0.0f, 255.0f},
@@ -107,8 +112,8 @@ namespace vkBasalt
                 {"debandIterations", "Iterations", ParamType::Int, 0, 0, 0, 4, 1, 16}
             },
             [](LogicalDevice* dev, VkFormat fmt, VkExtent2D ext,
-               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg) {
-                return std::make_shared<DebandEffect>(dev, fmt, ext, in, out, cfg);
+               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg, bool fuseLut) {
+                return std::make_shared<DebandEffect>(dev, fmt, ext, in, out, cfg, fuseLut);
             }
         };
 
@@ -116,11 +121,12 @@ namespace vkBasalt
         effects["lut"] = {
             "lut",
             false,  // uses UNORM
+            false,  // no lut fusion
             {
                 {"lutFile", "LUT File", ParamType::Float, 0.0f, 0.0f, 0.0f}  // Placeholder param
             },
             [](LogicalDevice* dev, VkFormat fmt, VkExtent2D ext,
-               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg) {
+               std::vector<VkImage> in, std::vector<VkImage> out, Config* cfg, bool fuseLut) {
                 return std::make_shared<LutEffect>(dev, fmt, ext, in, out, cfg);
             }
         };
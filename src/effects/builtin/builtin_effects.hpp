@@ -35,13 +35,15 @@ namespace vkBasalt
         VkExtent2D extent,
         std::vector<VkImage> inputImages,
         std::vector<VkImage> outputImages,
-        Config* pConfig)>;
+        Config* pConfig,
+        bool fuseLut)>;
 
     // Built-in effect definition
     struct BuiltInEffectDef
     {
         std::string typeName;
         bool usesSrgbFormat;
+        bool fusesLut;  // A lut directly after it can run in its pass (factory fuseLut)
         std::vector<ParamDef> params;
         EffectFactory factory;
     };
@@ -20,13 +20,15 @@ namespace vkBasalt
                          VkExtent2D           imageExtent,
                          std::vector<VkImage> inputImages,
                          std::vector<VkImage> outputImages,
-                         Config*              pConfig)
+                         Config*              pConfig,
+                         bool                 fuseLut)
     {
 
         float sharpness = pConfig->getOption<float>("casSharpness", 0.4f);
 
         vertexCode   = full_screen_triangle_vert;
-        fragmentCode = cas_frag;
+        fragmentCode = fuseLut ? cas_frag_lut : cas_frag;
+        computeCode  = fuseLut ? cas_comp_lut : cas_comp;
 
         VkSpecializationMapEntry sharpnessMapEntry;
         sharpnessMapEntry.constantID = 0;
@@ -41,6 +43,7 @@ namespace vkBasalt
 
         pVertexSpecInfo   = nullptr;
         pFragmentSpecInfo = &fragmentSpecializationInfo;
+        this->fuseLut     = fuseLut;
 
         init(pLogicalDevice, format, imageExtent, inputImages, outputImages, pConfig);
     }
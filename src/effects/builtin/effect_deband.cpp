@@ -20,10 +20,11 @@ namespace vkBasalt
                                VkExtent2D           imageExtent,
                                std::vector<VkImage> inputImages,
                                std::vector<VkImage> outputImages,
-                               Config*              pConfig)
+                               Config*              pConfig,
+                               bool                 fuseLut)
     {
         vertexCode   = full_screen_triangle_vert;
-        fragmentCode = deband_frag;
+        fragmentCode = fuseLut ? deband_frag_lut : deband_frag;
 
         struct
         {
@@ -66,6 +67,7 @@ namespace vkBasalt
 
         pVertexSpecInfo   = nullptr;
         pFragmentSpecInfo = &specializationInfo;
+        this->fuseLut     = fuseLut;
 
         init(pLogicalDevice, format, imageExtent, inputImages, outputImages, pConfig);
     }
@@ -23,7 +23,8 @@ namespace vkBasalt
                      VkExtent2D           imageExtent,
                      std::vector<VkImage> inputImages,
                      std::vector<VkImage> outputImages,
-                     Config*              pConfig);
+                     Config*              pConfig,
+                     bool                 fuseLut = false);
         ~DebandEffect();
     };
 } // namespace vkBasalt
@@ -20,7 +20,8 @@ namespace vkBasalt
                          VkExtent2D           imageExtent,
                          std::vector<VkImage> inputImages,
                          std::vector<VkImage> outputImages,
-                         Config*              pConfig)
+                         Config*              pConfig,
+                         bool                 fuseLut)
     {
         float sharpness = pConfig->getOption<float>("dlsSharpness", 0.5f);
         float denoise   = pConfig->getOption<float>("dlsDenoise", 0.17f);
@@ -28,7 +29,8 @@ namespace vkBasalt
         float specData[2] = {sharpness, denoise};
 
         vertexCode   = full_screen_triangle_vert;
-        fragmentCode = dls_frag;
+        fragmentCode = fuseLut ? dls_frag_lut : dls_frag;
+        computeCode  = fuseLut ? dls_comp_lut : dls_comp;
 
         VkSpecializationMapEntry mapEntries[2];
         mapEntries[0].constantID = 0;
@@ -46,6 +48,7 @@ namespace vkBasalt
 
         pVertexSpecInfo   = nullptr;
         pFragmentSpecInfo = &fragmentSpecializationInfo;
+        this->fuseLut     = fuseLut;
 
         init(pLogicalDevice, format, imageExtent, inputImages, outputImages, pConfig);
     }
@@ -22,7 +22,8 @@ namespace vkBasalt
                   VkExtent2D           imageExtent,
                   std::vector<VkImage> inputImages,
                   std::vector<VkImage> outputImages,
-                  Config*              pConfig);
+                  Config*              pConfig,
+                  bool                 fuseLut = false);
         ~DlsEffect();
     };
 } // namespace vkBasalt
@@ -28,6 +28,7 @@ namespace vkBasalt
 
         vertexCode   = full_screen_triangle_vert;
         fragmentCode = fxaa_frag;
+        computeCode  = fxaa_comp;
 
         std::vector<VkSpecializationMapEntry> specMapEntrys(5);
 
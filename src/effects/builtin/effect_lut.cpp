@@ -1,7 +1,6 @@
 #include "effect_lut.hpp"
 
 #include <cstring>
-#include <stdexcept>
 
 #include "image_view.hpp"
 #include "descriptor_set.hpp"
@@ -11,10 +10,7 @@
 #include "framebuffer.hpp"
 #include "shader.hpp"
 #include "sampler.hpp"
-#include "image.hpp"
-#include "lut_cube.hpp"
-
-#include "stb_image.h"
+#include "lut_texture.hpp"
 
 #include "shader_sources.hpp"
 
@@ -29,42 +25,9 @@ namespace vkBasalt
     {
         vertexCode   = full_screen_triangle_vert;
         fragmentCode = lut_frag;
+        computeCode  = lut_comp;
 
-        std::string lutFile = pConfig->getOption<std::string>("lutFile");
-
-        if (lutFile.empty())
-        {
-            throw std::runtime_error("LUT effect requires 'lutFile' to be set in config");
-        }
-
-        int      height = 0;
-        LutCube  lutCube;
-        stbi_uc* pixels = nullptr;
-        int32_t  usingPNG = (int32_t)(lutFile.find(".cube") == std::string::npos && lutFile.find(".CUBE") == std::string::npos);
-        if (!usingPNG)
-        {
-            lutCube = LutCube(lutFile);
-            pixels  = lutCube.colorCube.data();
-            height  = lutCube.size;
-            if (height == 0 || pixels == nullptr)
-            {
-                throw std::runtime_error("Failed to load LUT cube file: " + lutFile);
-            }
-        }
-        else
-        {
-            int channels, width;
-            pixels = stbi_load(lutFile.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-            if (pixels == nullptr)
-            {
-                throw std::runtime_error("Failed to load LUT image file: " + lutFile);
-            }
-            if (width != height * height)
-            {
-                stbi_image_free(pixels);
-                throw std::runtime_error("Invalid LUT image dimensions (width must equal height*height): " + lutFile);
-            }
-        }
+        lutTexture = createLutTexture(pLogicalDevice, pConfig->getOption<std::string>("lutFile"));
 
         std::vector<VkSpecializationMapEntry> specMapEntrys(2);
         for (uint32_t i = 0; i < specMapEntrys.size(); i++)
@@ -73,7 +36,7 @@ namespace vkBasalt
             specMapEntrys[i].offset     = sizeof(int32_t) * i;
             specMapEntrys[i].size       = sizeof(int32_t);
         }
-        std::vector<int32_t> specData = {height, usingPNG};
+        std::vector<int32_t> specData = {lutTexture.size, lutTexture.flipGB};
 
         VkSpecializationInfo fragmentSpecializationInfo;
         fragmentSpecializationInfo.mapEntryCount = specMapEntrys.size();
@@ -84,25 +47,6 @@ namespace vkBasalt
         pVertexSpecInfo   = nullptr;
         pFragmentSpecInfo = &fragmentSpecializationInfo;
 
-        VkExtent3D lutImageExtent = {(uint32_t) height, (uint32_t) height, (uint32_t) height};
-
-        lutImage = createImages(pLogicalDevice,
-                                1,
-                                lutImageExtent,
-                                VK_FORMAT_R8G8B8A8_UNORM, // TODO search for format and save it
-                                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                lutMemory)[0];
-
-        uploadToImage(pLogicalDevice, lutImage, lutImageExtent, height * height * height * 4, pixels);
-
-        if (usingPNG)
-        {
-            stbi_image_free(pixels);
-        }
-
-        lutImageView = createImageViews(pLogicalDevice, VK_FORMAT_R8G8B8A8_UNORM, std::vector<VkImage>(1, lutImage), VK_IMAGE_VIEW_TYPE_3D)[0];
-
         lutDescriptorSetLayout = createImageSamplerDescriptorSetLayout(pLogicalDevice, 1);
         descriptorSetLayouts.push_back(lutDescriptorSetLayout);
 
@@ -121,7 +65,7 @@ namespace vkBasalt
                                                        lutDescriptorPool,
                                                        lutDescriptorSetLayout,
                                                        {sampler},
-                                                       std::vector<std::vector<VkImageView>>(1, std::vector<VkImageView>(1, lutImageView)))[0];
+                                                       std::vector<std::vector<VkImageView>>(1, std::vector<VkImageView>(1, lutTexture.view)))[0];
     }
     LutEffect::~LutEffect()
     {
@@ -129,16 +73,14 @@ namespace vkBasalt
         if (!pLogicalDevice)
             return;
 
-        pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, lutImageView, nullptr);
-        pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, lutImage, nullptr);
+        destroyLutTexture(pLogicalDevice, lutTexture);
         pLogicalDevice->vkd.DestroyDescriptorSetLayout(pLogicalDevice->device, lutDescriptorSetLayout, nullptr);
         pLogicalDevice->vkd.DestroyDescriptorPool(pLogicalDevice->device, lutDescriptorPool, nullptr);
-        pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, lutMemory, nullptr);
     }
     void LutEffect::applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer)
     {
         pLogicalDevice->vkd.CmdBindDescriptorSets(
-            commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &(lutDescriptorSet), 0, nullptr);
+            commandBuffer, bindPoint, pipelineLayout, 1, 1, &(lutDescriptorSet), 0, nullptr);
         SimpleEffect::applyEffect(imageIndex, commandBuffer);
     }
 } // namespace vkBasalt
@@ -12,6 +12,7 @@
 
 #include "../effect_simple.hpp"
 #include "config.hpp"
+#include "lut_texture.hpp"
 
 namespace vkBasalt
 {
@@ -28,9 +29,7 @@ namespace vkBasalt
         void applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer) override;
 
     private:
-        VkImage               lutImage = VK_NULL_HANDLE;
-        VkDeviceMemory        lutMemory = VK_NULL_HANDLE;
-        VkImageView           lutImageView = VK_NULL_HANDLE;
+        LutTexture            lutTexture;
         VkDescriptorSetLayout lutDescriptorSetLayout = VK_NULL_HANDLE;
         VkDescriptorPool      lutDescriptorPool = VK_NULL_HANDLE;
         VkDescriptorSet       lutDescriptorSet = VK_NULL_HANDLE;
@@ -27,6 +27,7 @@ namespace vkBasalt
                    std::vector<VkImage> outputImages,
                    Config*              pConfig);
         void applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer) override;
+        EffectImageUses getImageUses(uint32_t imageIndex) const override;
         ~SmaaEffect();
 
     private:
@@ -10,16 +10,47 @@
 
 #include "vulkan_include.hpp"
 #include "params/effect_param.hpp"
+#include "frame_context.hpp"
 
 namespace vkBasalt
 {
+    struct UniformRing;
+
+    // Layout of a chain image and the stages and accesses of a use of it
+    struct ImageState
+    {
+        VkImageLayout        layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags stage  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags        access = 0;
+    };
+
+    // The chain images an effect reads and writes for one image index.
+    // recordEffectChain records the barriers between effects, effects only synchronize their own images
+    struct EffectImageUses
+    {
+        VkImage    input  = VK_NULL_HANDLE;
+        VkImage    output = VK_NULL_HANDLE;
+        ImageState inputState;        // Sampled or copied input when the effect starts
+        ImageState outputState;       // Output when the effect starts, its previous content is discarded
+        ImageState outputStateAfter;  // Output once the effect is done
+    };
+
     class Effect
     {
     public:
         void virtual applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer) = 0;
-        void virtual updateEffect(){};
+        EffectImageUses virtual getImageUses(uint32_t imageIndex) const = 0;
+        // Write the uniforms the command buffer of this image index reads
+        void virtual updateEffect(uint32_t imageIndex, const FrameContext& frame){};
+        // Bytes of uniforms the effect needs every frame, they live in the swapchain's UniformRing
+        uint32_t virtual getUniformSize() const { return 0; }
+        // The range of each slice of the ring that belongs to the effect, bound through descriptorSet with a dynamic offset
+        void virtual useUniformRing(UniformRing* pUniformRing, VkDescriptorSet descriptorSet, VkDeviceSize offset){};
         void virtual useDepthImage(VkImageView depthImageView){};
         virtual std::vector<std::unique_ptr<EffectParam>> getParameters() const { return {}; }
+        // Move the effect to other input/output images of the same extent and format, keeping its pipelines.
+        // Returns false if the effect has to be recreated instead (used by incremental reloads)
+        bool virtual rebindImages(const std::vector<VkImage>& inputImages, const std::vector<VkImage>& outputImages) { return false; }
         virtual ~Effect(){};
 
     private:
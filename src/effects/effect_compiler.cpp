@@ -0,0 +1,114 @@
+#include "effect_compiler.hpp"
+
+#include "logger.hpp"
+
+namespace vkBasalt
+{
+    EffectCompiler::~EffectCompiler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+
+        for (auto& worker : workers)
+        {
+            if (worker->thread.joinable())
+                worker->thread.join();
+        }
+    }
+
+    uint64_t EffectCompiler::submit(const std::string& effectName, const std::string& effectPath, const ReshadeCompileOptions& options)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint64_t ticket = nextTicket++;
+
+        if (workers.empty())
+        {
+            uint32_t workerCount = getWorkerCount();
+            for (uint32_t i = 0; i < workerCount; i++)
+                workers.push_back(std::make_unique<Worker>());
+            // Only started once all deques exist, workers steal from each other's
+            for (uint32_t i = 0; i < workerCount; i++)
+                workers[i]->thread = std::thread(&EffectCompiler::workerLoop, this, i);
+            Logger::debug("EffectCompiler: started " + std::to_string(workerCount) + " compile threads");
+        }
+
+        // Queued before it is counted, so a worker that claims it always finds it in some deque
+        Worker& worker = *workers[nextWorker];
+        nextWorker     = (nextWorker + 1) % workers.size();
+        {
+            std::lock_guard<std::mutex> workerLock(worker.mutex);
+            worker.jobs.push_back({ticket, effectName, effectPath, options});
+        }
+        pendingJobs++;
+
+        jobAvailable.notify_one();
+        Logger::debug("EffectCompiler: queued " + effectName + " (" + std::to_string(pendingJobs) + " pending)");
+        return ticket;
+    }
+
+    std::vector<std::pair<uint64_t, std::shared_ptr<CompiledReshadeEffect>>> EffectCompiler::takeFinished()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::pair<uint64_t, std::shared_ptr<CompiledReshadeEffect>>> results;
+        results.swap(finished);
+        return results;
+    }
+
+    uint32_t EffectCompiler::getWorkerCount()
+    {
+        uint32_t cores = std::thread::hardware_concurrency();  // 0 if unknown
+        return cores > 2 ? cores - 1 : 1;
+    }
+
+    EffectCompiler::Job EffectCompiler::takeJob(size_t workerIndex)
+    {
+        // Other workers may take the jobs of a deque while we look at the next one, but every claim
+        // leaves a job for its claimer, so going round again always ends with one
+        for (size_t i = workerIndex;; i = (i + 1) % workers.size())
+        {
+            Worker&                     worker = *workers[i];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.jobs.empty())
+                continue;
+
+            Job job;
+            if (i == workerIndex)
+            {
+                job = std::move(worker.jobs.front());
+                worker.jobs.pop_front();
+            }
+            else
+            {
+                job = std::move(worker.jobs.back());
+                worker.jobs.pop_back();
+                Logger::debug("EffectCompiler: worker " + std::to_string(workerIndex) + " stole " + job.effectName);
+            }
+            return job;
+        }
+    }
+
+    void EffectCompiler::workerLoop(size_t workerIndex)
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [this] { return stopping || pendingJobs > 0; });
+                if (stopping)
+                    return;
+                pendingJobs--;
+            }
+            Job job = takeJob(workerIndex);
+
+            auto compiled = compileReshadeEffect(job.effectName, job.effectPath, job.options);
+            loadReshadeTextures(*compiled);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.emplace_back(job.ticket, std::move(compiled));
+        }
+    }
+
+} // namespace vkBasalt
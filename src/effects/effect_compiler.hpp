@@ -0,0 +1,72 @@
+#ifndef EFFECT_COMPILER_HPP_INCLUDED
+#define EFFECT_COMPILER_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <utility>
+#include <cstdint>
+
+#include "reshade_parser.hpp"
+
+namespace vkBasalt
+{
+    // Compiles ReShade effects on a pool of background threads so the present path never waits on
+    // preprocessing, parsing, SPIR-V generation or texture decoding, and a whole chain compiles in
+    // about the time of its slowest effect. Results are picked up with takeFinished() from the
+    // present thread, which is the only place registry and swapchain state is changed.
+    // Jobs are dealt round-robin to per-worker deques, a worker takes the oldest job of its own deque
+    // and steals the newest one of another worker's when its own is empty.
+    class EffectCompiler
+    {
+    public:
+        ~EffectCompiler();
+
+        // Queue a compile, returns a ticket identifying the result
+        uint64_t submit(const std::string& effectName, const std::string& effectPath, const ReshadeCompileOptions& options);
+
+        // Collect results finished since the last call, paired with their ticket
+        std::vector<std::pair<uint64_t, std::shared_ptr<CompiledReshadeEffect>>> takeFinished();
+
+    private:
+        struct Job
+        {
+            uint64_t ticket;
+            std::string effectName;
+            std::string effectPath;
+            ReshadeCompileOptions options;
+        };
+
+        struct Worker
+        {
+            std::mutex mutex;  // Guards jobs, taken by the owner and by thieves
+            std::deque<Job> jobs;
+            std::thread thread;
+        };
+
+        std::vector<std::pair<uint64_t, std::shared_ptr<CompiledReshadeEffect>>> finished;
+        uint64_t nextTicket = 1;
+        size_t nextWorker = 0;   // Worker the next job is dealt to
+        size_t pendingJobs = 0;  // Jobs in the deques no worker has claimed yet
+        bool stopping = false;
+
+        std::mutex mutex;  // Guards everything above
+        std::condition_variable jobAvailable;
+        std::vector<std::unique_ptr<Worker>> workers;  // Started on first submit, not at library load
+
+        // Pool size: one thread per core, minus one left to the game's own threads
+        static uint32_t getWorkerCount();
+
+        // Take a claimed job, from the own deque first, otherwise stolen from another worker
+        Job takeJob(size_t workerIndex);
+
+        void workerLoop(size_t workerIndex);
+    };
+
+} // namespace vkBasalt
+
+#endif // EFFECT_COMPILER_HPP_INCLUDED
@@ -4,11 +4,14 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
 
 #include "params/effect_param.hpp"
 
 namespace vkBasalt
 {
+    struct CompiledReshadeEffect;  // Forward declaration (reshade_parser.hpp)
+
     enum class EffectType
     {
         BuiltIn,  // cas, dls, fxaa, smaa, deband, lut
@@ -25,6 +28,14 @@ namespace vkBasalt
         std::string effectName;     // Which effect this belongs to
     };
 
+    // A technique of a ReShade effect, the passes of enabled ones are recorded in order
+    struct TechniqueState
+    {
+        std::string name;
+        bool enabled = false;
+        bool defaultEnabled = false;  // From the "enabled"/"hidden" annotations, or the first technique
+    };
+
     struct EffectConfig
     {
         std::string name;       // Instance name: "cas", "cas.2", "Clarity", etc.
@@ -34,7 +45,11 @@ namespace vkBasalt
         bool enabled = true;
         std::vector<std::unique_ptr<EffectParam>> parameters;
         std::vector<PreprocessorDefinition> preprocessorDefs;  // ReShade: user-configurable macros
+        std::vector<TechniqueState> techniques;                // ReShade: switched without recompiling
         std::string compileError;  // Empty if compiled successfully, error message if failed
+        std::vector<std::shared_ptr<const CompiledReshadeEffect>> compiled;  // ReShade: modules shared with ReshadeEffect, one per compile target
+        bool compiling = false;     // ReShade: first compile not finished yet (no parameters/macros)
+        uint64_t compileTicket = 0; // ReShade: background compile in flight (0 if none)
         bool hasFailed() const { return !compileError.empty(); }
     };
 
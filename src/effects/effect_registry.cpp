@@ -6,6 +6,7 @@
 
 #include "reshade_parser.hpp"
 #include "config_serializer.hpp"
+#include "settings_manager.hpp"
 #include "builtin/builtin_effects.hpp"
 #include "logger.hpp"
 
@@ -93,6 +94,9 @@ namespace vkBasalt
         std::lock_guard<std::mutex> lock(mutex);
         this->pConfig = pConfig;
         effects.clear();
+        parameterGeneration++;
+        parameterSetGeneration++;
+        techniqueGeneration++;
 
         std::vector<std::string> effectNames = pConfig->getOption<std::vector<std::string>>("effects");
         std::vector<std::string> disabledEffects = pConfig->getOption<std::vector<std::string>>("disabledEffects");
@@ -183,41 +187,69 @@ namespace vkBasalt
         std::filesystem::path p(path);
         config.effectType = p.stem().string();
 
-        // Test shader compilation first to catch errors
-        ShaderTestResult testResult = testShaderCompilation(name, path);
-        if (!testResult.success)
+        // Compiled in the background, errors, parameters, macros and the module all come from this result.
+        // Until the swapchain size is known the compile waits (see setCompileTarget).
+        config.compiling = true;
+        if (compileWidth != 0)
+            config.compileTicket = compiler.submit(name, path, makeCompileOptions(config, compileWidth, compileHeight, compileColorDepth));
+
+        effects.push_back(std::move(config));
+    }
+
+    void EffectRegistry::installReshadeEffect(EffectConfig& effect, const CompiledReshadeEffect& compiled)
+    {
+        if (!compiled.success)
         {
-            config.compileError = testResult.errorMessage;
-            config.enabled = false;  // Disable failed effects by default
-            Logger::err("EffectRegistry: failed to compile " + name + ": " + testResult.errorMessage);
+            effect.compileError = compiled.errorMessage;
+            effect.enabled = false;  // Disable failed effects by default
+            Logger::err("EffectRegistry: failed to compile " + effect.name + ": " + compiled.errorMessage);
+            return;
         }
-        else
-        {
-            // Only parse parameters if compilation succeeded
-            config.parameters = parseReshadeEffect(name, path, pConfig);
 
-            // Extract preprocessor definitions (user-configurable macros)
-            config.preprocessorDefs = extractPreprocessorDefinitions(name, path);
+        // Only parse parameters if compilation succeeded
+        effect.parameters = parseReshadeEffect(compiled, pConfig);
+        parameterSetGeneration++;
+
+        // Extract preprocessor definitions (user-configurable macros)
+        effect.preprocessorDefs = extractPreprocessorDefinitions(compiled);
 
-            // Override default values with any saved values from config
-            // Config format: effectName@MACRO = value
-            for (auto& def : config.preprocessorDefs)
+        // Override default values with any saved values from config
+        // Config format: effectName@MACRO = value
+        for (auto& def : effect.preprocessorDefs)
+        {
+            std::string configKey = effect.name + "@" + def.name;
+            std::string savedValue = pConfig->getOption<std::string>(configKey, "");
+            if (!savedValue.empty())
             {
-                std::string configKey = name + "@" + def.name;
-                std::string savedValue = pConfig->getOption<std::string>(configKey, "");
-                if (!savedValue.empty())
-                {
-                    def.value = savedValue;
-                    Logger::debug("EffectRegistry: loaded preprocessor def " + configKey + " = " + savedValue);
-                }
+                def.value = savedValue;
+                Logger::debug("EffectRegistry: loaded preprocessor def " + configKey + " = " + savedValue);
             }
+        }
 
-            Logger::debug("EffectRegistry: loaded ReShade effect " + name + " with " +
-                          std::to_string(config.parameters.size()) + " parameters and " +
-                          std::to_string(config.preprocessorDefs.size()) + " preprocessor defs");
+        // Config format: effectName.techniques = Technique1:Technique2 (the enabled ones, in any order)
+        effect.techniques = extractTechniques(compiled.module);
+        std::vector<std::string> savedTechniques = pConfig->getInstanceOption<std::vector<std::string>>(effect.name, "techniques", {});
+        if (!savedTechniques.empty())
+        {
+            for (auto& technique : effect.techniques)
+                technique.enabled = std::find(savedTechniques.begin(), savedTechniques.end(), technique.name) != savedTechniques.end();
         }
+        techniqueGeneration++;
 
-        effects.push_back(std::move(config));
+        Logger::debug("EffectRegistry: loaded ReShade effect " + effect.name + " with " +
+                      std::to_string(effect.parameters.size()) + " parameters and " +
+                      std::to_string(effect.preprocessorDefs.size()) + " preprocessor defs");
+    }
+
+    ReshadeCompileOptions EffectRegistry::makeCompileOptions(const EffectConfig& effect, uint32_t width, uint32_t height, uint32_t colorDepth) const
+    {
+        ReshadeCompileOptions options;
+        options.bufferWidth = width;
+        options.bufferHeight = height;
+        options.colorDepth = colorDepth;
+        options.uniformsToSpecConstants = !settingsManager.getLiveParams();
+        options.customDefs = effect.preprocessorDefs;
+        return options;
     }
 
     std::vector<const EffectConfig*> EffectRegistry::getEnabledEffects() const
@@ -327,7 +359,10 @@ namespace vkBasalt
 
         EffectParam* param = findParam(*effect, paramName);
         if (param && param->getType() == ParamType::Float)
+        {
             static_cast<FloatParam*>(param)->value = value;
+            parameterGeneration++;
+        }
     }
 
     void EffectRegistry::setParameterValue(const std::string& effectName, const std::string& paramName, int value)
@@ -340,7 +375,10 @@ namespace vkBasalt
 
         EffectParam* param = findParam(*effect, paramName);
         if (param && param->getType() == ParamType::Int)
+        {
             static_cast<IntParam*>(param)->value = value;
+            parameterGeneration++;
+        }
     }
 
     void EffectRegistry::setParameterValue(const std::string& effectName, const std::string& paramName, bool value)
@@ -353,7 +391,10 @@ namespace vkBasalt
 
         EffectParam* param = findParam(*effect, paramName);
         if (param && param->getType() == ParamType::Bool)
+        {
             static_cast<BoolParam*>(param)->value = value;
+            parameterGeneration++;
+        }
     }
 
     EffectParam* EffectRegistry::getParameter(const std::string& effectName, const std::string& paramName)
@@ -447,30 +488,39 @@ namespace vkBasalt
 
     void EffectRegistry::ensureEffect(const std::string& instanceName, const std::string& effectType)
     {
+        Config* config;
         {
             std::lock_guard<std::mutex> lock(mutex);
             if (findEffect(instanceName))
                 return;
+            config = pConfig;
         }
 
         // If effectType not provided, assume instanceName is the effect type
-        std::string type = effectType.empty() ? instanceName : effectType;
+        std::string type    = effectType.empty() ? instanceName : effectType;
+        bool        builtIn = isBuiltInEffect(type);
 
-        if (isBuiltInEffect(type))
+        // Use effectType to find the shader file (outside the lock, it touches the filesystem)
+        std::string path;
+        if (!builtIn)
         {
-            initBuiltInEffect(instanceName, type);
-            return;
+            path = findEffectPath(type, config);
+            if (path.empty() || !std::filesystem::exists(path))
+            {
+                Logger::warn("EffectRegistry::ensureEffect: could not find effect file for: " + type);
+                return;
+            }
         }
 
-        // Use effectType to find the shader file
-        std::string path = findEffectPath(type, pConfig);
-        if (path.empty() || !std::filesystem::exists(path))
-        {
-            Logger::warn("EffectRegistry::ensureEffect: could not find effect file for: " + type);
+        // Someone else may have added it meanwhile
+        std::lock_guard<std::mutex> lock(mutex);
+        if (findEffect(instanceName))
             return;
-        }
 
-        initReshadeEffect(instanceName, path);
+        if (builtIn)
+            initBuiltInEffect(instanceName, type);
+        else
+            initReshadeEffect(instanceName, path);
     }
 
     // Static empty vector for returning when effect not found
@@ -507,6 +557,142 @@ namespace vkBasalt
         }
     }
 
+    std::vector<TechniqueState> EffectRegistry::getTechniques(const std::string& effectName) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const EffectConfig* effect = findEffect(effectName);
+        return effect ? effect->techniques : std::vector<TechniqueState>{};
+    }
+
+    void EffectRegistry::setTechniqueEnabled(const std::string& effectName, const std::string& techniqueName, bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EffectConfig* effect = findEffect(effectName);
+        if (!effect)
+            return;
+
+        for (auto& technique : effect->techniques)
+        {
+            if (technique.name == techniqueName)
+            {
+                technique.enabled = enabled;
+                techniqueGeneration++;
+                return;
+            }
+        }
+    }
+
+    void EffectRegistry::setCompileTarget(uint32_t width, uint32_t height, uint32_t colorDepth)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        compileWidth = width;
+        compileHeight = height;
+        compileColorDepth = colorDepth;
+
+        // Start the registration compiles that were waiting for a target
+        for (auto& effect : effects)
+        {
+            if (effect.compiling && effect.compileTicket == 0)
+                effect.compileTicket = compiler.submit(effect.name, effect.filePath, makeCompileOptions(effect, width, height, colorDepth));
+        }
+    }
+
+    bool EffectRegistry::isEffectCompiling(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const EffectConfig* effect = findEffect(name);
+        return effect && effect->compiling;
+    }
+
+    bool EffectRegistry::ensureCompiled(const std::string& effectName, uint32_t width, uint32_t height, uint32_t colorDepth)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EffectConfig* effect = findEffect(effectName);
+        if (!effect || effect->type != EffectType::ReShade || effect->hasFailed())
+            return false;
+
+        // Check again once the compile in flight has landed
+        if (effect->compiling || effect->compileTicket != 0)
+            return true;
+
+        ReshadeCompileOptions options = makeCompileOptions(*effect, width, height, colorDepth);
+        for (const auto& compiled : effect->compiled)
+        {
+            if (compiled->matches(options))
+                return false;
+        }
+
+        effect->compileTicket = compiler.submit(effect->name, effect->filePath, options);
+        return true;
+    }
+
+    bool EffectRegistry::processCompiledEffects()
+    {
+        auto results = compiler.takeFinished();
+        if (results.empty())
+            return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        bool installed = false;
+        for (auto& [ticket, compiled] : results)
+        {
+            // Dropped if the effect was removed or re-registered (config switch) meanwhile
+            EffectConfig* effect = findEffect(compiled->effectName);
+            if (!effect || effect->compileTicket != ticket)
+                continue;
+
+            effect->compileTicket = 0;
+            installed = true;
+
+            // Kept even if it failed, so ReshadeEffect reports the error through setEffectError
+            if (effect->compiled.size() >= maxCompiledVariants)
+                effect->compiled.erase(effect->compiled.begin());
+            effect->compiled.push_back(compiled);
+
+            if (effect->compiling)
+            {
+                effect->compiling = false;
+                installReshadeEffect(*effect, *compiled);
+            }
+        }
+        return installed;
+    }
+
+    std::shared_ptr<const CompiledReshadeEffect> EffectRegistry::getCompiledEffect(const std::string& effectName,
+                                                                                   const ReshadeCompileOptions& options) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const EffectConfig* effect = findEffect(effectName);
+        if (!effect)
+            return nullptr;
+
+        for (const auto& compiled : effect->compiled)
+        {
+            if (compiled->filePath == effect->filePath && compiled->matches(options))
+                return compiled;
+        }
+        return nullptr;
+    }
+
+    void EffectRegistry::setCompiledEffect(const std::string& effectName, std::shared_ptr<const CompiledReshadeEffect> compiled)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EffectConfig* effect = findEffect(effectName);
+        if (!effect)
+            return;
+
+        if (effect->compiled.size() >= maxCompiledVariants)
+            effect->compiled.erase(effect->compiled.begin());
+        effect->compiled.push_back(std::move(compiled));
+    }
+
+    void EffectRegistry::clearCompiledEffects()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& effect : effects)
+            effect.compiled.clear();
+    }
+
     void EffectRegistry::setSelectedEffects(const std::vector<std::string>& effects)
     {
         std::lock_guard<std::mutex> lock(mutex);
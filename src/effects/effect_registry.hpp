@@ -7,8 +7,10 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 #include "effect_config.hpp"
+#include "effect_compiler.hpp"
 #include "config.hpp"
 
 namespace vkBasalt
@@ -44,6 +46,18 @@ namespace vkBasalt
         void setParameterValue(const std::string& effectName, const std::string& paramName, int value);
         void setParameterValue(const std::string& effectName, const std::string& paramName, bool value);
 
+        // Changes whenever parameter values may have changed, uniform buffers are only rewritten then.
+        // The overlay edits parameters in place, so every frame it is (or just was) visible counts as a change.
+        uint64_t getParameterGeneration() const { return parameterGeneration; }
+        void touchParameters() { parameterGeneration++; }
+
+        // Changes whenever parameter objects are replaced (config switch, first compile of an effect),
+        // EffectParam pointers kept across frames have to be looked up again then.
+        uint64_t getParameterSetGeneration() const { return parameterSetGeneration; }
+
+        // Changes whenever a technique may have been switched, effects resolve their enabled techniques again then
+        uint64_t getTechniqueGeneration() const { return techniqueGeneration; }
+
         // Get parameter by name
         EffectParam* getParameter(const std::string& effectName, const std::string& paramName);
         const EffectParam* getParameter(const std::string& effectName, const std::string& paramName) const;
@@ -88,6 +102,35 @@ namespace vkBasalt
         // Set a preprocessor definition value
         void setPreprocessorDefValue(const std::string& effectName, const std::string& macroName, const std::string& value);
 
+        // Techniques of a ReShade effect (empty until the first compile finished)
+        std::vector<TechniqueState> getTechniques(const std::string& effectName) const;
+
+        // Switch a technique on or off, applied by re-recording the command buffers (the module has all of them)
+        void setTechniqueEnabled(const std::string& effectName, const std::string& techniqueName, bool enabled);
+
+        // Set the buffer size/color depth ReShade effects are compiled for (from the swapchain).
+        // Registration compiles wait for this, so the first module already fits the swapchain.
+        void setCompileTarget(uint32_t width, uint32_t height, uint32_t colorDepth);
+
+        // Check if an effect is still waiting for its first compile (no parameters yet)
+        bool isEffectCompiling(const std::string& name) const;
+
+        // Make sure an effect has a module compiled for the given target, queueing a background compile if not.
+        // Returns true while the effect is not ready yet.
+        bool ensureCompiled(const std::string& effectName, uint32_t width, uint32_t height, uint32_t colorDepth);
+
+        // Install finished background compiles (call once per frame from the present thread).
+        // Returns true if any effect got a new module.
+        bool processCompiledEffects();
+
+        // Compiled module matching the given options, reused by ReshadeEffect (nullptr if none)
+        std::shared_ptr<const CompiledReshadeEffect> getCompiledEffect(const std::string& effectName,
+                                                                       const ReshadeCompileOptions& options) const;
+        void setCompiledEffect(const std::string& effectName, std::shared_ptr<const CompiledReshadeEffect> compiled);
+
+        // Drop all compiled modules so the next reload compiles again (picks up edited .fx files)
+        void clearCompiledEffects();
+
         // Selected effects management (ordered list for UI)
         const std::vector<std::string>& getSelectedEffects() const { return selectedEffects; }
         void setSelectedEffects(const std::vector<std::string>& effects);
@@ -104,14 +147,28 @@ namespace vkBasalt
         std::vector<std::string> selectedEffects;  // Ordered list of selected effects for UI
         bool initializedFromConfig = false;        // True once first load from config is complete
         Config* pConfig = nullptr;
+        uint32_t compileWidth = 0;                 // Unknown until the first swapchain
+        uint32_t compileHeight = 0;
+        uint32_t compileColorDepth = 8;
+        EffectCompiler compiler;
+        static constexpr size_t maxCompiledVariants = 4;  // Modules kept per effect (e.g. one per swapchain size)
         mutable std::mutex mutex;
+        std::atomic<uint64_t> parameterGeneration{0};
+        std::atomic<uint64_t> parameterSetGeneration{0};
+        std::atomic<uint64_t> techniqueGeneration{0};
 
-        // Initialize built-in effect configs
+        // Initialize built-in effect configs (assume mutex is held)
         void initBuiltInEffect(const std::string& instanceName, const std::string& effectType);
 
-        // Initialize ReShade effect config
+        // Initialize ReShade effect config, parameters are filled in once the background compile finishes (assume mutex is held)
         void initReshadeEffect(const std::string& name, const std::string& path);
 
+        // Fill parameters and macros of a ReShade effect from its first compile
+        void installReshadeEffect(EffectConfig& effect, const CompiledReshadeEffect& compiled);
+
+        // Compile options for an effect (assume mutex is held)
+        ReshadeCompileOptions makeCompileOptions(const EffectConfig& effect, uint32_t width, uint32_t height, uint32_t colorDepth) const;
+
         // Internal helpers (assume mutex is held)
         EffectConfig* findEffect(const std::string& effectName);
         const EffectConfig* findEffect(const std::string& effectName) const;
@@ -4,9 +4,11 @@
 #include <climits>
 #include <cstdlib>
 #include <cassert>
+#include <stdexcept>
 
 #include <set>
 #include <variant>
+#include <type_traits>
 #include <algorithm>
 #include <filesystem>
 
@@ -21,12 +23,15 @@
 #include "image.hpp"
 #include "format.hpp"
 #include "config_serializer.hpp"
+#include "settings_manager.hpp"
+#include "reshade_parser.hpp"
 
-#include "util.hpp"
+#include "reshade_texture.hpp"
+#include "render_target_pool.hpp"
+#include "uniform_ring.hpp"
+#include "frame_sync.hpp"
 
-#include "stb_image.h"
-#include "stb_image_dds.h"
-#include "stb_image_resize.h"
+#include "util.hpp"
 
 namespace vkBasalt
 {
@@ -35,6 +40,8 @@ namespace vkBasalt
                                  VkExtent2D           imageExtent,
                                  std::vector<VkImage> inputImages,
                                  std::vector<VkImage> outputImages,
+                                 std::shared_ptr<StencilAttachment> pStencilAttachment,
+                                 RenderTargetPool*    pRenderTargetPool,
                                  EffectRegistry*      pEffectRegistry,
                                  std::string          effectName,
                                  std::string          effectPath,
@@ -46,10 +53,12 @@ namespace vkBasalt
         this->imageExtent           = imageExtent;
         this->inputImages           = inputImages;
         this->outputImages          = outputImages;
+        this->pStencilAttachment    = pStencilAttachment;
         this->pEffectRegistry       = pEffectRegistry;
         this->effectName            = effectName;
         this->effectPath            = effectPath;
         this->customPreprocessorDefs = customDefs;
+        useDynamicRendering          = pLogicalDevice->supportsDynamicRendering;
         inputOutputFormatUNORM = convertToUNORM(format);
         inputOutputFormatSRGB  = convertToSRGB(format);
 
@@ -64,34 +73,62 @@ namespace vkBasalt
 
         enumerateReshadeUniforms(module);
 
-        uniforms = createReshadeUniforms(module);
+        uniforms = createReshadeUniforms(module, pEffectRegistry, effectName);
 
+        // The uniform buffer itself is a range of the swapchain's UniformRing (see useUniformRing)
         bufferSize = module.total_uniform_size;
-        if (bufferSize)
+
+        // Every technique is built, which of them run is only decided when recording (see resolveTechniques)
+        std::vector<reshadefx::pass_info> passes;
+        for (uint32_t t = 0; t < module.techniques.size(); t++)
         {
-            createBuffer(pLogicalDevice,
-                         bufferSize,
-                         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                         stagingBuffer,
-                         stagingBufferMemory);
+            for (const auto& pass : module.techniques[t].passes)
+            {
+                passes.push_back(pass);
+                passTechniques.push_back(t);
+                passVertexCounts.push_back(pass.num_vertices);
+            }
         }
 
-        stencilFormat = getStencilFormat(pLogicalDevice);
-        Logger::debug("Stencil Format: " + std::to_string(stencilFormat));
-        textureMemory.push_back(VK_NULL_HANDLE);
-        stencilImage = createImages(pLogicalDevice,
-                                    1,
-                                    {imageExtent.width, imageExtent.height, 1},
-                                    stencilFormat,
-                                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                    textureMemory.back())[0];
-
-        stencilImageView = createImageViews(
-            pLogicalDevice, stencilFormat, {stencilImage}, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)[0];
+        // Render targets without content between frames get their memory from the pool, shared with other effects and passes
+        std::unordered_map<std::string, RenderTargetLifetime> transientTargets = getTransientRenderTargets(module, imageExtent);
+        std::unordered_map<std::string, VkImage>              pooledImages;
+        std::vector<PooledRenderTarget>                       pooledTargets;
+        renderTargetDiscards.resize(passes.size());
+        for (const auto& texture : module.textures)
+        {
+            auto lifetime = transientTargets.find(texture.unique_name);
+            if (lifetime == transientTargets.end())
+                continue;
 
-        std::vector<std::vector<VkImageView>> imageViewVector;
+            VkImage image = createUnboundImage(pLogicalDevice,
+                                               {texture.width, texture.height, 1},
+                                               convertReshadeFormat(texture.format),
+                                               VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+                                                   | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                               texture.levels);
+            pooledImages[texture.unique_name] = image;
+            pooledTargets.push_back({image, lifetime->second});
+
+            // Whatever the memory held before is discarded right before the first pass writing the target
+            VkImageMemoryBarrier discardBarrier;
+            discardBarrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            discardBarrier.pNext                           = nullptr;
+            discardBarrier.srcAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            discardBarrier.dstAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            discardBarrier.oldLayout                       = VK_IMAGE_LAYOUT_UNDEFINED;
+            discardBarrier.newLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            discardBarrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+            discardBarrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+            discardBarrier.image                           = image;
+            discardBarrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            discardBarrier.subresourceRange.baseMipLevel   = 0;
+            discardBarrier.subresourceRange.levelCount     = texture.levels;
+            discardBarrier.subresourceRange.baseArrayLayer = 0;
+            discardBarrier.subresourceRange.layerCount     = 1;
+            renderTargetDiscards[lifetime->second.firstPass].push_back(discardBarrier);
+        }
+        renderTargetBlocks = pRenderTargetPool->bindRenderTargets(pooledTargets);
 
         for (size_t i = 0; i < module.textures.size(); i++)
         {
@@ -123,21 +160,29 @@ namespace vkBasalt
             }
             VkExtent3D textureExtent = {module.textures[i].width, module.textures[i].height, 1};
             // TODO handle mip map levels correctly
-            // TODO handle pooled textures better
             if (const auto source = std::find_if(
                     module.textures[i].annotations.begin(), module.textures[i].annotations.end(), [](const auto& a) { return a.name == "source"; });
                 source == module.textures[i].annotations.end())
             {
-                textureMemory.push_back(VK_NULL_HANDLE);
-                std::vector<VkImage> images = createImages(pLogicalDevice,
-                                                           1,
-                                                           textureExtent,
-                                                           convertReshadeFormat(module.textures[i].format),
-                                                           VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
-                                                               | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-                                                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                                           textureMemory.back(),
-                                                           module.textures[i].levels);
+                auto                 pooled = pooledImages.find(module.textures[i].unique_name);
+                std::vector<VkImage> images;
+                if (pooled != pooledImages.end())
+                {
+                    images = {pooled->second};
+                }
+                else
+                {
+                    textureMemory.push_back(VK_NULL_HANDLE);
+                    images = createImages(pLogicalDevice,
+                                          1,
+                                          textureExtent,
+                                          convertReshadeFormat(module.textures[i].format),
+                                          VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+                                              | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                          textureMemory.back(),
+                                          module.textures[i].levels);
+                }
 
                 textureImages[module.textures[i].unique_name] = images;
                 std::vector<VkImageView> imageViewsUNORM =
@@ -180,7 +225,9 @@ namespace vkBasalt
 
                 textureFormatsUNORM[module.textures[i].unique_name] = convertToUNORM(convertReshadeFormat(module.textures[i].format));
                 textureFormatsSRGB[module.textures[i].unique_name]  = convertToSRGB(convertReshadeFormat(module.textures[i].format));
-                changeImageLayout(pLogicalDevice, images, module.textures[i].levels);
+                // Pooled memory may be in use by a frame in flight, those get their layout from renderTargetDiscards
+                if (pooled == pooledImages.end())
+                    changeImageLayout(pLogicalDevice, images, module.textures[i].levels);
                 continue;
             }
             else
@@ -225,83 +272,9 @@ namespace vkBasalt
                 textureFormatsUNORM[module.textures[i].unique_name] = convertToUNORM(convertReshadeFormat(module.textures[i].format));
                 textureFormatsSRGB[module.textures[i].unique_name]  = convertToSRGB(convertReshadeFormat(module.textures[i].format));
 
-                int desiredChannels;
-                switch (textureFormatsUNORM[module.textures[i].unique_name])
-                {
-                    case VK_FORMAT_R8_UNORM: desiredChannels = STBI_grey; break;
-                    case VK_FORMAT_R8G8_UNORM:
-                        desiredChannels = STBI_rgb_alpha; // TODO why doesn't STBI_grey_alpha work?
-                        break;
-                    case VK_FORMAT_R8G8B8A8_UNORM: desiredChannels = STBI_rgb_alpha; break;
-                    case VK_FORMAT_R8G8B8A8_SRGB: desiredChannels = STBI_rgb_alpha; break;
-                    default:
-                        Logger::err("unsupported texture upload format" + std::to_string(textureFormatsUNORM[module.textures[i].unique_name]));
-                        desiredChannels = 4;
-                        break;
-                }
-
-                // Search for texture in discovered paths from shader manager
-                std::string textureName = source->value.string_data;
-                std::string filePath;
-                FILE* file = nullptr;
-
-                ShaderManagerConfig shaderMgrConfig = ConfigSerializer::loadShaderManagerConfig();
-                for (const auto& texPath : shaderMgrConfig.discoveredTexturePaths)
-                {
-                    filePath = texPath + "/" + textureName;
-                    file = fopen(filePath.c_str(), "rb");
-                    if (file != nullptr)
-                        break;
-                }
-
-                stbi_uc*             pixels;
-                std::vector<stbi_uc> resizedPixels;
-                uint32_t             size;
-                int                  width;
-                int                  height;
-
-                size = textureExtent.width * textureExtent.height * desiredChannels;
-
-                if (file == nullptr)
-                {
-                    Logger::err("couldn't open texture: " + textureName + " (searched " +
-                        std::to_string(shaderMgrConfig.discoveredTexturePaths.size()) + " directories)");
-                }
-                if (stbi_dds_test_file(file))
-                {
-                    int channels;
-                    pixels = stbi_dds_load_from_file(file, &width, &height, &channels, desiredChannels);
-                }
-                else
-                {
-                    int channels;
-                    pixels = stbi_load_from_file(file, &width, &height, &channels, desiredChannels);
-                }
-
-                // change RGBA to RG
-                if (textureFormatsUNORM[module.textures[i].unique_name] == VK_FORMAT_R8G8_UNORM)
-                {
-                    uint32_t pos = 0;
-                    for (uint32_t j = 0; j < size; j += 4)
-                    {
-                        pixels[pos] = pixels[j];
-                        pos++;
-                        pixels[pos] = pixels[j + 1];
-                        pos++;
-                    }
-                    size /= 2;
-                    desiredChannels /= 2;
-                }
-
-                if (static_cast<uint32_t>(width) != textureExtent.width || static_cast<uint32_t>(height) != textureExtent.height)
-                {
-                    resizedPixels.resize(size);
-                    stbir_resize_uint8(pixels, width, height, 0, resizedPixels.data(), textureExtent.width, textureExtent.height, 0, desiredChannels);
-                }
-
-                uploadToImage(
-                    pLogicalDevice, images[0], textureExtent, size, resizedPixels.size() ? resizedPixels.data() : pixels, module.textures[i].levels);
-                stbi_image_free(pixels);
+                // Decoded together with the compile (see loadReshadeTextures), only the upload is left
+                const ReshadeTextureData& texture = compiledEffect->textures.at(module.textures[i].unique_name);
+                uploadToImage(pLogicalDevice, images[0], textureExtent, texture.pixels.size(), texture.pixels.data(), module.textures[i].levels);
             }
         }
 
@@ -312,50 +285,27 @@ namespace vkBasalt
             VkSampler sampler = createReshadeSampler(pLogicalDevice, info);
 
             samplers.push_back(sampler);
-
-            imageViewVector.push_back(info.srgb ? textureImageViewsSRGB[info.texture_name] : textureImageViewsUNORM[info.texture_name]);
         }
 
         imageSamplerDescriptorSetLayout = createImageSamplerDescriptorSetLayout(pLogicalDevice, module.samplers.size());
         uniformDescriptorSetLayout      = createUniformBufferDescriptorSetLayout(pLogicalDevice);
         Logger::debug("created descriptorSetLayouts");
 
-        VkDescriptorPoolSize imagePoolSize;
-        imagePoolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        imagePoolSize.descriptorCount = inputImages.size() * module.samplers.size() * 3;
-
-        VkDescriptorPoolSize bufferPoolSize;
-        bufferPoolSize.type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        bufferPoolSize.descriptorCount = 3;
-
-        std::vector<VkDescriptorPoolSize> poolSizes = {imagePoolSize, bufferPoolSize};
-
-        descriptorPool = createDescriptorPool(pLogicalDevice, poolSizes);
-        Logger::debug("created descriptorPool");
-
         std::vector<VkDescriptorSetLayout> descriptorSetLayouts = {uniformDescriptorSetLayout, imageSamplerDescriptorSetLayout};
 
         pipelineLayout = createGraphicsPipelineLayout(pLogicalDevice, descriptorSetLayouts);
 
         Logger::debug("created Pipeline layout");
 
-        Logger::debug("output writes: " + std::to_string(outputWrites));
-        if (bufferSize)
-        {
-            bufferDescriptorSet = writeBufferDescriptorSet(pLogicalDevice, descriptorPool, uniformDescriptorSetLayout, stagingBuffer);
-        }
-
-        inputDescriptorSets =
-            allocateAndWriteImageSamplerDescriptorSets(pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, samplers, imageViewVector);
-
-        // count the back buffer writes
-        for (auto& pass : module.techniques[0].passes)
+        // count the back buffer writes of all techniques, applyEffect flips between the images for the enabled ones
+        for (auto& pass : passes)
         {
             if (pass.render_target_names[0] == "")
             {
                 outputWrites++;
             }
         }
+        Logger::debug("output writes: " + std::to_string(outputWrites));
 
         // if there is only one outputWrite, we can directly write to outputImages
         if (outputWrites > 1)
@@ -371,27 +321,21 @@ namespace vkBasalt
 
             backBufferImageViewsSRGB  = createImageViews(pLogicalDevice, inputOutputFormatSRGB, backBufferImages);
             backBufferImageViewsUNORM = createImageViews(pLogicalDevice, inputOutputFormatUNORM, backBufferImages);
-
-            std::replace(imageViewVector.begin(), imageViewVector.end(), inputImageViewsSRGB, backBufferImageViewsSRGB);
-            std::replace(imageViewVector.begin(), imageViewVector.end(), inputImageViewsUNORM, backBufferImageViewsUNORM);
-
-            backBufferDescriptorSets = allocateAndWriteImageSamplerDescriptorSets(
-                pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, samplers, imageViewVector);
-        }
-        if (outputWrites > 2)
-        {
-            std::replace(imageViewVector.begin(), imageViewVector.end(), backBufferImageViewsSRGB, outputImageViewsSRGB);
-            std::replace(imageViewVector.begin(), imageViewVector.end(), backBufferImageViewsUNORM, outputImageViewsUNORM);
-            outputDescriptorSets = allocateAndWriteImageSamplerDescriptorSets(
-                pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, samplers, imageViewVector);
         }
 
+        createImageSamplerDescriptorSets();
+
         Logger::debug("after writing ImageSamplerDescriptorSets");
 
         bool firstTimeStencilAccess = true; // Used to clear the sttencil attachment on the first time
 
-        for (bool outputToBackBuffer = outputWrites % 2 == 0; auto& pass : module.techniques[0].passes)
+        for (size_t passIndex = 0; passIndex < passes.size(); passIndex++)
         {
+            const auto& pass = passes[passIndex];
+            // Like ReShade, every technique starts with a cleared stencil
+            if (passIndex == 0 || passTechniques[passIndex] != passTechniques[passIndex - 1])
+                firstTimeStencilAccess = true;
+
             std::vector<VkAttachmentReference>               attachmentReferences;
             std::vector<VkAttachmentDescription>             attachmentDescriptions;
             std::vector<VkPipelineColorBlendAttachmentState> attachmentBlendStates;
@@ -459,6 +403,16 @@ namespace vkBasalt
 
             renderTargets.push_back(currentRenderTargets);
 
+            // Render targets with a semantic are views of the chain images
+            for (const auto& target : currentRenderTargets)
+            {
+                for (const auto& texture : module.textures)
+                {
+                    if (texture.unique_name == target && !texture.semantic.empty())
+                        rendersToChainImages = true;
+                }
+            }
+
             VkRect2D scissor;
             scissor.offset        = {0, 0};
             scissor.extent.width  = pass.viewport_width ? pass.viewport_width : imageExtent.width;
@@ -476,9 +430,13 @@ namespace vkBasalt
 
             uint32_t depthAttachmentCount = 0;
 
-            if (scissor.extent.width == imageExtent.width && scissor.extent.height == imageExtent.height)
+            // Only passes with stencil state get the shared stencil attachment, the others leave it untouched anyway
+            VkImageView stencilImageView = VK_NULL_HANDLE;
+            if (pass.stencil_enable && scissor.extent.width == imageExtent.width && scissor.extent.height == imageExtent.height)
             {
                 depthAttachmentCount = 1;
+                usesStencil          = true;
+                stencilImageView     = pStencilAttachment->getImageView();
 
                 attachmentImageViews.push_back(std::vector<VkImageView>(inputImages.size(), stencilImageView));
 
@@ -490,7 +448,7 @@ namespace vkBasalt
 
                 VkAttachmentDescription attachmentDescription;
                 attachmentDescription.flags          = 0;
-                attachmentDescription.format         = stencilFormat;
+                attachmentDescription.format         = pStencilAttachment->format;
                 attachmentDescription.samples        = VK_SAMPLE_COUNT_1_BIT;
                 attachmentDescription.loadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
                 attachmentDescription.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -504,75 +462,109 @@ namespace vkBasalt
                 attachmentDescriptions.push_back(attachmentDescription);
             }
 
-            // renderpass
-
-            VkSubpassDescription subpassDescription;
-            subpassDescription.flags                   = 0;
-            subpassDescription.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-            subpassDescription.inputAttachmentCount    = 0;
-            subpassDescription.pInputAttachments       = nullptr;
-            subpassDescription.colorAttachmentCount    = attachmentReferences.size() - depthAttachmentCount;
-            subpassDescription.pColorAttachments       = attachmentReferences.data();
-            subpassDescription.pResolveAttachments     = nullptr;
-            subpassDescription.pDepthStencilAttachment = depthAttachmentCount ? &attachmentReferences.back() : nullptr;
-            subpassDescription.preserveAttachmentCount = 0;
-            subpassDescription.pPreserveAttachments    = nullptr;
-
-            VkSubpassDependency subpassDependency;
-            subpassDependency.srcSubpass      = VK_SUBPASS_EXTERNAL;
-            subpassDependency.dstSubpass      = 0;
-            subpassDependency.srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            subpassDependency.dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            subpassDependency.srcAccessMask   = 0;
-            subpassDependency.dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            subpassDependency.dependencyFlags = 0;
-
-            VkRenderPassCreateInfo renderPassCreateInfo;
-            renderPassCreateInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-            renderPassCreateInfo.pNext           = nullptr;
-            renderPassCreateInfo.flags           = 0;
-            renderPassCreateInfo.attachmentCount = attachmentDescriptions.size();
-            renderPassCreateInfo.pAttachments    = attachmentDescriptions.data();
-            renderPassCreateInfo.subpassCount    = 1;
-            renderPassCreateInfo.pSubpasses      = &subpassDescription;
-            renderPassCreateInfo.dependencyCount = 1;
-            renderPassCreateInfo.pDependencies   = &subpassDependency;
-
-            VkRenderPass renderPass;
-            VkResult     result = pLogicalDevice->vkd.CreateRenderPass(pLogicalDevice->device, &renderPassCreateInfo, nullptr, &renderPass);
-            ASSERT_VULKAN(result);
-            renderPasses.push_back(renderPass);
+            switchSamplers.push_back(pass.render_target_names[0] == "");
+            passSrgbWrites.push_back(pass.srgb_write_enable);
+            passStencilViews.push_back(stencilImageView);
 
-            VkRenderPassBeginInfo renderPassBeginInfo;
-            renderPassBeginInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderPassBeginInfo.pNext           = nullptr;
-            renderPassBeginInfo.renderPass      = renderPass;
-            renderPassBeginInfo.framebuffer     = VK_NULL_HANDLE; // changed at apply time
-            renderPassBeginInfo.renderArea      = scissor;
-            renderPassBeginInfo.clearValueCount = attachmentDescriptions.size();
-            VkClearValue clearValues[9]         = {};
-            renderPassBeginInfo.pClearValues    = clearValues;
+            uint32_t              colorAttachmentCount = attachmentReferences.size() - depthAttachmentCount;
+            std::vector<VkFormat> colorFormats;
+            for (uint32_t a = 0; a < colorAttachmentCount; a++)
+                colorFormats.push_back(attachmentDescriptions[a].format);
 
-            renderPassBeginInfos.push_back(renderPassBeginInfo);
-
-            // framebuffers
-
-            if (pass.render_target_names[0] == "")
+            VkRenderPass renderPass = VK_NULL_HANDLE;
+            VkResult     result;
+            if (useDynamicRendering)
             {
-                std::vector<VkImageView> backBufferImageViews = pass.srgb_write_enable ? backBufferImageViewsSRGB : backBufferImageViewsUNORM;
-                std::vector<VkImageView> outputImageViews     = pass.srgb_write_enable ? outputImageViewsSRGB : outputImageViewsUNORM;
-                framebuffers.push_back(createFramebuffers(
-                    pLogicalDevice,
-                    renderPass,
-                    imageExtent,
-                    {outputToBackBuffer ? backBufferImageViews : outputImageViews, std::vector<VkImageView>(inputImages.size(), stencilImageView)}));
-                outputToBackBuffer = !outputToBackBuffer;
-                switchSamplers.push_back(true);
+                // The attachments are given when recording (see beginDynamicPass), nothing to create per pass or image
+                DynamicPass dynamicPass;
+                dynamicPass.colorViews.assign(attachmentImageViews.begin(), attachmentImageViews.begin() + colorAttachmentCount);
+                for (uint32_t a = 0; a < colorAttachmentCount; a++)
+                {
+                    std::string target = pass.render_target_names[a];
+                    dynamicPass.colorImages.push_back(target == "" ? VK_NULL_HANDLE : textureImages[target][0]);
+                    dynamicPass.loadOps.push_back(attachmentDescriptions[a].loadOp);
+                }
+                dynamicPass.backBuffer    = pass.render_target_names[0] == "";
+                dynamicPass.srgb          = pass.srgb_write_enable;
+                dynamicPass.stencilView   = stencilImageView;
+                dynamicPass.stencilLoadOp = depthAttachmentCount ? attachmentDescriptions.back().stencilLoadOp : VK_ATTACHMENT_LOAD_OP_LOAD;
+                dynamicPass.renderArea    = scissor;
+                dynamicPasses.push_back(dynamicPass);
             }
             else
             {
-                framebuffers.push_back(createFramebuffers(pLogicalDevice, renderPass, scissor.extent, attachmentImageViews));
-                switchSamplers.push_back(false);
+                // renderpass
+
+                VkSubpassDescription subpassDescription;
+                subpassDescription.flags                   = 0;
+                subpassDescription.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+                subpassDescription.inputAttachmentCount    = 0;
+                subpassDescription.pInputAttachments       = nullptr;
+                subpassDescription.colorAttachmentCount    = attachmentReferences.size() - depthAttachmentCount;
+                subpassDescription.pColorAttachments       = attachmentReferences.data();
+                subpassDescription.pResolveAttachments     = nullptr;
+                subpassDescription.pDepthStencilAttachment = depthAttachmentCount ? &attachmentReferences.back() : nullptr;
+                subpassDescription.preserveAttachmentCount = 0;
+                subpassDescription.pPreserveAttachments    = nullptr;
+
+                VkSubpassDependency subpassDependency;
+                subpassDependency.srcSubpass      = VK_SUBPASS_EXTERNAL;
+                subpassDependency.dstSubpass      = 0;
+                subpassDependency.srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                subpassDependency.dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                subpassDependency.srcAccessMask   = 0;
+                subpassDependency.dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+                subpassDependency.dependencyFlags = 0;
+
+                VkRenderPassCreateInfo renderPassCreateInfo;
+                renderPassCreateInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+                renderPassCreateInfo.pNext           = nullptr;
+                renderPassCreateInfo.flags           = 0;
+                renderPassCreateInfo.attachmentCount = attachmentDescriptions.size();
+                renderPassCreateInfo.pAttachments    = attachmentDescriptions.data();
+                renderPassCreateInfo.subpassCount    = 1;
+                renderPassCreateInfo.pSubpasses      = &subpassDescription;
+                renderPassCreateInfo.dependencyCount = 1;
+                renderPassCreateInfo.pDependencies   = &subpassDependency;
+
+                result = pLogicalDevice->vkd.CreateRenderPass(pLogicalDevice->device, &renderPassCreateInfo, nullptr, &renderPass);
+                ASSERT_VULKAN(result);
+                renderPasses.push_back(renderPass);
+
+                VkRenderPassBeginInfo renderPassBeginInfo;
+                renderPassBeginInfo.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                renderPassBeginInfo.pNext           = nullptr;
+                renderPassBeginInfo.renderPass      = renderPass;
+                renderPassBeginInfo.framebuffer     = VK_NULL_HANDLE; // changed at apply time
+                renderPassBeginInfo.renderArea      = scissor;
+                renderPassBeginInfo.clearValueCount = attachmentDescriptions.size();
+                VkClearValue clearValues[9]         = {};
+                renderPassBeginInfo.pClearValues    = clearValues;
+
+                renderPassBeginInfos.push_back(renderPassBeginInfo);
+
+                // framebuffers
+
+                if (pass.render_target_names[0] == "")
+                {
+                    // Whether the pass writes the back buffer or the output depends on the writes of the enabled techniques
+                    framebuffers.push_back(createOutputFramebuffers(passIndex));
+
+                    backBufferFramebuffers.emplace_back();
+                    if (outputWrites > 1)
+                    {
+                        std::vector<std::vector<VkImageView>> framebufferImageViews = {
+                            pass.srgb_write_enable ? backBufferImageViewsSRGB : backBufferImageViewsUNORM};
+                        if (depthAttachmentCount)
+                            framebufferImageViews.push_back(std::vector<VkImageView>(inputImages.size(), stencilImageView));
+                        backBufferFramebuffers.back() = createFramebuffers(pLogicalDevice, renderPass, imageExtent, framebufferImageViews);
+                    }
+                }
+                else
+                {
+                    framebuffers.push_back(createFramebuffers(pLogicalDevice, renderPass, scissor.extent, attachmentImageViews));
+                    backBufferFramebuffers.emplace_back();
+                }
             }
 
             // pipeline
@@ -830,9 +822,18 @@ namespace vkBasalt
             depthStencilStateCreateInfo.minDepthBounds        = 0.0f;
             depthStencilStateCreateInfo.maxDepthBounds        = 1.0f;
 
+            VkPipelineRenderingCreateInfo renderingCreateInfo;
+            renderingCreateInfo.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+            renderingCreateInfo.pNext                   = nullptr;
+            renderingCreateInfo.viewMask                = 0;
+            renderingCreateInfo.colorAttachmentCount    = colorFormats.size();
+            renderingCreateInfo.pColorAttachmentFormats = colorFormats.data();
+            renderingCreateInfo.depthAttachmentFormat   = VK_FORMAT_UNDEFINED;
+            renderingCreateInfo.stencilAttachmentFormat = depthAttachmentCount ? pStencilAttachment->format : VK_FORMAT_UNDEFINED;
+
             VkGraphicsPipelineCreateInfo pipelineCreateInfo;
             pipelineCreateInfo.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-            pipelineCreateInfo.pNext               = nullptr;
+            pipelineCreateInfo.pNext               = useDynamicRendering ? &renderingCreateInfo : nullptr;
             pipelineCreateInfo.flags               = 0;
             pipelineCreateInfo.stageCount          = 2;
             pipelineCreateInfo.pStages             = shaderStages;
@@ -852,7 +853,7 @@ namespace vkBasalt
             pipelineCreateInfo.basePipelineIndex   = -1;
 
             VkPipeline pipeline;
-            result = pLogicalDevice->vkd.CreateGraphicsPipelines(pLogicalDevice->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &pipeline);
+            result = pLogicalDevice->vkd.CreateGraphicsPipelines(pLogicalDevice->device, pLogicalDevice->pipelineCache, 1, &pipelineCreateInfo, nullptr, &pipeline);
             ASSERT_VULKAN(result);
 
             graphicsPipelines.push_back(pipeline);
@@ -860,22 +861,143 @@ namespace vkBasalt
             Logger::debug("vertex   entry: " + pass.vs_entry_point);
             Logger::debug("fragment entry: " + pass.ps_entry_point);
         }
+
+        resolveTechniques();
         Logger::debug("finished creating Reshade effect");
     }
 
-    void ReshadeEffect::updateEffect()
+    bool ReshadeEffect::rebindImages(const std::vector<VkImage>& inputImages, const std::vector<VkImage>& outputImages)
     {
-        if (bufferSize)
+        // Their views are also attachments of the passes rendering to them, those are not rebuilt here
+        if (rendersToChainImages)
+            return false;
+
+        // Only the input and output views, the image sampler sets and the framebuffers of the passes writing the output
+        // depend on the images. Frames in flight may still use the old ones, so they get new handles and the old ones are retired
+        LogicalDevice*             pDevice           = pLogicalDevice;
+        std::vector<VkFramebuffer> oldFramebuffers;
+        std::vector<VkImageView>   oldImageViews     = inputImageViewsSRGB;
+        VkDescriptorPool           oldDescriptorPool = descriptorPool;
+        for (size_t i = 0; i < framebuffers.size(); i++)
         {
-            void*    data;
-            VkResult result = pLogicalDevice->vkd.MapMemory(pLogicalDevice->device, stagingBufferMemory, 0, bufferSize, 0, &data);
-            ASSERT_VULKAN(result);
-            for (auto& uniform : uniforms)
-            {
-                uniform->update(data);
-            }
-            pLogicalDevice->vkd.UnmapMemory(pLogicalDevice->device, stagingBufferMemory);
+            if (switchSamplers[i])
+                oldFramebuffers.insert(oldFramebuffers.end(), framebuffers[i].begin(), framebuffers[i].end());
         }
+        for (const auto* views : {&inputImageViewsUNORM, &outputImageViewsSRGB, &outputImageViewsUNORM})
+            oldImageViews.insert(oldImageViews.end(), views->begin(), views->end());
+        retireResources(pLogicalDevice, [pDevice, oldFramebuffers, oldImageViews, oldDescriptorPool]() {
+            for (auto framebuffer : oldFramebuffers)
+                pDevice->vkd.DestroyFramebuffer(pDevice->device, framebuffer, nullptr);
+            for (auto imageView : oldImageViews)
+                pDevice->vkd.DestroyImageView(pDevice->device, imageView, nullptr);
+            pDevice->vkd.DestroyDescriptorPool(pDevice->device, oldDescriptorPool, nullptr);
+        });
+
+        this->inputImages  = inputImages;
+        this->outputImages = outputImages;
+
+        inputImageViewsSRGB   = createImageViews(pLogicalDevice, inputOutputFormatSRGB, inputImages);
+        inputImageViewsUNORM  = createImageViews(pLogicalDevice, inputOutputFormatUNORM, inputImages);
+        outputImageViewsSRGB  = createImageViews(pLogicalDevice, inputOutputFormatSRGB, outputImages);
+        outputImageViewsUNORM = createImageViews(pLogicalDevice, inputOutputFormatUNORM, outputImages);
+
+        // The color and depth textures are the input until the depth image is set when recording (see useDepthImage)
+        for (const auto& texture : module.textures)
+        {
+            if (texture.semantic != "COLOR" && texture.semantic != "DEPTH")
+                continue;
+            textureImageViewsUNORM[texture.unique_name] = inputImageViewsUNORM;
+            renderImageViewsUNORM[texture.unique_name]  = inputImageViewsUNORM;
+            textureImageViewsSRGB[texture.unique_name]  = inputImageViewsSRGB;
+            renderImageViewsSRGB[texture.unique_name]   = inputImageViewsSRGB;
+        }
+
+        createImageSamplerDescriptorSets();
+        for (size_t i = 0; i < framebuffers.size(); i++)
+        {
+            if (switchSamplers[i])
+                framebuffers[i] = createOutputFramebuffers(i);
+        }
+        return true;
+    }
+
+    // One set per image index for each image the back buffer is read from: the input, the back buffer and the output
+    void ReshadeEffect::createImageSamplerDescriptorSets()
+    {
+        // Uniform sets come from the uniform ring's own pool, this one only holds the image sets.
+        // createDescriptorPool sizes maxSets from the descriptor count, so reserve at least one
+        // descriptor per set even if the effect has no samplers.
+        VkDescriptorPoolSize imagePoolSize;
+        imagePoolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        imagePoolSize.descriptorCount = inputImages.size() * std::max<size_t>(module.samplers.size(), 1) * 3;
+
+        std::vector<VkDescriptorPoolSize> poolSizes = {imagePoolSize};
+
+        descriptorPool = createDescriptorPool(pLogicalDevice, poolSizes);
+        Logger::debug("created descriptorPool");
+
+        std::vector<std::vector<VkImageView>> imageViewVector;
+        for (const auto& info : module.samplers)
+            imageViewVector.push_back(info.srgb ? textureImageViewsSRGB[info.texture_name] : textureImageViewsUNORM[info.texture_name]);
+
+        inputDescriptorSets =
+            allocateAndWriteImageSamplerDescriptorSets(pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, samplers, imageViewVector);
+
+        if (outputWrites > 1)
+        {
+            std::replace(imageViewVector.begin(), imageViewVector.end(), inputImageViewsSRGB, backBufferImageViewsSRGB);
+            std::replace(imageViewVector.begin(), imageViewVector.end(), inputImageViewsUNORM, backBufferImageViewsUNORM);
+
+            backBufferDescriptorSets = allocateAndWriteImageSamplerDescriptorSets(
+                pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, samplers, imageViewVector);
+        }
+        if (outputWrites > 2)
+        {
+            std::replace(imageViewVector.begin(), imageViewVector.end(), backBufferImageViewsSRGB, outputImageViewsSRGB);
+            std::replace(imageViewVector.begin(), imageViewVector.end(), backBufferImageViewsUNORM, outputImageViewsUNORM);
+            outputDescriptorSets = allocateAndWriteImageSamplerDescriptorSets(
+                pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, samplers, imageViewVector);
+        }
+    }
+
+    // Framebuffers of a pass writing the back buffer for when it writes the output
+    std::vector<VkFramebuffer> ReshadeEffect::createOutputFramebuffers(size_t passIndex)
+    {
+        std::vector<std::vector<VkImageView>> framebufferImageViews = {passSrgbWrites[passIndex] ? outputImageViewsSRGB : outputImageViewsUNORM};
+        if (passStencilViews[passIndex])
+            framebufferImageViews.push_back(std::vector<VkImageView>(outputImages.size(), passStencilViews[passIndex]));
+        return createFramebuffers(pLogicalDevice, renderPasses[passIndex], imageExtent, framebufferImageViews);
+    }
+
+    void ReshadeEffect::updateEffect(uint32_t imageIndex, const FrameContext& frame)
+    {
+        if (!pUniformRing)
+            return;
+        // The ring is host coherent and stays mapped, the submit makes the writes visible
+        uint8_t* data = pUniformRing->mapped + imageIndex * pUniformRing->sliceSize + uniformOffset;
+
+        // Parameters only change while the overlay can edit them, the slice keeps them otherwise
+        uint64_t parameterGeneration = pEffectRegistry->getParameterGeneration();
+        if (sliceGenerations[imageIndex] != parameterGeneration)
+        {
+            uniforms.updateOnChange(data, frame);
+            sliceGenerations[imageIndex] = parameterGeneration;
+        }
+        uniforms.updatePerFrame(data, frame);
+    }
+
+    uint32_t ReshadeEffect::getUniformSize() const
+    {
+        return bufferSize;
+    }
+
+    void ReshadeEffect::useUniformRing(UniformRing* pUniformRing, VkDescriptorSet descriptorSet, VkDeviceSize offset)
+    {
+        this->pUniformRing  = pUniformRing;
+        bufferDescriptorSet = descriptorSet;
+        uniformOffset       = offset;
+        // A new ring has nothing written yet
+        sliceGenerations.assign(pUniformRing->sliceSubmits.size(), UINT64_MAX);
     }
 
     void ReshadeEffect::useDepthImage(VkImageView depthImageView)
@@ -935,20 +1057,54 @@ namespace vkBasalt
             }
         }
     }
+
+    // Look up which techniques run, once per change in the registry instead of on every recorded command buffer
+    void ReshadeEffect::resolveTechniques()
+    {
+        techniqueGeneration = pEffectRegistry->getTechniqueGeneration();
+
+        // Techniques the registry doesn't know (yet) keep their default
+        std::vector<TechniqueState> techniques = extractTechniques(module);
+        for (const auto& state : pEffectRegistry->getTechniques(effectName))
+        {
+            for (auto& technique : techniques)
+            {
+                if (technique.name == state.name)
+                    technique.enabled = state.enabled;
+            }
+        }
+
+        techniquesEnabled.clear();
+        for (const auto& technique : techniques)
+            techniquesEnabled.push_back(technique.enabled);
+
+        enabledWrites = 0;
+        for (size_t i = 0; i < passTechniques.size(); i++)
+        {
+            if (techniquesEnabled[passTechniques[i]] && switchSamplers[i])
+                enabledWrites++;
+        }
+    }
+
     void ReshadeEffect::applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer)
     {
         Logger::debug("applying ReshadeEffect to command buffer" + convertToString(commandBuffer));
-        // Used to make the Image accessable by the shader
+
+        // Switching a technique keeps the effect and only records it again
+        if (pEffectRegistry->getTechniqueGeneration() != techniqueGeneration)
+            resolveTechniques();
+
+        // The chain images are transitioned by recordEffectChain, only the internal ones are handled here
         VkImageMemoryBarrier memoryBarrier;
         memoryBarrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         memoryBarrier.pNext               = nullptr;
-        memoryBarrier.srcAccessMask       = VK_ACCESS_MEMORY_WRITE_BIT;
-        memoryBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-        memoryBarrier.oldLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        memoryBarrier.srcAccessMask       = 0;
+        memoryBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        memoryBarrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
         memoryBarrier.newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         memoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         memoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        memoryBarrier.image               = inputImages[imageIndex];
+        memoryBarrier.image               = VK_NULL_HANDLE;
 
         memoryBarrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
         memoryBarrier.subresourceRange.baseMipLevel   = 0;
@@ -956,37 +1112,12 @@ namespace vkBasalt
         memoryBarrier.subresourceRange.baseArrayLayer = 0;
         memoryBarrier.subresourceRange.layerCount     = 1;
 
-        // Reverses the first Barrier
-        VkImageMemoryBarrier secondBarrier;
-        secondBarrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        secondBarrier.pNext               = nullptr;
-        secondBarrier.srcAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-        secondBarrier.dstAccessMask       = 0;
-        secondBarrier.oldLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        secondBarrier.newLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        secondBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        secondBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        secondBarrier.image               = inputImages[imageIndex];
-
-        secondBarrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        secondBarrier.subresourceRange.baseMipLevel   = 0;
-        secondBarrier.subresourceRange.levelCount     = 1;
-        secondBarrier.subresourceRange.baseArrayLayer = 0;
-        secondBarrier.subresourceRange.layerCount     = 1;
-
-        pLogicalDevice->vkd.CmdPipelineBarrier(
-            commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
-        memoryBarrier.image     = outputImages[imageIndex];
-        memoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        memoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        pLogicalDevice->vkd.CmdPipelineBarrier(
-            commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
-        if (outputWrites > 1)
+        if (enabledWrites > 1)
         {
             memoryBarrier.image = backBufferImages[imageIndex];
             pLogicalDevice->vkd.CmdPipelineBarrier(commandBuffer,
-                                                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                                   VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
                                                    0,
                                                    0,
                                                    nullptr,
@@ -996,24 +1127,20 @@ namespace vkBasalt
                                                    &memoryBarrier);
         }
 
-        // stencil image
-        memoryBarrier.image                       = stencilImage;
-        memoryBarrier.srcAccessMask               = 0;
-        memoryBarrier.dstAccessMask               = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        memoryBarrier.oldLayout                   = VK_IMAGE_LAYOUT_UNDEFINED;
-        memoryBarrier.newLayout                   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-        memoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT | VK_IMAGE_ASPECT_DEPTH_BIT;
-
-        pLogicalDevice->vkd.CmdPipelineBarrier(commandBuffer,
-                                               VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                                               VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-                                               0,
-                                               0,
-                                               nullptr,
-                                               0,
-                                               nullptr,
-                                               1,
-                                               &memoryBarrier);
+        // The shared stencil image, the previous effect using it must be done (its content is cleared by our first pass)
+        if (usesStencil)
+        {
+            memoryBarrier.image                       = pStencilAttachment->image;
+            memoryBarrier.srcAccessMask               = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            memoryBarrier.dstAccessMask               = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            memoryBarrier.oldLayout                   = VK_IMAGE_LAYOUT_UNDEFINED;
+            memoryBarrier.newLayout                   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            memoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT | VK_IMAGE_ASPECT_DEPTH_BIT;
+
+            VkPipelineStageFlags fragmentTests = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            pLogicalDevice->vkd.CmdPipelineBarrier(
+                commandBuffer, fragmentTests, fragmentTests, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
+        }
 
         Logger::debug("after the first pipeline barrier");
 
@@ -1021,39 +1148,76 @@ namespace vkBasalt
             commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &(inputDescriptorSets[imageIndex]), 0, nullptr);
         Logger::debug("after binding image sampler");
 
-        if (bufferSize)
+        if (pUniformRing)
         {
+            uint32_t dynamicOffset = imageIndex * pUniformRing->sliceSize + uniformOffset;
             pLogicalDevice->vkd.CmdBindDescriptorSets(
-                commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &bufferDescriptorSet, 0, nullptr);
+                commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &bufferDescriptorSet, 1, &dynamicOffset);
             Logger::debug("after binding uniform buffer");
         }
 
-        bool backBufferNext = outputWrites % 2 == 0;
+        // Nothing writes the output, it still has to get the input
+        if (enabledWrites == 0)
+            copyInputToOutput(imageIndex, commandBuffer);
+
+        bool backBufferNext = enabledWrites % 2 == 0;
         for (size_t i = 0; i < graphicsPipelines.size(); i++)
         {
-            renderPassBeginInfos[i].framebuffer = framebuffers[i][imageIndex];
+            bool passEnabled  = techniquesEnabled[passTechniques[i]];
+            bool toBackBuffer = switchSamplers[i] && backBufferNext && enabledWrites > 1;
+
+            // Also for skipped passes, so later passes never see pooled memory in an undefined layout
+            if (!renderTargetDiscards[i].empty())
+            {
+                pLogicalDevice->vkd.CmdPipelineBarrier(commandBuffer,
+                                                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                                                           | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                                       0,
+                                                       0,
+                                                       nullptr,
+                                                       0,
+                                                       nullptr,
+                                                       renderTargetDiscards[i].size(),
+                                                       renderTargetDiscards[i].data());
+            }
+
+            if (!passEnabled)
+                continue;
 
             Logger::debug("before beginn renderpass");
-            pLogicalDevice->vkd.CmdBeginRenderPass(commandBuffer, &renderPassBeginInfos[i], VK_SUBPASS_CONTENTS_INLINE);
+            std::vector<VkImageMemoryBarrier> attachmentBarriers;
+            if (useDynamicRendering)
+            {
+                attachmentBarriers = beginDynamicPass(i, imageIndex, toBackBuffer, commandBuffer);
+            }
+            else
+            {
+                renderPassBeginInfos[i].framebuffer = toBackBuffer ? backBufferFramebuffers[i][imageIndex] : framebuffers[i][imageIndex];
+                pLogicalDevice->vkd.CmdBeginRenderPass(commandBuffer, &renderPassBeginInfos[i], VK_SUBPASS_CONTENTS_INLINE);
+            }
             Logger::debug("after beginn renderpass");
 
             pLogicalDevice->vkd.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelines[i]);
             Logger::debug("after bind pipeliene");
 
-            pLogicalDevice->vkd.CmdDraw(commandBuffer, module.techniques[0].passes[i].num_vertices, 1, 0, 0);
+            pLogicalDevice->vkd.CmdDraw(commandBuffer, passVertexCounts[i], 1, 0, 0);
             Logger::debug("after draw");
 
-            pLogicalDevice->vkd.CmdEndRenderPass(commandBuffer);
+            if (useDynamicRendering)
+                endDynamicPass(attachmentBarriers, commandBuffer);
+            else
+                pLogicalDevice->vkd.CmdEndRenderPass(commandBuffer);
             Logger::debug("after end renderpass");
 
-            if (switchSamplers[i] && outputWrites > 1)
+            if (switchSamplers[i] && enabledWrites > 1)
             {
                 if (backBufferNext)
                 {
                     pLogicalDevice->vkd.CmdBindDescriptorSets(
                         commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &(backBufferDescriptorSets[imageIndex]), 0, nullptr);
                 }
-                else if (outputWrites > 2)
+                else if (enabledWrites > 2)
                 {
                     pLogicalDevice->vkd.CmdBindDescriptorSets(
                         commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &(outputDescriptorSets[imageIndex]), 0, nullptr);
@@ -1067,28 +1231,217 @@ namespace vkBasalt
                     pLogicalDevice, commandBuffer, textureImages[renderTarget][0], textureExtents[renderTarget], textureMipLevels[renderTarget]);
             }
         }
+    }
+
+    std::vector<VkImageMemoryBarrier> ReshadeEffect::beginDynamicPass(uint32_t        passIndex,
+                                                                      uint32_t        imageIndex,
+                                                                      bool            toBackBuffer,
+                                                                      VkCommandBuffer commandBuffer)
+    {
+        const DynamicPass& dynamicPass = dynamicPasses[passIndex];
+
+        // A render pass would transition the attachments from and to SHADER_READ_ONLY, here that is up to us
+        VkImageMemoryBarrier barrier;
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.pNext                           = nullptr;
+        barrier.srcAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.oldLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout                       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                           = VK_NULL_HANDLE;
+        barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = 1;  // Render target views only cover the first level
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = 1;
+
+        std::vector<VkImageMemoryBarrier>      barriers;
+        std::vector<VkRenderingAttachmentInfo> colorAttachments;
+        for (size_t a = 0; a < dynamicPass.colorViews.size(); a++)
+        {
+            VkImageView imageView = VK_NULL_HANDLE;
+            if (dynamicPass.backBuffer && a == 0)
+            {
+                barrier.image = toBackBuffer ? backBufferImages[imageIndex] : outputImages[imageIndex];
+                imageView     = toBackBuffer ? (dynamicPass.srgb ? backBufferImageViewsSRGB : backBufferImageViewsUNORM)[imageIndex]
+                                             : (dynamicPass.srgb ? outputImageViewsSRGB : outputImageViewsUNORM)[imageIndex];
+            }
+            else
+            {
+                barrier.image = dynamicPass.colorImages[a];
+                imageView     = dynamicPass.colorViews[a][imageIndex];
+            }
+            barriers.push_back(barrier);
+
+            VkRenderingAttachmentInfo colorAttachment = {};
+            colorAttachment.sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+            colorAttachment.imageView   = imageView;
+            colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            colorAttachment.resolveMode = VK_RESOLVE_MODE_NONE;
+            colorAttachment.loadOp      = dynamicPass.loadOps[a];
+            colorAttachment.storeOp     = VK_ATTACHMENT_STORE_OP_STORE;
+            colorAttachments.push_back(colorAttachment);
+        }
+
+        VkPipelineStageFlags srcStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        VkPipelineStageFlags dstStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+        // The stencil stays in its layout, but an earlier pass may have written it
+        std::vector<VkImageMemoryBarrier> preBarriers = barriers;
+        if (dynamicPass.stencilView)
+        {
+            barrier.image                       = pStencilAttachment->image;
+            barrier.srcAccessMask               = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            barrier.dstAccessMask               = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            barrier.oldLayout                   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            barrier.newLayout                   = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT | VK_IMAGE_ASPECT_DEPTH_BIT;
+            preBarriers.push_back(barrier);
+
+            srcStages |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            dstStages |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        }
+        pLogicalDevice->vkd.CmdPipelineBarrier(
+            commandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, preBarriers.size(), preBarriers.data());
+
+        VkRenderingAttachmentInfo stencilAttachment = {};
+        stencilAttachment.sType       = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        stencilAttachment.imageView   = dynamicPass.stencilView;
+        stencilAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        stencilAttachment.resolveMode = VK_RESOLVE_MODE_NONE;
+        stencilAttachment.loadOp      = dynamicPass.stencilLoadOp;
+        stencilAttachment.storeOp     = VK_ATTACHMENT_STORE_OP_STORE;
+
+        VkRenderingInfo renderingInfo      = {};
+        renderingInfo.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderingInfo.renderArea           = dynamicPass.renderArea;
+        renderingInfo.layerCount           = 1;
+        renderingInfo.colorAttachmentCount = colorAttachments.size();
+        renderingInfo.pColorAttachments    = colorAttachments.data();
+        renderingInfo.pStencilAttachment   = dynamicPass.stencilView ? &stencilAttachment : nullptr;
+        pLogicalDevice->vkd.CmdBeginRendering(commandBuffer, &renderingInfo);
+
+        return barriers;
+    }
+
+    void ReshadeEffect::endDynamicPass(std::vector<VkImageMemoryBarrier>& barriers, VkCommandBuffer commandBuffer)
+    {
+        pLogicalDevice->vkd.CmdEndRendering(commandBuffer);
+
+        // Back to SHADER_READ_ONLY for the passes (and effects) sampling them, and the mipmap generation
+        for (auto& barrier : barriers)
+        {
+            barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.oldLayout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            barrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
         pLogicalDevice->vkd.CmdPipelineBarrier(commandBuffer,
-                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+                                                   | VK_PIPELINE_STAGE_TRANSFER_BIT,
                                                0,
                                                0,
                                                nullptr,
                                                0,
                                                nullptr,
-                                               1,
-                                               &secondBarrier);
-        secondBarrier.image = outputImages[imageIndex];
+                                               barriers.size(),
+                                               barriers.data());
+    }
+
+    void ReshadeEffect::copyInputToOutput(uint32_t imageIndex, VkCommandBuffer commandBuffer)
+    {
+        // Both are kept in SHADER_READ_ONLY around the effect (see getImageUses), only the copy itself uses transfer layouts
+        VkImageMemoryBarrier barriers[2];
+        for (auto& barrier : barriers)
+        {
+            barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.pNext                           = nullptr;
+            barrier.srcAccessMask                   = 0;
+            barrier.dstAccessMask                   = 0;
+            barrier.oldLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.newLayout                       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image                           = VK_NULL_HANDLE;
+            barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel   = 0;
+            barrier.subresourceRange.levelCount     = 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount     = 1;
+        }
+        barriers[0].image         = inputImages[imageIndex];
+        barriers[0].newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barriers[1].image         = outputImages[imageIndex];
+        barriers[1].newLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
         pLogicalDevice->vkd.CmdPipelineBarrier(commandBuffer,
-                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                               VK_PIPELINE_STAGE_TRANSFER_BIT,
                                                0,
                                                0,
                                                nullptr,
                                                0,
                                                nullptr,
-                                               1,
-                                               &secondBarrier);
-        Logger::debug("after the second pipeline barrier");
+                                               2,
+                                               barriers);
+
+        VkImageCopy imageCopy;
+        imageCopy.srcSubresource            = {};
+        imageCopy.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageCopy.srcSubresource.layerCount = 1;
+        imageCopy.srcOffset                 = {};
+        imageCopy.dstSubresource            = {};
+        imageCopy.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageCopy.dstSubresource.layerCount = 1;
+        imageCopy.dstOffset                 = {};
+        imageCopy.extent                    = {imageExtent.width, imageExtent.height, 1};
+
+        pLogicalDevice->vkd.CmdCopyImage(commandBuffer,
+                                         inputImages[imageIndex],
+                                         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                         outputImages[imageIndex],
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                         1,
+                                         &imageCopy);
+
+        barriers[0].oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers[0].srcAccessMask = 0;
+        barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barriers[1].oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        pLogicalDevice->vkd.CmdPipelineBarrier(commandBuffer,
+                                               VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                               VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                               0,
+                                               0,
+                                               nullptr,
+                                               0,
+                                               nullptr,
+                                               2,
+                                               barriers);
+    }
+
+    EffectImageUses ReshadeEffect::getImageUses(uint32_t imageIndex) const
+    {
+        // The render passes keep the output in SHADER_READ_ONLY, passes after the first one may also sample it
+        EffectImageUses uses;
+        uses.input            = inputImages[imageIndex];
+        uses.output           = outputImages[imageIndex];
+        uses.inputState       = {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT};
+        uses.outputState      = {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT};
+        uses.outputStateAfter = {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT};
+        return uses;
     }
 
     std::vector<std::unique_ptr<EffectParam>> ReshadeEffect::getParameters() const
@@ -1128,7 +1481,16 @@ namespace vkBasalt
             return items;
         };
 
-        for (const auto& spec : module.spec_constants)
+        // Spec constants when parameters are folded, scalar and vector uniform buffer members when they are live
+        // (matrices and arrays have no editor, ParameterUniform keeps their initializer)
+        std::vector<reshadefx::uniform_info> configurable = module.spec_constants;
+        for (const auto& uniform : module.uniforms)
+        {
+            if (!uniform.type.is_matrix() && !uniform.type.is_array())
+                configurable.push_back(uniform);
+        }
+
+        for (const auto& spec : configurable)
         {
             // Skip uniforms with "source" annotation (auto-updated like frametime)
             if (findAnnotation(spec.annotations, "source") != spec.annotations.end())
@@ -1151,8 +1513,62 @@ namespace vkBasalt
             // Get current value from EffectRegistry (the single source of truth)
             EffectParam* registryParam = pEffectRegistry->getParameter(effectName, spec.name);
 
+            // Vector uniforms, one value per component
+            auto populateVector = [&](auto& p, const auto* defaults, auto getBound) {
+                using Param      = std::remove_reference_t<decltype(p)>;
+                p.effectName     = effectName;
+                p.name           = spec.name;
+                p.label          = label;
+                p.tooltip        = tooltip;
+                p.uiType         = uiType;
+                p.componentCount = spec.type.rows;
+
+                // Get values from registry if available
+                auto* rp = dynamic_cast<Param*>(registryParam);
+                if (rp && rp->componentCount != p.componentCount)
+                    rp = nullptr;
+
+                auto minIt = findAnnotation(spec.annotations, "ui_min");
+                auto maxIt = findAnnotation(spec.annotations, "ui_max");
+                for (uint32_t c = 0; c < p.componentCount; c++)
+                {
+                    p.defaultValue[c] = defaults[c];
+                    p.value[c]        = rp ? rp->value[c] : p.defaultValue[c];
+                    if (minIt != spec.annotations.end())
+                        p.minValue[c] = getBound(*minIt);
+                    if (maxIt != spec.annotations.end())
+                        p.maxValue[c] = getBound(*maxIt);
+                }
+
+                auto stepIt = findAnnotation(spec.annotations, "ui_step");
+                if (stepIt != spec.annotations.end())
+                    p.step = getAnnotationFloat(*stepIt);
+            };
+
             // Create appropriate subclass based on spec type
-            if (spec.type.is_floating_point())
+            if (spec.type.rows >= 2 && spec.type.rows <= 4)
+            {
+                if (spec.type.is_floating_point())
+                {
+                    auto p = std::make_unique<FloatVecParam>();
+                    populateVector(*p, spec.initializer_value.as_float, getAnnotationFloat);
+                    params.push_back(std::move(p));
+                }
+                else if (spec.type.is_integral() && spec.type.is_signed())
+                {
+                    auto p = std::make_unique<IntVecParam>();
+                    populateVector(*p, spec.initializer_value.as_int, getAnnotationInt);
+                    params.push_back(std::move(p));
+                }
+                else if (spec.type.is_integral())
+                {
+                    auto p = std::make_unique<UintVecParam>();
+                    populateVector(*p, spec.initializer_value.as_uint,
+                                   [&](const auto& annotation) { return static_cast<uint32_t>(getAnnotationInt(annotation)); });
+                    params.push_back(std::move(p));
+                }
+            }
+            else if (spec.type.is_floating_point())
             {
                 auto p = std::make_unique<FloatParam>();
                 p->effectName = effectName;
@@ -1242,12 +1658,6 @@ namespace vkBasalt
             pLogicalDevice->vkd.DestroyPipeline(pLogicalDevice->device, pipeline, nullptr);
         }
 
-        if (bufferSize)
-        {
-            pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, stagingBufferMemory, nullptr);
-            pLogicalDevice->vkd.DestroyBuffer(pLogicalDevice->device, stagingBuffer, nullptr);
-        }
-
         pLogicalDevice->vkd.DestroyPipelineLayout(pLogicalDevice->device, pipelineLayout, nullptr);
         for (auto& renderPass : renderPasses)
         {
@@ -1285,8 +1695,17 @@ namespace vkBasalt
                 pLogicalDevice->vkd.DestroyFramebuffer(pLogicalDevice->device, fb, nullptr);
             }
         }
+        for (auto& fbs : backBufferFramebuffers)
+        {
+            for (auto& fb : fbs)
+            {
+                pLogicalDevice->vkd.DestroyFramebuffer(pLogicalDevice->device, fb, nullptr);
+            }
+        }
 
-        std::set<VkImageView> imageViewSet;
+        // The input views are also the views of the color and depth textures
+        std::set<VkImageView> imageViewSet(inputImageViewsSRGB.begin(), inputImageViewsSRGB.end());
+        imageViewSet.insert(inputImageViewsUNORM.begin(), inputImageViewsUNORM.end());
 
         for (auto& it : textureImageViewsSRGB)
         {
@@ -1322,7 +1741,6 @@ namespace vkBasalt
         {
             pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, imageView, nullptr);
         }
-        pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, stencilImageView, nullptr);
 
         for (auto& it : textureImages)
         {
@@ -1337,8 +1755,6 @@ namespace vkBasalt
             pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, image, nullptr);
         }
 
-        pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, stencilImage, nullptr);
-
         for (auto& sampler : samplers)
         {
             pLogicalDevice->vkd.DestroySampler(pLogicalDevice->device, sampler, nullptr);
@@ -1352,33 +1768,6 @@ namespace vkBasalt
 
     void ReshadeEffect::createReshadeModule()
     {
-        std::string tempFile  = "/tmp/vkBasalt.spv";
-        std::string tempFile2 = "/tmp/vkBasalt.spv";
-
-        reshadefx::preprocessor preprocessor;
-        preprocessor.add_macro_definition("__RESHADE__", std::to_string(INT_MAX));
-        preprocessor.add_macro_definition("__RESHADE_PERFORMANCE_MODE__", "1");
-        preprocessor.add_macro_definition("__RENDERER__", "0x20000");
-        // TODO add more macros
-
-        preprocessor.add_macro_definition("BUFFER_WIDTH", std::to_string(imageExtent.width));
-        preprocessor.add_macro_definition("BUFFER_HEIGHT", std::to_string(imageExtent.height));
-        preprocessor.add_macro_definition("BUFFER_RCP_WIDTH", "(1.0 / BUFFER_WIDTH)");
-        preprocessor.add_macro_definition("BUFFER_RCP_HEIGHT", "(1.0 / BUFFER_HEIGHT)");
-        preprocessor.add_macro_definition("BUFFER_COLOR_DEPTH", (inputOutputFormatUNORM == VK_FORMAT_A2R10G10B10_UNORM_PACK32) ? "10" : "8");
-
-        // Add custom preprocessor definitions (user-configurable macros)
-        for (const auto& def : customPreprocessorDefs)
-        {
-            preprocessor.add_macro_definition(def.name, def.value);
-            Logger::debug("  custom macro: " + def.name + " = " + def.value);
-        }
-
-        // Add all discovered shader paths from shader manager
-        ShaderManagerConfig shaderMgrConfig = ConfigSerializer::loadShaderManagerConfig();
-        for (const auto& path : shaderMgrConfig.discoveredShaderPaths)
-            preprocessor.add_include_path(path);
-
         // Use provided effectPath, or try to find it in discovered shader paths
         std::string shaderPath = this->effectPath;
         if (shaderPath.empty())
@@ -1387,6 +1776,7 @@ namespace vkBasalt
             if (shaderPath.empty())
             {
                 // Search discovered shader paths for the effect
+                ShaderManagerConfig shaderMgrConfig = ConfigSerializer::loadShaderManagerConfig();
                 for (const auto& searchPath : shaderMgrConfig.discoveredShaderPaths)
                 {
                     std::string candidate = searchPath + "/" + effectName + ".fx";
@@ -1405,30 +1795,43 @@ namespace vkBasalt
             }
         }
 
-        if (shaderPath.empty() || !preprocessor.append_file(shaderPath))
-        {
-            Logger::err("failed to load shader file: " + shaderPath);
-            Logger::err("Does the filepath exist and does it not include spaces?");
-        }
+        ReshadeCompileOptions options;
+        options.bufferWidth  = imageExtent.width;
+        options.bufferHeight = imageExtent.height;
+        options.colorDepth   = (inputOutputFormatUNORM == VK_FORMAT_A2R10G10B10_UNORM_PACK32) ? 10 : 8;
+        // With live parameters the uniforms stay in the uniform buffer and are written by updateEffect(),
+        // otherwise they are folded into the pipelines as spec constants and every change needs a rebuild
+        options.uniformsToSpecConstants = !settingsManager.getLiveParams();
+        options.customDefs              = customPreprocessorDefs;
 
-        reshadefx::parser parser;
+        for (const auto& def : customPreprocessorDefs)
+            Logger::debug("  custom macro: " + def.name + " = " + def.value);
 
-        std::string errors = preprocessor.errors();
-        if (errors != "")
+        // Reuse the module compiled in the background (the chain is only rebuilt once it is ready),
+        // otherwise compile now and hand the result back so other swapchains and reloads can reuse it
+        std::shared_ptr<const CompiledReshadeEffect> compiled = pEffectRegistry->getCompiledEffect(effectName, options);
+        if (compiled && compiled->filePath == shaderPath)
         {
-            Logger::err(errors);
+            Logger::debug("reusing compiled reshade module: " + effectName);
         }
-
-        std::unique_ptr<reshadefx::codegen> codegen(reshadefx::create_codegen_spirv(
-            true /* vulkan semantics */, true /* debug info */, true /* uniforms to spec constants */, true /*flip vertex shader*/));
-        parser.parse(std::move(preprocessor.output()), codegen.get());
-
-        errors = parser.errors();
-        if (errors != "")
+        else
         {
-            Logger::err(errors);
+            if (shaderPath.empty())
+                Logger::err("failed to find shader file for: " + effectName);
+            auto fresh = compileReshadeEffect(effectName, shaderPath, options);
+            loadReshadeTextures(*fresh);
+            compiled = fresh;
+            if (compiled->success)
+                pEffectRegistry->setCompiledEffect(effectName, compiled);
         }
-        codegen->write_result(module);
+
+        if (!compiled->success)
+            throw std::runtime_error("failed to compile " + shaderPath + ": " + compiled->errorMessage);
+        if (!compiled->errorMessage.empty())
+            Logger::warn(compiled->errorMessage);
+
+        module         = compiled->module;
+        compiledEffect = compiled;
 
         VkShaderModuleCreateInfo shaderCreateInfo;
         shaderCreateInfo.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
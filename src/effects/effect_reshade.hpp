@@ -17,6 +17,8 @@
 #include "reshade_uniforms.hpp"
 
 #include "logical_device.hpp"
+#include "stencil_attachment.hpp"
+#include "render_target_pool.hpp"
 
 #include "reshade/effect_parser.hpp"
 #include "reshade/effect_codegen.hpp"
@@ -24,6 +26,19 @@
 
 namespace vkBasalt
 {
+    // What a pass is recorded with when there are no render pass and framebuffer objects (dynamic rendering)
+    struct DynamicPass
+    {
+        std::vector<std::vector<VkImageView>> colorViews;   // Per attachment and image, the back buffer's are chosen when recording
+        std::vector<VkImage>                  colorImages;  // Per attachment, VK_NULL_HANDLE for the back buffer
+        std::vector<VkAttachmentLoadOp>       loadOps;
+        bool                                  backBuffer;   // Attachment 0 is the back buffer
+        bool                                  srgb;
+        VkImageView                           stencilView;  // VK_NULL_HANDLE if the pass has no stencil state
+        VkAttachmentLoadOp                    stencilLoadOp;
+        VkRect2D                              renderArea;
+    };
+
     class ReshadeEffect : public Effect
     {
     public:
@@ -32,14 +47,20 @@ namespace vkBasalt
                       VkExtent2D           imageExtent,
                       std::vector<VkImage> inputImages,
                       std::vector<VkImage> outputImages,
+                      std::shared_ptr<StencilAttachment> pStencilAttachment,
+                      RenderTargetPool*    pRenderTargetPool,
                       EffectRegistry*      pEffectRegistry,
                       std::string          effectName,
                       std::string          effectPath = "",  // Optional: explicit path to .fx file
                       std::vector<PreprocessorDefinition> customDefs = {});  // Custom preprocessor definitions
         void virtual applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer) override;
-        void virtual updateEffect() override;
+        EffectImageUses virtual getImageUses(uint32_t imageIndex) const override;
+        void virtual updateEffect(uint32_t imageIndex, const FrameContext& frame) override;
+        uint32_t virtual getUniformSize() const override;
+        void virtual useUniformRing(UniformRing* pUniformRing, VkDescriptorSet descriptorSet, VkDeviceSize offset) override;
         void virtual useDepthImage(VkImageView depthImageView) override;
         std::vector<std::unique_ptr<EffectParam>> getParameters() const override;
+        bool virtual rebindImages(const std::vector<VkImage>& inputImages, const std::vector<VkImage>& outputImages) override;
         virtual ~ReshadeEffect();
 
     private:
@@ -66,7 +87,10 @@ namespace vkBasalt
         std::vector<VkDescriptorSet> outputDescriptorSets;
         std::vector<VkDescriptorSet> backBufferDescriptorSets;
 
-        std::vector<std::vector<VkFramebuffer>> framebuffers;
+        std::vector<std::vector<VkFramebuffer>> framebuffers;            // Back buffer writing passes: the ones writing the output
+        std::vector<std::vector<VkFramebuffer>> backBufferFramebuffers;  // Back buffer writing passes: the ones writing the back buffer
+        bool                                    useDynamicRendering;     // Passes use dynamicPasses instead of render passes and framebuffers
+        std::vector<DynamicPass>                dynamicPasses;
 
         VkDescriptorSetLayout                 uniformDescriptorSetLayout;
         VkDescriptorSetLayout                 imageSamplerDescriptorSetLayout;
@@ -78,6 +102,9 @@ namespace vkBasalt
         VkPipelineLayout                      pipelineLayout;
         std::vector<VkPipeline>               graphicsPipelines;
         std::vector<bool>                     switchSamplers;
+        std::vector<bool>                     passSrgbWrites;    // Per pass
+        std::vector<VkImageView>              passStencilViews;  // Per pass, VK_NULL_HANDLE if it has no stencil state
+        bool                                  rendersToChainImages = false;  // Some pass renders to the color or depth texture
         VkExtent2D                            imageExtent;
         std::vector<VkSampler>                samplers;
         EffectRegistry*                       pEffectRegistry;
@@ -85,27 +112,41 @@ namespace vkBasalt
         std::string                           effectPath;  // Path to .fx file (may differ from effectName)
         std::vector<PreprocessorDefinition>   customPreprocessorDefs;  // User-defined macros
         reshadefx::module                     module;
+        std::shared_ptr<const CompiledReshadeEffect> compiledEffect;  // Source of module and decoded textures
         std::vector<VkDeviceMemory>           textureMemory;
+        std::vector<std::shared_ptr<RenderTargetBlock>> renderTargetBlocks;    // Memory of the pooled render targets
+        std::vector<std::vector<VkImageMemoryBarrier>>  renderTargetDiscards;  // Per pass, the pooled render targets it writes first
+        std::vector<uint32_t>                           passTechniques;        // Per pass (of all techniques), the technique it belongs to
+        std::vector<bool>                               techniquesEnabled;     // Per technique, resolved from the registry (see resolveTechniques)
+        uint64_t                                        techniqueGeneration = 0;
+        std::vector<uint32_t>                           passVertexCounts;
 
         VkFormat    inputOutputFormatUNORM;
         VkFormat    inputOutputFormatSRGB;
-        VkFormat    stencilFormat;
-        VkImage     stencilImage;
-        VkImageView stencilImageView;
-        // how often the shader writes to the reshade back buffer
+        std::shared_ptr<StencilAttachment> pStencilAttachment;  // Shared with the other effects of the swapchain
+        bool                               usesStencil = false;  // Some pass has stencil state
+        // how often the shader writes to the reshade back buffer (all techniques, the enabled ones are counted in enabledWrites)
         // we need to flip the "backbuffer" after each write if there is a next one
         int                      outputWrites = 0;
+        int                      enabledWrites = 0;  // The back buffer writes of the enabled techniques
         std::vector<VkImage>     backBufferImages;
         std::vector<VkImageView> backBufferImageViewsUNORM;
         std::vector<VkImageView> backBufferImageViewsSRGB;
-        VkBuffer                 stagingBuffer;
-        VkDeviceMemory           stagingBufferMemory;
         uint32_t                 bufferSize;
-        VkDescriptorSet          bufferDescriptorSet;
+        UniformRing*             pUniformRing = nullptr;  // Owned by the swapchain, outlives the recorded command buffers
+        VkDeviceSize             uniformOffset;
+        VkDescriptorSet          bufferDescriptorSet;  // Allocated from the ring
 
-        std::vector<std::shared_ptr<ReshadeUniform>> uniforms;
+        ReshadeUniforms       uniforms;
+        std::vector<uint64_t> sliceGenerations;  // Parameter generation each slice of the ring was written with
 
         void          createReshadeModule();
+        void          createImageSamplerDescriptorSets();
+        std::vector<VkFramebuffer> createOutputFramebuffers(size_t passIndex);
+        void          resolveTechniques();
+        void          copyInputToOutput(uint32_t imageIndex, VkCommandBuffer commandBuffer);
+        std::vector<VkImageMemoryBarrier> beginDynamicPass(uint32_t passIndex, uint32_t imageIndex, bool toBackBuffer, VkCommandBuffer commandBuffer);
+        void          endDynamicPass(std::vector<VkImageMemoryBarrier>& barriers, VkCommandBuffer commandBuffer);
         VkFormat      convertReshadeFormat(reshadefx::texture_format texFormat);
         VkCompareOp   convertReshadeCompareOp(reshadefx::pass_stencil_func compareOp);
         VkStencilOp   convertReshadeStencilOp(reshadefx::pass_stencil_op stencilOp);
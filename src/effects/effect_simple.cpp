@@ -7,10 +7,14 @@
 #include "buffer.hpp"
 #include "renderpass.hpp"
 #include "graphics_pipeline.hpp"
+#include "compute_pipeline.hpp"
 #include "framebuffer.hpp"
 #include "shader.hpp"
 #include "sampler.hpp"
 #include "util.hpp"
+#include "frame_sync.hpp"
+#include "format.hpp"
+#include "lut_texture.hpp"
 
 namespace vkBasalt
 {
@@ -33,91 +37,183 @@ namespace vkBasalt
         this->outputImages   = outputImages;
         this->pConfig        = pConfig;
 
-        inputImageViews = createImageViews(pLogicalDevice, format, inputImages);
-        Logger::debug("created input ImageViews");
-        outputImageViews = createImageViews(pLogicalDevice, format, outputImages);
-        Logger::debug("created ImageViews");
         sampler = createSampler(pLogicalDevice);
         Logger::debug("created sampler");
 
-        imageSamplerDescriptorSetLayout = createImageSamplerDescriptorSetLayout(pLogicalDevice, 1);
-        Logger::debug("created descriptorSetLayouts");
+        // Constants the shader variants need on top of the ones of the subclass
+        std::vector<VkSpecializationMapEntry> mapEntries;
+        std::vector<char>                     specData;
+        if (pFragmentSpecInfo)
+        {
+            mapEntries.assign(pFragmentSpecInfo->pMapEntries, pFragmentSpecInfo->pMapEntries + pFragmentSpecInfo->mapEntryCount);
+            specData.assign((const char*) pFragmentSpecInfo->pData, (const char*) pFragmentSpecInfo->pData + pFragmentSpecInfo->dataSize);
+        }
+        auto addConstant = [&](uint32_t constantId, int32_t value) {
+            mapEntries.push_back({constantId, (uint32_t) specData.size(), sizeof(int32_t)});
+            specData.insert(specData.end(), (const char*) &value, (const char*) &value + sizeof(int32_t));
+        };
 
-        VkDescriptorPoolSize imagePoolSize;
-        imagePoolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        imagePoolSize.descriptorCount = inputImages.size() + 10;
+        if (fuseLut)
+        {
+            fusedLut          = createLutTexture(pLogicalDevice, pConfig->getOption<std::string>("lutFile"));
+            fusedLutSetLayout = createImageSamplerDescriptorSetLayout(pLogicalDevice, 1);
+            descriptorSetLayouts.push_back(fusedLutSetLayout);
+            addConstant(fusedLutSizeConstantId, fusedLut.size);
+            addConstant(fusedLutFlipGBConstantId, fusedLut.flipGB);
+            // The separate lut effect would read our output back from an image of this format
+            addConstant(fusedLutInputLevelsConstantId, getColorLevels(format));
 
-        std::vector<VkDescriptorPoolSize> poolSizes = {imagePoolSize};
+            VkDescriptorPoolSize imagePoolSize;
+            imagePoolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            imagePoolSize.descriptorCount = 1;
+
+            fusedLutPool = createDescriptorPool(pLogicalDevice, {imagePoolSize});
+            fusedLutSet  = allocateAndWriteImageSamplerDescriptorSets(pLogicalDevice,
+                                                                     fusedLutPool,
+                                                                     fusedLutSetLayout,
+                                                                     {sampler},
+                                                                     std::vector<std::vector<VkImageView>>(1, std::vector<VkImageView>(1, fusedLut.view)))[0];
+            Logger::debug("fused lut into the effect");
+        }
+
+        bool useCompute = canWriteWithCompute(outputImages);
+        // Storage writes go through a UNORM view, sRGB effects encode in the shader (outputSrgb)
+        if (useCompute)
+            addConstant(outputSrgbConstantId, isSRGB(format));
+
+        VkSpecializationInfo specInfo;
+        specInfo.mapEntryCount = mapEntries.size();
+        specInfo.pMapEntries   = mapEntries.data();
+        specInfo.dataSize      = specData.size();
+        specInfo.pData         = specData.data();
+
+        if (useCompute)
+        {
+            imageSamplerDescriptorSetLayout = createComputeImageDescriptorSetLayout(pLogicalDevice);
+            createShaderModule(pLogicalDevice, computeCode, &computeModule);
+
+            descriptorSetLayouts.insert(descriptorSetLayouts.begin(), imageSamplerDescriptorSetLayout);
+            pipelineLayout  = createGraphicsPipelineLayout(pLogicalDevice, descriptorSetLayouts);
+            computePipeline = createComputePipeline(pLogicalDevice, computeModule, &specInfo, "main", pipelineLayout);
+            bindPoint       = VK_PIPELINE_BIND_POINT_COMPUTE;
+            Logger::debug("created compute pipeline");
+        }
+        else
+        {
+            imageSamplerDescriptorSetLayout = createImageSamplerDescriptorSetLayout(pLogicalDevice, 1);
+            Logger::debug("created descriptorSetLayouts");
+
+            createShaderModule(pLogicalDevice, vertexCode, &vertexModule);
+            createShaderModule(pLogicalDevice, fragmentCode, &fragmentModule);
+
+            renderPass = createRenderPass(pLogicalDevice, format);
+
+            descriptorSetLayouts.insert(descriptorSetLayouts.begin(), imageSamplerDescriptorSetLayout);
+            pipelineLayout = createGraphicsPipelineLayout(pLogicalDevice, descriptorSetLayouts);
+
+            graphicsPipeline = createGraphicsPipeline(pLogicalDevice,
+                                                      vertexModule,
+                                                      pVertexSpecInfo,
+                                                      "main",
+                                                      fragmentModule,
+                                                      &specInfo,
+                                                      "main",
+                                                      imageExtent,
+                                                      renderPass,
+                                                      pipelineLayout);
+        }
+
+        createImageResources();
+    }
+
+    bool SimpleEffect::canWriteWithCompute(const std::vector<VkImage>& images) const
+    {
+        if (computeCode.empty())
+            return false;
+        for (auto image : images)
+        {
+            if (!pLogicalDevice->storageImages.count(image))
+                return false;
+        }
+        return true;
+    }
+
+    void SimpleEffect::createImageResources()
+    {
+        inputImageViews = createImageViews(pLogicalDevice, format, inputImages);
 
-        descriptorPool = createDescriptorPool(pLogicalDevice, poolSizes);
-        Logger::debug("created descriptorPool");
+        if (computePipeline != VK_NULL_HANDLE)
+        {
+            outputImageViews = createImageViews(pLogicalDevice, convertToUNORM(format), outputImages);
 
-        createShaderModule(pLogicalDevice, vertexCode, &vertexModule);
-        createShaderModule(pLogicalDevice, fragmentCode, &fragmentModule);
+            VkDescriptorPoolSize imagePoolSize;
+            imagePoolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            imagePoolSize.descriptorCount = inputImages.size() + 10;
+            VkDescriptorPoolSize storagePoolSize;
+            storagePoolSize.type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            storagePoolSize.descriptorCount = outputImages.size();
 
-        renderPass = createRenderPass(pLogicalDevice, format);
+            descriptorPool      = createDescriptorPool(pLogicalDevice, {imagePoolSize, storagePoolSize});
+            imageDescriptorSets = allocateAndWriteComputeImageDescriptorSets(
+                pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, sampler, inputImageViews, outputImageViews);
+            return;
+        }
 
-        descriptorSetLayouts.insert(descriptorSetLayouts.begin(), imageSamplerDescriptorSetLayout);
-        pipelineLayout = createGraphicsPipelineLayout(pLogicalDevice, descriptorSetLayouts);
+        outputImageViews = createImageViews(pLogicalDevice, format, outputImages);
 
-        graphicsPipeline = createGraphicsPipeline(pLogicalDevice,
-                                                  vertexModule,
-                                                  pVertexSpecInfo,
-                                                  "main",
-                                                  fragmentModule,
-                                                  pFragmentSpecInfo,
-                                                  "main",
-                                                  imageExtent,
-                                                  renderPass,
-                                                  pipelineLayout);
+        VkDescriptorPoolSize imagePoolSize;
+        imagePoolSize.type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        imagePoolSize.descriptorCount = inputImages.size() + 10;
 
+        descriptorPool      = createDescriptorPool(pLogicalDevice, {imagePoolSize});
         imageDescriptorSets = allocateAndWriteImageSamplerDescriptorSets(
             pLogicalDevice, descriptorPool, imageSamplerDescriptorSetLayout, {sampler}, std::vector<std::vector<VkImageView>>(1, inputImageViews));
 
         framebuffers = createFramebuffers(pLogicalDevice, renderPass, imageExtent, {outputImageViews});
     }
+
+    bool SimpleEffect::rebindImages(const std::vector<VkImage>& inputImages, const std::vector<VkImage>& outputImages)
+    {
+        // The pipeline was built for storage or attachment writes, the new outputs must allow the same
+        if ((computePipeline != VK_NULL_HANDLE) != canWriteWithCompute(outputImages))
+            return false;
+
+        // Only the image views, framebuffers and input descriptors depend on the images.
+        // Frames in flight may still use the old ones, so they get new handles and the old ones are retired
+        LogicalDevice*             pDevice           = pLogicalDevice;
+        std::vector<VkFramebuffer> oldFramebuffers   = framebuffers;
+        std::vector<VkImageView>   oldImageViews     = inputImageViews;
+        VkDescriptorPool           oldDescriptorPool = descriptorPool;
+        oldImageViews.insert(oldImageViews.end(), outputImageViews.begin(), outputImageViews.end());
+        retireResources(pLogicalDevice, [pDevice, oldFramebuffers, oldImageViews, oldDescriptorPool]() {
+            for (auto framebuffer : oldFramebuffers)
+                pDevice->vkd.DestroyFramebuffer(pDevice->device, framebuffer, nullptr);
+            for (auto imageView : oldImageViews)
+                pDevice->vkd.DestroyImageView(pDevice->device, imageView, nullptr);
+            pDevice->vkd.DestroyDescriptorPool(pDevice->device, oldDescriptorPool, nullptr);
+        });
+
+        this->inputImages  = inputImages;
+        this->outputImages = outputImages;
+
+        createImageResources();
+        return true;
+    }
+
     void SimpleEffect::applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer)
     {
         Logger::debug("applying SimpleEffect to cb " + convertToString(commandBuffer));
-        // Used to make the Image accessable by the shader
-        VkImageMemoryBarrier memoryBarrier;
-        memoryBarrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        memoryBarrier.pNext               = nullptr;
-        memoryBarrier.srcAccessMask       = VK_ACCESS_MEMORY_WRITE_BIT;
-        memoryBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-        memoryBarrier.oldLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        memoryBarrier.newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        memoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        memoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        memoryBarrier.image               = inputImages[imageIndex];
-
-        memoryBarrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        memoryBarrier.subresourceRange.baseMipLevel   = 0;
-        memoryBarrier.subresourceRange.levelCount     = 1;
-        memoryBarrier.subresourceRange.baseArrayLayer = 0;
-        memoryBarrier.subresourceRange.layerCount     = 1;
-
-        // Reverses the first Barrier
-        VkImageMemoryBarrier secondBarrier;
-        secondBarrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        secondBarrier.pNext               = nullptr;
-        secondBarrier.srcAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-        secondBarrier.dstAccessMask       = 0;
-        secondBarrier.oldLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        secondBarrier.newLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        secondBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        secondBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        secondBarrier.image               = inputImages[imageIndex];
-
-        secondBarrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        secondBarrier.subresourceRange.baseMipLevel   = 0;
-        secondBarrier.subresourceRange.levelCount     = 1;
-        secondBarrier.subresourceRange.baseArrayLayer = 0;
-        secondBarrier.subresourceRange.layerCount     = 1;
-
-        pLogicalDevice->vkd.CmdPipelineBarrier(
-            commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
-        Logger::debug("after the first pipeline barrier");
+        // The fused lut set comes last, after the sets of the subclass
+        if (fusedLutSet != VK_NULL_HANDLE)
+        {
+            pLogicalDevice->vkd.CmdBindDescriptorSets(
+                commandBuffer, bindPoint, pipelineLayout, descriptorSetLayouts.size() - 1, 1, &fusedLutSet, 0, nullptr);
+        }
+        if (computePipeline != VK_NULL_HANDLE)
+        {
+            applyCompute(imageIndex, commandBuffer);
+            return;
+        }
 
         VkRenderPassBeginInfo renderPassBeginInfo;
         renderPassBeginInfo.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -146,19 +242,40 @@ namespace vkBasalt
 
         pLogicalDevice->vkd.CmdEndRenderPass(commandBuffer);
         Logger::debug("after end renderpass");
+    }
+    void SimpleEffect::applyCompute(uint32_t imageIndex, VkCommandBuffer commandBuffer)
+    {
+        pLogicalDevice->vkd.CmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &(imageDescriptorSets[imageIndex]), 0, nullptr);
+        pLogicalDevice->vkd.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+        pLogicalDevice->vkd.CmdDispatch(commandBuffer,
+                                        (imageExtent.width + computeGroupSize - 1) / computeGroupSize,
+                                        (imageExtent.height + computeGroupSize - 1) / computeGroupSize,
+                                        1);
+        Logger::debug("after dispatch");
+    }
 
-        pLogicalDevice->vkd.CmdPipelineBarrier(commandBuffer,
-                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                                               0,
-                                               0,
-                                               nullptr,
-                                               0,
-                                               nullptr,
-                                               1,
-                                               &secondBarrier);
-        Logger::debug("after the second pipeline barrier");
+    EffectImageUses SimpleEffect::getImageUses(uint32_t imageIndex) const
+    {
+        EffectImageUses uses;
+        uses.input  = inputImages[imageIndex];
+        uses.output = outputImages[imageIndex];
+        if (computePipeline != VK_NULL_HANDLE)
+        {
+            uses.inputState       = {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT};
+            uses.outputState      = {VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT};
+            uses.outputStateAfter = uses.outputState;
+            return uses;
+        }
+        uses.inputState = {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT};
+        uses.outputState =
+            {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT};
+        // The render pass leaves it ready to be sampled
+        uses.outputStateAfter        = uses.outputState;
+        uses.outputStateAfter.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        return uses;
     }
+
     SimpleEffect::~SimpleEffect()
     {
         Logger::debug("destroying SimpleEffect " + convertToString(this));
@@ -168,20 +285,26 @@ namespace vkBasalt
             return;
 
         pLogicalDevice->vkd.DestroyPipeline(pLogicalDevice->device, graphicsPipeline, nullptr);
+        pLogicalDevice->vkd.DestroyPipeline(pLogicalDevice->device, computePipeline, nullptr);
         pLogicalDevice->vkd.DestroyPipelineLayout(pLogicalDevice->device, pipelineLayout, nullptr);
         pLogicalDevice->vkd.DestroyRenderPass(pLogicalDevice->device, renderPass, nullptr);
         pLogicalDevice->vkd.DestroyDescriptorSetLayout(pLogicalDevice->device, imageSamplerDescriptorSetLayout, nullptr);
         pLogicalDevice->vkd.DestroyShaderModule(pLogicalDevice->device, vertexModule, nullptr);
         pLogicalDevice->vkd.DestroyShaderModule(pLogicalDevice->device, fragmentModule, nullptr);
+        pLogicalDevice->vkd.DestroyShaderModule(pLogicalDevice->device, computeModule, nullptr);
 
         pLogicalDevice->vkd.DestroyDescriptorPool(pLogicalDevice->device, descriptorPool, nullptr);
-        for (unsigned int i = 0; i < framebuffers.size(); i++)
-        {
-            pLogicalDevice->vkd.DestroyFramebuffer(pLogicalDevice->device, framebuffers[i], nullptr);
-            pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, inputImageViews[i], nullptr);
-            pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, outputImageViews[i], nullptr);
-        }
+        for (auto framebuffer : framebuffers)
+            pLogicalDevice->vkd.DestroyFramebuffer(pLogicalDevice->device, framebuffer, nullptr);
+        for (auto imageView : inputImageViews)
+            pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, imageView, nullptr);
+        for (auto imageView : outputImageViews)
+            pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, imageView, nullptr);
         Logger::debug("after DestroyImageView");
         pLogicalDevice->vkd.DestroySampler(pLogicalDevice->device, sampler, nullptr);
+
+        pLogicalDevice->vkd.DestroyDescriptorPool(pLogicalDevice->device, fusedLutPool, nullptr);
+        pLogicalDevice->vkd.DestroyDescriptorSetLayout(pLogicalDevice->device, fusedLutSetLayout, nullptr);
+        destroyLutTexture(pLogicalDevice, fusedLut);
     }
 } // namespace vkBasalt
@@ -14,6 +14,9 @@
 #include "config.hpp"
 
 #include "logical_device.hpp"
+#include "lut_texture.hpp"
+
+#include "shader/compute_interface.h"
 
 namespace vkBasalt
 {
@@ -22,8 +25,19 @@ namespace vkBasalt
     public:
         SimpleEffect();
         void virtual applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer) override;
+        bool virtual rebindImages(const std::vector<VkImage>& inputImages, const std::vector<VkImage>& outputImages) override;
+        EffectImageUses virtual getImageUses(uint32_t imageIndex) const override;
         virtual ~SimpleEffect();
 
+        // local_size of the compute shaders
+        static constexpr uint32_t computeGroupSize = COMPUTE_GROUP_SIZE;
+        // Specialization constant the compute shaders use to sRGB-encode before the storage write
+        static constexpr uint32_t outputSrgbConstantId = OUTPUT_SRGB_CONSTANT_ID;
+        // Size, flipGB and input rounding of a fused lut (fused_lut.h)
+        static constexpr uint32_t fusedLutSizeConstantId        = FUSED_LUT_SIZE_CONSTANT_ID;
+        static constexpr uint32_t fusedLutFlipGBConstantId      = FUSED_LUT_FLIP_GB_CONSTANT_ID;
+        static constexpr uint32_t fusedLutInputLevelsConstantId = FUSED_LUT_INPUT_LEVELS_CONSTANT_ID;
+
     protected:
         LogicalDevice*               pLogicalDevice = nullptr;
         std::vector<VkImage>         inputImages;
@@ -39,14 +53,20 @@ namespace vkBasalt
         VkRenderPass                 renderPass = VK_NULL_HANDLE;
         VkPipelineLayout             pipelineLayout = VK_NULL_HANDLE;
         VkPipeline                   graphicsPipeline = VK_NULL_HANDLE;
+        VkShaderModule               computeModule = VK_NULL_HANDLE;
+        VkPipeline                   computePipeline = VK_NULL_HANDLE;  // Used instead of the render pass when set
+        VkPipelineBindPoint          bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
         VkExtent2D                   imageExtent = {};
         VkFormat                     format = VK_FORMAT_UNDEFINED;
         VkSampler                    sampler = VK_NULL_HANDLE;
         Config*                      pConfig = nullptr;
         std::vector<uint32_t>        vertexCode;
         std::vector<uint32_t>        fragmentCode;
+        std::vector<uint32_t>        computeCode;  // Optional, same bindings and constants as the fragment shader
         VkSpecializationInfo*        pVertexSpecInfo = nullptr;
         VkSpecializationInfo*        pFragmentSpecInfo = nullptr;
+        // Apply the lut effect that follows in the chain in the same pass, the shaders must be the FUSED_LUT variants
+        bool                         fuseLut = false;
 
         // subclasses can put DescriptorSets in here, but the first one will be the input image descriptorSet
         std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
@@ -57,6 +77,18 @@ namespace vkBasalt
                   std::vector<VkImage> inputImages,
                   std::vector<VkImage> outputImages,
                   Config*              pConfig);
+
+    private:
+        LutTexture            fusedLut;
+        VkDescriptorSetLayout fusedLutSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool      fusedLutPool = VK_NULL_HANDLE;
+        VkDescriptorSet       fusedLutSet = VK_NULL_HANDLE;
+
+        // True if computeCode is set and every image can be written as a storage image
+        bool canWriteWithCompute(const std::vector<VkImage>& images) const;
+        // Image views, descriptor sets and framebuffers for the current images
+        void createImageResources();
+        void applyCompute(uint32_t imageIndex, VkCommandBuffer commandBuffer);
     };
 } // namespace vkBasalt
 
@@ -17,6 +17,13 @@ namespace vkBasalt
         this->pConfig        = pConfig;
     }
 
+    bool TransferEffect::rebindImages(const std::vector<VkImage>& inputImages, const std::vector<VkImage>& outputImages)
+    {
+        this->inputImages  = inputImages;
+        this->outputImages = outputImages;
+        return true;
+    }
+
     void TransferEffect::applyEffect(uint32_t imageIndex, VkCommandBuffer commandBuffer)
     {
         VkImageCopy imageCopy;
@@ -30,33 +37,6 @@ namespace vkBasalt
         imageCopy.dstOffset                 = {};
         imageCopy.extent                    = {imageExtent.width, imageExtent.height, 1};
 
-        VkImageMemoryBarrier memoryBarrier;
-        memoryBarrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        memoryBarrier.pNext               = nullptr;
-        memoryBarrier.srcAccessMask       = 0;
-        memoryBarrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
-        memoryBarrier.oldLayout           = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        memoryBarrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        memoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        memoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        memoryBarrier.image               = inputImages[imageIndex];
-
-        memoryBarrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-        memoryBarrier.subresourceRange.baseMipLevel   = 0;
-        memoryBarrier.subresourceRange.levelCount     = 1;
-        memoryBarrier.subresourceRange.baseArrayLayer = 0;
-        memoryBarrier.subresourceRange.layerCount     = 1;
-
-        pLogicalDevice->vkd.CmdPipelineBarrier(
-            commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
-
-        memoryBarrier.image         = outputImages[imageIndex];
-        memoryBarrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
-        memoryBarrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        pLogicalDevice->vkd.CmdPipelineBarrier(
-            commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
-
         pLogicalDevice->vkd.CmdCopyImage(commandBuffer,
                                          inputImages[imageIndex],
                                          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
@@ -64,21 +44,17 @@ namespace vkBasalt
                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                          1,
                                          &imageCopy);
+    }
 
-        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        memoryBarrier.dstAccessMask = 0;
-        memoryBarrier.image         = outputImages[imageIndex];
-        memoryBarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        memoryBarrier.newLayout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        pLogicalDevice->vkd.CmdPipelineBarrier(
-            commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
-
-        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        memoryBarrier.image         = inputImages[imageIndex];
-        memoryBarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        memoryBarrier.newLayout     = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        pLogicalDevice->vkd.CmdPipelineBarrier(
-            commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
+    EffectImageUses TransferEffect::getImageUses(uint32_t imageIndex) const
+    {
+        EffectImageUses uses;
+        uses.input            = inputImages[imageIndex];
+        uses.output           = outputImages[imageIndex];
+        uses.inputState       = {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT};
+        uses.outputState      = {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT};
+        uses.outputStateAfter = uses.outputState;
+        return uses;
     }
 
     TransferEffect::~TransferEffect()
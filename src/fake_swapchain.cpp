@@ -7,7 +7,8 @@ namespace vkBasalt
     std::vector<VkImage> createFakeSwapchainImages(LogicalDevice*           pLogicalDevice,
                                                    VkSwapchainCreateInfoKHR swapchainCreateInfo,
                                                    uint32_t                 count,
-                                                   VkDeviceMemory&          deviceMemory)
+                                                   VkDeviceMemory&          deviceMemory,
+                                                   VkDeviceSize&            memorySize)
     {
         std::vector<VkImage> fakeImages(count);
 
@@ -39,6 +40,9 @@ namespace vkBasalt
         imageCreateInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
         imageCreateInfo.usage         = swapchainCreateInfo.imageUsage | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
                                 | VK_IMAGE_USAGE_TRANSFER_SRC_BIT; // TODO what usage do we need?
+        bool storageUsage = isStorageFormat(pLogicalDevice, swapchainCreateInfo.imageFormat);
+        if (storageUsage)
+            imageCreateInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;  // Compute effects write them directly
         imageCreateInfo.sharingMode           = swapchainCreateInfo.imageSharingMode;
         imageCreateInfo.queueFamilyIndexCount = swapchainCreateInfo.queueFamilyIndexCount;
         imageCreateInfo.pQueueFamilyIndices   = swapchainCreateInfo.pQueueFamilyIndices;
@@ -72,12 +76,36 @@ namespace vkBasalt
 
         result = pLogicalDevice->vkd.AllocateMemory(pLogicalDevice->device, &memoryAllocateInfo, nullptr, &deviceMemory);
         ASSERT_VULKAN(result);
+        memorySize = memoryAllocateInfo.allocationSize;
 
         for (uint32_t i = 0; i < count; i++)
         {
             result = pLogicalDevice->vkd.BindImageMemory(pLogicalDevice->device, fakeImages[i], deviceMemory, memoryRequirements.size * i);
             ASSERT_VULKAN(result);
         }
+
+        if (storageUsage)
+            pLogicalDevice->storageImages.insert(fakeImages.begin(), fakeImages.end());
         return fakeImages;
     }
+
+    FakeImageSet createFakeImageSet(LogicalDevice* pLogicalDevice, VkSwapchainCreateInfoKHR swapchainCreateInfo, uint32_t count)
+    {
+        FakeImageSet set;
+        set.images = createFakeSwapchainImages(pLogicalDevice, swapchainCreateInfo, count, set.memory, set.memorySize);
+        return set;
+    }
+
+    void destroyFakeImageSet(LogicalDevice* pLogicalDevice, const FakeImageSet& set)
+    {
+        for (auto image : set.images)
+            pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, image, nullptr);
+        pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, set.memory, nullptr);
+    }
+
+    void untrackStorageImages(LogicalDevice* pLogicalDevice, const std::vector<VkImage>& images)
+    {
+        for (auto image : images)
+            pLogicalDevice->storageImages.erase(image);
+    }
 } // namespace vkBasalt
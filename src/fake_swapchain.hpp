@@ -13,10 +13,25 @@
 
 namespace vkBasalt
 {
+    // Images of one effect chain slot, one per swapchain image in a single allocation
+    struct FakeImageSet
+    {
+        std::vector<VkImage> images;
+        VkDeviceMemory       memory     = VK_NULL_HANDLE;
+        VkDeviceSize         memorySize = 0;
+    };
+
     std::vector<VkImage> createFakeSwapchainImages(LogicalDevice*           pLogicalDevice,
                                                    VkSwapchainCreateInfoKHR swapchainCreateInfo,
                                                    uint32_t                 count,
-                                                   VkDeviceMemory&          deviceMemory);
+                                                   VkDeviceMemory&          deviceMemory,
+                                                   VkDeviceSize&            memorySize);
+
+    FakeImageSet createFakeImageSet(LogicalDevice* pLogicalDevice, VkSwapchainCreateInfoKHR swapchainCreateInfo, uint32_t count);
+    void         destroyFakeImageSet(LogicalDevice* pLogicalDevice, const FakeImageSet& set);
+
+    // Stop treating images as storage capable, before their destruction is deferred (the handles may be reused)
+    void untrackStorageImages(LogicalDevice* pLogicalDevice, const std::vector<VkImage>& images);
 }
 
 #endif // FAKE_SWAPCHAIN_HPP_INCLUDED
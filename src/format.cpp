@@ -94,6 +94,20 @@ namespace vkBasalt
         return convertToSRGB(format) != format;
     }
 
+    uint32_t getColorLevels(VkFormat format)
+    {
+        switch (convertToUNORM(format))
+        {
+            case VK_FORMAT_B8G8R8_UNORM: return 255;
+            case VK_FORMAT_R8G8B8A8_UNORM: return 255;
+            case VK_FORMAT_B8G8R8A8_UNORM: return 255;
+            case VK_FORMAT_A8B8G8R8_UNORM_PACK32: return 255;
+            case VK_FORMAT_A2R10G10B10_UNORM_PACK32: return 1023;
+            case VK_FORMAT_A2B10G10R10_UNORM_PACK32: return 1023;
+            default: return 0;
+        }
+    }
+
     VkFormat getSupportedFormat(LogicalDevice* pLogicalDevice, std::vector<VkFormat> formats, VkFormatFeatureFlags features, VkImageTiling tiling)
     {
         for (auto& format : formats)
@@ -119,6 +133,17 @@ namespace vkBasalt
         return getSupportedFormat(pLogicalDevice, stencilFormats, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
     }
 
+    bool isStorageFormat(LogicalDevice* pLogicalDevice, VkFormat format)
+    {
+        if (!pLogicalDevice->supportsStorageWrite)
+            return false;
+
+        // The image itself must support it, an sRGB image would need extended usage
+        VkFormatProperties properties;
+        pLogicalDevice->vki.GetPhysicalDeviceFormatProperties(pLogicalDevice->physicalDevice, format, &properties);
+        return properties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT;
+    }
+
     bool isDepthFormat(VkFormat format)
     {
         switch (format)
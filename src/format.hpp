@@ -22,6 +22,8 @@ namespace vkBasalt
     // Returns true if format is UNORM
     // TODO currently return false if format is UNORM and no matching sRGB format exist
     bool isUNORM(VkFormat format);
+    // Returns the highest value a color channel of the swapchain format can store, 0 if it is not a fixed point format
+    uint32_t getColorLevels(VkFormat format);
 
     VkFormat getSupportedFormat(LogicalDevice*        pLogicalDevice,
                                 std::vector<VkFormat> formats,
@@ -30,6 +32,9 @@ namespace vkBasalt
 
     VkFormat getStencilFormat(LogicalDevice* pLogicalDevice);
 
+    // Returns true if compute effects can write images of this format through its UNORM view
+    bool isStorageFormat(LogicalDevice* pLogicalDevice, VkFormat format);
+
     bool isDepthFormat(VkFormat format);
 
     bool isStencilFormat(VkFormat format);
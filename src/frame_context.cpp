@@ -0,0 +1,144 @@
+#include "frame_context.hpp"
+
+#include <ctime>
+#include <map>
+#include <mutex>
+
+#include "keyboard_input.hpp"
+#include "mouse_input.hpp"
+#include "logger.hpp"
+
+namespace vkBasalt
+{
+    namespace
+    {
+        struct WatchedKey
+        {
+            uint32_t keySym;
+            uint32_t watchers;
+        };
+
+        std::mutex                     watchedKeysMutex;
+        std::map<uint32_t, WatchedKey> watchedKeys;
+
+        // X11 name of a Windows virtual key code, empty if there is none
+        std::string getKeyName(uint32_t keyCode)
+        {
+            if (keyCode >= '0' && keyCode <= '9')
+                return std::string(1, (char) keyCode);
+            if (keyCode >= 'A' && keyCode <= 'Z')
+                return std::string(1, (char) (keyCode - 'A' + 'a'));
+            if (keyCode >= 0x60 && keyCode <= 0x69)
+                return "KP_" + std::to_string(keyCode - 0x60);
+            if (keyCode >= 0x70 && keyCode <= 0x87)
+                return "F" + std::to_string(keyCode - 0x70 + 1);
+
+            switch (keyCode)
+            {
+                case 0x08: return "BackSpace";
+                case 0x09: return "Tab";
+                case 0x0D: return "Return";
+                case 0x10: return "Shift_L";
+                case 0x11: return "Control_L";
+                case 0x12: return "Alt_L";
+                case 0x13: return "Pause";
+                case 0x14: return "Caps_Lock";
+                case 0x1B: return "Escape";
+                case 0x20: return "space";
+                case 0x21: return "Prior";
+                case 0x22: return "Next";
+                case 0x23: return "End";
+                case 0x24: return "Home";
+                case 0x25: return "Left";
+                case 0x26: return "Up";
+                case 0x27: return "Right";
+                case 0x28: return "Down";
+                case 0x2C: return "Print";
+                case 0x2D: return "Insert";
+                case 0x2E: return "Delete";
+                case 0x6A: return "KP_Multiply";
+                case 0x6B: return "KP_Add";
+                case 0x6D: return "KP_Subtract";
+                case 0x6E: return "KP_Decimal";
+                case 0x6F: return "KP_Divide";
+                case 0xA0: return "Shift_L";
+                case 0xA1: return "Shift_R";
+                case 0xA2: return "Control_L";
+                case 0xA3: return "Control_R";
+                case 0xA4: return "Alt_L";
+                case 0xA5: return "Alt_R";
+                default: return "";
+            }
+        }
+    } // namespace
+
+    void updateFrameContext(FrameContext& frame, const FrameOverlayState& overlay)
+    {
+        auto now = std::chrono::high_resolution_clock::now();
+        if (frame.frameCount < 0)
+            frame.startTime = frame.time = now;
+        frame.frameTime = std::chrono::duration<float, std::milli>(now - frame.time).count();
+        frame.timer     = std::chrono::duration<float, std::milli>(now - frame.startTime).count();
+        frame.time      = now;
+        frame.frameCount++;
+
+        std::time_t nowC        = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        struct tm*  currentTime = std::localtime(&nowC);
+        frame.date[0]           = 1900.0f + static_cast<float>(currentTime->tm_year);
+        frame.date[1]           = 1.0f + static_cast<float>(currentTime->tm_mon);
+        frame.date[2]           = static_cast<float>(currentTime->tm_mday);
+        frame.date[3]           = static_cast<float>((currentTime->tm_hour * 60 + currentTime->tm_min) * 60 + currentTime->tm_sec);
+
+        // The scroll is left to the overlay
+        MouseState mouse       = getMouseState(false);
+        bool       mouseDown[] = {mouse.leftButton, mouse.rightButton, mouse.middleButton};
+        frame.mouseDelta[0]    = frame.frameCount ? mouse.x - frame.mousePoint[0] : 0.0f;
+        frame.mouseDelta[1]    = frame.frameCount ? mouse.y - frame.mousePoint[1] : 0.0f;
+        frame.mousePoint[0]    = static_cast<float>(mouse.x);
+        frame.mousePoint[1]    = static_cast<float>(mouse.y);
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            frame.mousePressed[i] = mouseDown[i] && !frame.mouseDown[i];
+            frame.mouseDown[i]    = mouseDown[i];
+        }
+
+        std::bitset<256> keysDown;
+        {
+            std::lock_guard<std::mutex> lock(watchedKeysMutex);
+            for (const auto& [keyCode, key] : watchedKeys)
+                keysDown[keyCode] = key.keySym && isKeyPressed(key.keySym);
+        }
+        frame.keysPressed = keysDown & ~frame.keysDown;
+        frame.keysDown    = keysDown;
+
+        frame.overlayOpen       = overlay.open;
+        frame.activeParamEffect = overlay.open ? overlay.activeParamEffect : "";
+        frame.activeParamIndex  = overlay.open ? overlay.activeParamIndex : 0;
+    }
+
+    void watchKey(uint32_t keyCode)
+    {
+        if (keyCode >= 256)
+            return;
+        std::lock_guard<std::mutex> lock(watchedKeysMutex);
+        auto                        key = watchedKeys.find(keyCode);
+        if (key != watchedKeys.end())
+        {
+            key->second.watchers++;
+            return;
+        }
+
+        std::string name = getKeyName(keyCode);
+        if (name.empty())
+            Logger::warn("unsupported ReShade key code " + std::to_string(keyCode));
+        watchedKeys[keyCode] = {name.empty() ? 0u : convertToKeySym(name), 1};
+    }
+
+    void unwatchKey(uint32_t keyCode)
+    {
+        std::lock_guard<std::mutex> lock(watchedKeysMutex);
+        auto                        key = watchedKeys.find(keyCode);
+        if (key != watchedKeys.end() && --key->second.watchers == 0)
+            watchedKeys.erase(key);
+    }
+} // namespace vkBasalt
@@ -0,0 +1,49 @@
+#ifndef FRAME_CONTEXT_HPP_INCLUDED
+#define FRAME_CONTEXT_HPP_INCLUDED
+#include <bitset>
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+namespace vkBasalt
+{
+    // What the uniforms of all effects read about the current frame, sampled once per present
+    struct FrameContext
+    {
+        std::chrono::high_resolution_clock::time_point startTime;  // Of the first frame
+        std::chrono::high_resolution_clock::time_point time;
+        float   timer         = 0.0f;  // Milliseconds since the first frame
+        float   frameTime     = 0.0f;  // Milliseconds since the previous frame
+        int32_t frameCount    = -1;    // 0 on the first frame
+        float   date[4]       = {};    // Year, month, day, seconds since midnight
+        float   mousePoint[2] = {};
+        float   mouseDelta[2] = {};
+
+        // By ReShade key code, the mouse buttons are left, right, middle
+        std::bitset<256> keysDown;
+        std::bitset<256> keysPressed;  // Went down this frame
+        bool             mouseDown[3]    = {};
+        bool             mousePressed[3] = {};
+
+        bool        overlayOpen       = false;
+        std::string activeParamEffect;         // Effect whose parameter the overlay is editing
+        uint32_t    activeParamIndex  = 0;     // 1-based in the effect's parameter list, 0 if none
+        bool        screenshot        = false;  // The layer takes no screenshots yet
+    };
+
+    struct FrameOverlayState
+    {
+        bool        open = false;
+        std::string activeParamEffect;
+        uint32_t    activeParamIndex = 0;
+    };
+
+    // Advance to the next frame, reading the clock and the input once
+    void updateFrameContext(FrameContext& frame, const FrameOverlayState& overlay);
+
+    // Key uniforms register the ReShade (Windows virtual) key codes they read, only those are sampled
+    void watchKey(uint32_t keyCode);
+    void unwatchKey(uint32_t keyCode);
+} // namespace vkBasalt
+
+#endif // FRAME_CONTEXT_HPP_INCLUDED
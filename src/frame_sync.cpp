@@ -0,0 +1,162 @@
+#include "frame_sync.hpp"
+
+#include "logical_device.hpp"
+#include "logger.hpp"
+
+namespace vkBasalt
+{
+    VkFence getSubmitFence(LogicalDevice* pLogicalDevice)
+    {
+        FrameSync& sync = pLogicalDevice->frameSync;
+
+        VkFence fence;
+        if (!sync.freeFences.empty())
+        {
+            fence = sync.freeFences.back();
+            sync.freeFences.pop_back();
+            VkResult result = pLogicalDevice->vkd.ResetFences(pLogicalDevice->device, 1, &fence);
+            ASSERT_VULKAN(result);
+        }
+        else
+        {
+            VkFenceCreateInfo fenceInfo = {};
+            fenceInfo.sType             = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+            VkResult result = pLogicalDevice->vkd.CreateFence(pLogicalDevice->device, &fenceInfo, nullptr, &fence);
+            ASSERT_VULKAN(result);
+        }
+
+        sync.pendingFences.emplace_back(++sync.submitSerial, fence);
+        return fence;
+    }
+
+    void retireResources(LogicalDevice* pLogicalDevice, std::function<void()> destroy)
+    {
+        FrameSync& sync = pLogicalDevice->frameSync;
+        if (sync.submitSerial == sync.completedSerial)
+        {
+            destroy();  // Nothing in flight
+            return;
+        }
+        sync.retired.emplace_back(sync.submitSerial, std::move(destroy));
+    }
+
+    void releaseRetiredResources(LogicalDevice* pLogicalDevice)
+    {
+        FrameSync& sync = pLogicalDevice->frameSync;
+
+        while (!sync.pendingFences.empty())
+        {
+            auto [serial, fence] = sync.pendingFences.front();
+            if (pLogicalDevice->vkd.GetFenceStatus(pLogicalDevice->device, fence) != VK_SUCCESS)
+                break;
+            sync.completedSerial = serial;
+            sync.freeFences.push_back(fence);
+            sync.pendingFences.pop_front();
+        }
+
+        while (!sync.retired.empty() && sync.retired.front().first <= sync.completedSerial)
+        {
+            sync.retired.front().second();
+            sync.retired.pop_front();
+        }
+    }
+
+    void waitForSubmit(LogicalDevice* pLogicalDevice, uint64_t serial)
+    {
+        FrameSync& sync = pLogicalDevice->frameSync;
+        if (serial <= sync.completedSerial)
+            return;
+
+        for (const auto& [pendingSerial, fence] : sync.pendingFences)
+        {
+            if (pendingSerial < serial)
+                continue;
+            VkResult result = pLogicalDevice->vkd.WaitForFences(pLogicalDevice->device, 1, &fence, VK_TRUE, UINT64_MAX);
+            ASSERT_VULKAN(result);
+            break;
+        }
+        releaseRetiredResources(pLogicalDevice);
+    }
+
+    VkCommandBuffer getUploadCommandBuffer(LogicalDevice* pLogicalDevice)
+    {
+        FrameSync& sync = pLogicalDevice->frameSync;
+        if (sync.uploadCommandBuffer != VK_NULL_HANDLE)
+            return sync.uploadCommandBuffer;
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+
+        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool        = pLogicalDevice->commandPool;
+        allocInfo.commandBufferCount = 1;
+
+        VkResult result = pLogicalDevice->vkd.AllocateCommandBuffers(pLogicalDevice->device, &allocInfo, &sync.uploadCommandBuffer);
+        ASSERT_VULKAN(result);
+        // initialize dispatch table for commandBuffer since it is a dispatchable object
+        initializeDispatchTable(sync.uploadCommandBuffer, pLogicalDevice->device);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        pLogicalDevice->vkd.BeginCommandBuffer(sync.uploadCommandBuffer, &beginInfo);
+        return sync.uploadCommandBuffer;
+    }
+
+    void addUploadResource(LogicalDevice* pLogicalDevice, std::function<void()> destroy)
+    {
+        pLogicalDevice->frameSync.uploadResources.push_back(std::move(destroy));
+    }
+
+    void flushUploads(LogicalDevice* pLogicalDevice)
+    {
+        FrameSync& sync = pLogicalDevice->frameSync;
+        if (sync.uploadCommandBuffer == VK_NULL_HANDLE)
+            return;
+
+        VkCommandBuffer commandBuffer = sync.uploadCommandBuffer;
+        sync.uploadCommandBuffer      = VK_NULL_HANDLE;
+        pLogicalDevice->vkd.EndCommandBuffer(commandBuffer);
+
+        VkSubmitInfo submitInfo       = {};
+        submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers    = &commandBuffer;
+
+        // Barriers in the upload command buffer make later submits on the queue wait for it, no semaphore needed
+        VkResult result = pLogicalDevice->vkd.QueueSubmit(pLogicalDevice->queue, 1, &submitInfo, getSubmitFence(pLogicalDevice));
+        ASSERT_VULKAN(result);
+        Logger::debug("submitted " + std::to_string(sync.uploadResources.size()) + " batched uploads");
+
+        std::vector<std::function<void()>> resources = std::move(sync.uploadResources);
+        sync.uploadResources.clear();
+        retireResources(pLogicalDevice, [pLogicalDevice, commandBuffer, resources = std::move(resources)]() {
+            pLogicalDevice->vkd.FreeCommandBuffers(pLogicalDevice->device, pLogicalDevice->commandPool, 1, &commandBuffer);
+            for (const auto& destroy : resources)
+                destroy();
+        });
+    }
+
+    void destroyFrameSync(LogicalDevice* pLogicalDevice)
+    {
+        FrameSync& sync = pLogicalDevice->frameSync;
+
+        flushUploads(pLogicalDevice);
+        pLogicalDevice->vkd.QueueWaitIdle(pLogicalDevice->queue);
+
+        for (auto& [serial, destroy] : sync.retired)
+            destroy();
+        sync.retired.clear();
+
+        for (auto& [serial, fence] : sync.pendingFences)
+            pLogicalDevice->vkd.DestroyFence(pLogicalDevice->device, fence, nullptr);
+        for (auto& fence : sync.freeFences)
+            pLogicalDevice->vkd.DestroyFence(pLogicalDevice->device, fence, nullptr);
+        sync.pendingFences.clear();
+        sync.freeFences.clear();
+        sync.completedSerial = sync.submitSerial;
+    }
+} // namespace vkBasalt
@@ -0,0 +1,54 @@
+#ifndef FRAME_SYNC_HPP_INCLUDED
+#define FRAME_SYNC_HPP_INCLUDED
+#include <deque>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <cstdint>
+
+#include "vulkan_include.hpp"
+
+namespace vkBasalt
+{
+    struct LogicalDevice;
+
+    // Tracks the layer's own submits on the device queue, so resources that frames in flight may still use
+    // are released once those frames complete instead of after a QueueWaitIdle.
+    // A signaled fence implies every earlier submit on the queue is complete, so submits are simply numbered.
+    struct FrameSync
+    {
+        std::deque<std::pair<uint64_t, VkFence>>               pendingFences;        // Submits not known to be complete, oldest first
+        std::vector<VkFence>                                   freeFences;
+        uint64_t                                               submitSerial    = 0;  // Latest layer submit
+        uint64_t                                               completedSerial = 0;  // Every submit up to this one is complete
+        std::deque<std::pair<uint64_t, std::function<void()>>> retired;              // Destroy callbacks and the submit they wait for
+        VkCommandBuffer                                        uploadCommandBuffer = VK_NULL_HANDLE;
+        std::vector<std::function<void()>>                     uploadResources;      // Staging buffers of the recorded uploads
+    };
+
+    // Fence for the next layer submit on the device queue
+    VkFence getSubmitFence(LogicalDevice* pLogicalDevice);
+
+    // Destroy something once every layer submit made so far is complete
+    void retireResources(LogicalDevice* pLogicalDevice, std::function<void()> destroy);
+
+    // Release retired resources whose submits completed (call once per frame)
+    void releaseRetiredResources(LogicalDevice* pLogicalDevice);
+
+    // Block until the layer submit with this serial is complete
+    void waitForSubmit(LogicalDevice* pLogicalDevice, uint64_t serial);
+
+    // Command buffer collecting texture uploads and layout changes, submitted at once by flushUploads
+    VkCommandBuffer getUploadCommandBuffer(LogicalDevice* pLogicalDevice);
+
+    // Keep a staging resource alive until the recorded uploads were executed
+    void addUploadResource(LogicalDevice* pLogicalDevice, std::function<void()> destroy);
+
+    // Submit the recorded uploads, must happen before any submit that samples the uploaded images
+    void flushUploads(LogicalDevice* pLogicalDevice);
+
+    // Wait for the queue and release everything (device destruction)
+    void destroyFrameSync(LogicalDevice* pLogicalDevice);
+} // namespace vkBasalt
+
+#endif // FRAME_SYNC_HPP_INCLUDED
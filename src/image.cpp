@@ -2,20 +2,12 @@
 #include "memory.hpp"
 #include "buffer.hpp"
 #include "format.hpp"
+#include "frame_sync.hpp"
 
 namespace vkBasalt
 {
-    std::vector<VkImage> createImages(LogicalDevice*        pLogicalDevice,
-                                      uint32_t              count,
-                                      VkExtent3D            extent,
-                                      VkFormat              format,
-                                      VkImageUsageFlags     usage,
-                                      VkMemoryPropertyFlags properties,
-                                      VkDeviceMemory&       imageMemory,
-                                      uint32_t              mipLevels)
+    VkImage createUnboundImage(LogicalDevice* pLogicalDevice, VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, uint32_t mipLevels)
     {
-        std::vector<VkImage> images(count);
-
         VkFormat srgbFormat  = isSRGB(format) ? format : convertToSRGB(format);
         VkFormat unormFormat = isSRGB(format) ? convertToUNORM(format) : format;
 
@@ -51,12 +43,28 @@ namespace vkBasalt
         imageCreateInfo.pQueueFamilyIndices   = nullptr; // Don't care
         imageCreateInfo.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
 
-        VkResult result;
+        VkImage  image;
+        VkResult result = pLogicalDevice->vkd.CreateImage(pLogicalDevice->device, &imageCreateInfo, nullptr, &image);
+        ASSERT_VULKAN(result);
+        return image;
+    }
+
+    std::vector<VkImage> createImages(LogicalDevice*        pLogicalDevice,
+                                      uint32_t              count,
+                                      VkExtent3D            extent,
+                                      VkFormat              format,
+                                      VkImageUsageFlags     usage,
+                                      VkMemoryPropertyFlags properties,
+                                      VkDeviceMemory&       imageMemory,
+                                      uint32_t              mipLevels)
+    {
+        std::vector<VkImage> images(count);
+
         for (uint32_t i = 0; i < count; i++)
         {
-            result = pLogicalDevice->vkd.CreateImage(pLogicalDevice->device, &imageCreateInfo, nullptr, &(images[i]));
-            ASSERT_VULKAN(result);
+            images[i] = createUnboundImage(pLogicalDevice, extent, format, usage, mipLevels);
         }
+
         // Allocate a bunch of memory for all images at one
         VkMemoryRequirements memoryRequirements;
         pLogicalDevice->vkd.GetImageMemoryRequirements(pLogicalDevice->device, images[0], &memoryRequirements);
@@ -72,7 +80,7 @@ namespace vkBasalt
         memoryAllocateInfo.allocationSize  = memoryRequirements.size * count;
         memoryAllocateInfo.memoryTypeIndex = findMemoryTypeIndex(pLogicalDevice, memoryRequirements.memoryTypeBits, properties);
 
-        result = pLogicalDevice->vkd.AllocateMemory(pLogicalDevice->device, &memoryAllocateInfo, nullptr, &imageMemory);
+        VkResult result = pLogicalDevice->vkd.AllocateMemory(pLogicalDevice->device, &memoryAllocateInfo, nullptr, &imageMemory);
         ASSERT_VULKAN(result);
 
         for (uint32_t i = 0; i < count; i++)
@@ -102,24 +110,8 @@ namespace vkBasalt
         std::memcpy(data, writeData, size);
         pLogicalDevice->vkd.UnmapMemory(pLogicalDevice->device, stagingMemory);
 
-        VkCommandBufferAllocateInfo allocInfo = {};
-
-        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool        = pLogicalDevice->commandPool;
-        allocInfo.commandBufferCount = 1;
-
-        VkCommandBuffer commandBuffer;
-        pLogicalDevice->vkd.AllocateCommandBuffers(pLogicalDevice->device, &allocInfo, &commandBuffer);
-        // initialize dispatch table for commandBuffer since it is a dispatchable object
-        initializeDispatchTable(commandBuffer, pLogicalDevice->device);
-
-        VkCommandBufferBeginInfo beginInfo = {};
-
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        pLogicalDevice->vkd.BeginCommandBuffer(commandBuffer, &beginInfo);
+        // Recorded into the frame's upload batch, submitted once before the next effect submit
+        VkCommandBuffer commandBuffer = getUploadCommandBuffer(pLogicalDevice);
 
         VkImageMemoryBarrier memoryBarrier;
         memoryBarrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -163,42 +155,16 @@ namespace vkBasalt
 
         generateMipMaps(pLogicalDevice, commandBuffer, image, extent, mipLevels);
 
-        pLogicalDevice->vkd.EndCommandBuffer(commandBuffer);
-
-        VkSubmitInfo submitInfo = {};
-
-        submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers    = &commandBuffer;
-
-        pLogicalDevice->vkd.QueueSubmit(pLogicalDevice->queue, 1, &submitInfo, VK_NULL_HANDLE);
-        pLogicalDevice->vkd.QueueWaitIdle(pLogicalDevice->queue);
-
-        pLogicalDevice->vkd.FreeCommandBuffers(pLogicalDevice->device, pLogicalDevice->commandPool, 1, &commandBuffer);
-        pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, stagingMemory, nullptr);
-        pLogicalDevice->vkd.DestroyBuffer(pLogicalDevice->device, stagingBuffer, nullptr);
+        addUploadResource(pLogicalDevice, [pLogicalDevice, stagingBuffer, stagingMemory]() {
+            pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, stagingMemory, nullptr);
+            pLogicalDevice->vkd.DestroyBuffer(pLogicalDevice->device, stagingBuffer, nullptr);
+        });
     }
 
     void changeImageLayout(LogicalDevice* pLogicalDevice, std::vector<VkImage> images, uint32_t mipLevels)
     {
-        VkCommandBufferAllocateInfo allocInfo = {};
-
-        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandPool        = pLogicalDevice->commandPool;
-        allocInfo.commandBufferCount = 1;
-
-        VkCommandBuffer commandBuffer;
-        pLogicalDevice->vkd.AllocateCommandBuffers(pLogicalDevice->device, &allocInfo, &commandBuffer);
-        // initialize dispatch table for commandBuffer since it is a dispatchable object
-        initializeDispatchTable(commandBuffer, pLogicalDevice->device);
-
-        VkCommandBufferBeginInfo beginInfo = {};
-
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        pLogicalDevice->vkd.BeginCommandBuffer(commandBuffer, &beginInfo);
+        // Recorded into the frame's upload batch, submitted once before the next effect submit
+        VkCommandBuffer commandBuffer = getUploadCommandBuffer(pLogicalDevice);
 
         VkImageMemoryBarrier memoryBarrier;
         memoryBarrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -222,18 +188,6 @@ namespace vkBasalt
             pLogicalDevice->vkd.CmdPipelineBarrier(
                 commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &memoryBarrier);
         }
-
-        pLogicalDevice->vkd.EndCommandBuffer(commandBuffer);
-
-        VkSubmitInfo submitInfo       = {};
-        submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers    = &commandBuffer;
-
-        pLogicalDevice->vkd.QueueSubmit(pLogicalDevice->queue, 1, &submitInfo, VK_NULL_HANDLE);
-        pLogicalDevice->vkd.QueueWaitIdle(pLogicalDevice->queue);
-
-        pLogicalDevice->vkd.FreeCommandBuffers(pLogicalDevice->device, pLogicalDevice->commandPool, 1, &commandBuffer);
     }
 
     void generateMipMaps(LogicalDevice* pLogicalDevice, VkCommandBuffer commandBuffer, VkImage image, VkExtent3D extent, uint32_t mipLevels)
@@ -14,6 +14,9 @@
 
 namespace vkBasalt
 {
+    // Image without memory, for callers binding it themselves
+    VkImage createUnboundImage(LogicalDevice* pLogicalDevice, VkExtent3D extent, VkFormat format, VkImageUsageFlags usage, uint32_t mipLevels = 1);
+
     std::vector<VkImage> createImages(LogicalDevice*        pLogicalDevice,
                                       uint32_t              count,
                                       VkExtent3D            extent,
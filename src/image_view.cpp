@@ -1,4 +1,5 @@
 #include "image_view.hpp"
+#include "format.hpp"
 
 namespace vkBasalt
 {
@@ -30,9 +31,18 @@ namespace vkBasalt
         imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
         imageViewCreateInfo.subresourceRange.layerCount     = 1;
 
+        // Storage images are also viewed in formats without storage support (sRGB), those views must not inherit the usage
+        VkImageViewUsageCreateInfo usageCreateInfo = {};
+        usageCreateInfo.sType                      = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO;
+        usageCreateInfo.usage                      = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        // (depth views are created without globalLock, they never need this)
+        bool restrictUsage = aspectMask == VK_IMAGE_ASPECT_COLOR_BIT && !pLogicalDevice->storageImages.empty()
+                             && !isStorageFormat(pLogicalDevice, format);
+
         for (uint32_t i = 0; i < images.size(); i++)
         {
             imageViewCreateInfo.image = images[i];
+            imageViewCreateInfo.pNext = restrictUsage && pLogicalDevice->storageImages.count(images[i]) ? &usageCreateInfo : nullptr;
             VkResult result           = pLogicalDevice->vkd.CreateImageView(pLogicalDevice->device, &imageViewCreateInfo, nullptr, &(imageViews[i]));
             ASSERT_VULKAN(result);
         }
@@ -7,207 +7,386 @@
 #include <X11/XKBlib.h>
 #include <X11/extensions/XInput2.h>
 
-#include <memory>
-#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 #include <cstring>
 
 namespace vkBasalt
 {
-    static Display* kbDisplay = nullptr;
-    static int xiOpcode = 0;
-    static bool xiInitialized = false;
-    static std::string typedCharsAccumulator;
-    static std::string lastKeyNameAccumulator;
-    static bool backspacePressed = false;
-    static bool deletePressed = false;
-    static bool enterPressed = false;
-    static bool leftPressed = false;
-    static bool rightPressed = false;
-    static bool homePressed = false;
-    static bool endPressed = false;
-
-    static void initKeyboardX11()
+    // All Xlib calls happen on the input thread, which owns the display connection.
+    // The present thread only reads what it publishes, so it never waits for an X server round-trip.
+    class InputThreadX11
     {
-        if (kbDisplay)
-            return;
+    public:
+        ~InputThreadX11()
+        {
+            if (!thread.joinable())
+                return;
+            stopRequested = true;
+            wake();
+            thread.join();
+            close(wakeFd);
+            XCloseDisplay(display);
+        }
 
-        const char* disVar = getenv("DISPLAY");
-        if (!disVar || !*disVar)
-            return;
+        // Start on first use, false without X11
+        bool start()
+        {
+            std::call_once(startFlag, [this]() {
+                const char* disVar = getenv("DISPLAY");
+                if (!disVar || !*disVar)
+                {
+                    Logger::debug("no X11 support");
+                    return;
+                }
 
-        kbDisplay = XOpenDisplay(disVar);
-        if (!kbDisplay)
-            return;
+                display = XOpenDisplay(disVar);
+                if (!display)
+                    return;
 
-        int event, error;
-        if (XQueryExtension(kbDisplay, "XInputExtension", &xiOpcode, &event, &error))
-        {
-            int major = 2, minor = 0;
-            if (XIQueryVersion(kbDisplay, &major, &minor) == Success)
-            {
-                unsigned char mask[XIMaskLen(XI_RawKeyPress)] = {0};
+                int event, error;
+                int major = 2, minor = 0;
+                if (!XQueryExtension(display, "XInputExtension", &xiOpcode, &event, &error)
+                    || XIQueryVersion(display, &major, &minor) != Success)
+                {
+                    Logger::err("XInput2 not available, no hotkeys or overlay input");
+                    XCloseDisplay(display);
+                    display = nullptr;
+                    return;
+                }
+
+                unsigned char mask[XIMaskLen(XI_LASTEVENT)] = {0};
                 XISetMask(mask, XI_RawKeyPress);
+                XISetMask(mask, XI_RawKeyRelease);
+                XISetMask(mask, XI_RawButtonPress);
+                XISetMask(mask, XI_RawButtonRelease);
+                XISetMask(mask, XI_RawMotion);
 
                 XIEventMask eventMask = {XIAllMasterDevices, sizeof(mask), mask};
-                XISelectEvents(kbDisplay, DefaultRootWindow(kbDisplay), &eventMask, 1);
-                xiInitialized = true;
+                XISelectEvents(display, DefaultRootWindow(display), &eventMask, 1);
+
+                updateKeymap();
+                queryPointer();
+
+                wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                thread = std::thread(&InputThreadX11::run, this);
+                Logger::debug("X11 input thread started");
+            });
+            return thread.joinable();
+        }
+
+        bool isKeySymPressed(uint32_t keySym)
+        {
+            if (!keySym)
+                return false;
+            for (uint32_t keycode = 0; keycode < 256; keycode++)
+            {
+                if (keycodeSyms[keycode].load(std::memory_order_relaxed) == keySym
+                    && (pressedKeys[keycode >> 6].load(std::memory_order_relaxed) & (1ull << (keycode & 63))))
+                    return true;
             }
+            return false;
         }
-    }
 
-    uint32_t convertToKeySymX11(std::string key)
-    {
-        // TODO what if X11 isn't loaded?
-        uint32_t result = (uint32_t) XStringToKeysym(key.c_str());
-        if (!result)
+        KeyboardState takeKeyboardState()
         {
-            Logger::err("invalid key");
+            std::lock_guard<std::mutex> l(keyboardMutex);
+            KeyboardState state = keyboard;
+            keyboard            = KeyboardState();
+            return state;
         }
-        return result;
-    }
 
-    bool isKeyPressedX11(uint32_t ks)
-    {
-        static int usesX11 = -1;
+        MouseState getMouseState(bool takeScroll)
+        {
+            uint32_t buttons = pointerButtons.load(std::memory_order_relaxed);
+
+            MouseState state;
+            state.x            = pointerX.load(std::memory_order_relaxed);
+            state.y            = pointerY.load(std::memory_order_relaxed);
+            state.leftButton   = buttons & Button1Mask;
+            state.middleButton = buttons & Button2Mask;
+            state.rightButton  = buttons & Button3Mask;
+            state.scrollDelta  = takeScroll ? static_cast<float>(scrollSteps.exchange(0, std::memory_order_relaxed)) : 0.0f;
+            return state;
+        }
+
+        void setGrab(bool grab)
+        {
+            if (!start())
+                return;
+            grabRequested = grab;
+            wake();
+        }
 
-        static std::unique_ptr<Display, std::function<void(Display*)>> display;
+    private:
+        void wake()
+        {
+            uint64_t one = 1;
+            if (write(wakeFd, &one, sizeof(one)) < 0)
+                Logger::debug("failed to wake the input thread");
+        }
 
-        if (usesX11 < 0)
+        void run()
         {
-            const char* disVar = getenv("DISPLAY");
-            if (!disVar || !std::strcmp(disVar, ""))
+            pollfd fds[2] = {{ConnectionNumber(display), POLLIN, 0}, {wakeFd, POLLIN, 0}};
+            while (!stopRequested)
             {
-                usesX11 = 0;
-                Logger::debug("no X11 support");
+                bool pointerMoved = false;
+                while (XPending(display) > 0)
+                {
+                    XEvent ev;
+                    XNextEvent(display, &ev);
+                    pointerMoved |= processEvent(ev);
+                }
+                if (pointerMoved)
+                    queryPointer();
+
+                if (grabRequested != grabbed)
+                {
+                    if (grabRequested)
+                        grabInput();
+                    else
+                        ungrabInput();
+                }
+                XFlush(display);
+
+                poll(fds, 2, -1);
+                if (fds[1].revents & POLLIN)
+                {
+                    uint64_t count;
+                    if (read(wakeFd, &count, sizeof(count)) < 0)
+                        continue;
+                }
             }
-            else
+
+            // Unloading, no logging (the logger may already be gone)
+            if (grabbed)
             {
-                display = std::unique_ptr<Display, std::function<void(Display*)>>(XOpenDisplay(disVar), [](Display* d) { XCloseDisplay(d); });
-                usesX11 = 1;
-                Logger::debug("X11 support");
+                XUngrabKeyboard(display, CurrentTime);
+                XUngrabPointer(display, CurrentTime);
+                XFlush(display);
             }
         }
 
-        if (!usesX11)
+        // Returns true if the pointer state may have changed
+        bool processEvent(XEvent& ev)
         {
-            return false;
+            // Regular KeyPress events come from our own grab
+            if (ev.type == KeyPress || ev.type == KeyRelease)
+            {
+                setKeyPressed(ev.xkey.keycode, ev.type == KeyPress);
+                if (ev.type == KeyPress)
+                    processKeyPress(ev.xkey.keycode, ev.xkey.state & ShiftMask);
+                return false;
+            }
+            if (ev.type == MappingNotify)
+            {
+                XRefreshKeyboardMapping(&ev.xmapping);
+                updateKeymap();
+                return false;
+            }
+            if (ev.xcookie.type != GenericEvent || ev.xcookie.extension != xiOpcode || !XGetEventData(display, &ev.xcookie))
+                return false;
+
+            bool        pointerChanged = false;
+            XIRawEvent* rawEvent       = (XIRawEvent*) ev.xcookie.data;
+            switch (ev.xcookie.evtype)
+            {
+            // While grabbed the core KeyPress events above already carry every key
+            case XI_RawKeyPress:
+                if (grabbed)
+                    break;
+                setKeyPressed(rawEvent->detail, true);
+                processKeyPress(rawEvent->detail, isShiftPressed());
+                break;
+            case XI_RawKeyRelease:
+                if (!grabbed)
+                    setKeyPressed(rawEvent->detail, false);
+                break;
+            case XI_RawButtonPress:
+                if (rawEvent->detail == 4)
+                    scrollSteps.fetch_add(1, std::memory_order_relaxed);
+                else if (rawEvent->detail == 5)
+                    scrollSteps.fetch_sub(1, std::memory_order_relaxed);
+                pointerChanged = true;
+                break;
+            case XI_RawButtonRelease:
+            case XI_RawMotion: pointerChanged = true; break;
+            }
+            XFreeEventData(display, &ev.xcookie);
+            return pointerChanged;
         }
 
-        char keys_return[32];
+        void setKeyPressed(uint32_t keycode, bool pressed)
+        {
+            if (keycode >= 256)
+                return;
+            uint64_t bit = 1ull << (keycode & 63);
+            if (pressed)
+                pressedKeys[keycode >> 6].fetch_or(bit, std::memory_order_relaxed);
+            else
+                pressedKeys[keycode >> 6].fetch_and(~bit, std::memory_order_relaxed);
+        }
 
-        XQueryKeymap(display.get(), keys_return);
+        bool isShiftPressed()
+        {
+            return isKeySymPressed(XK_Shift_L) || isKeySymPressed(XK_Shift_R);
+        }
 
-        KeyCode kc2 = XKeysymToKeycode(display.get(), (KeySym) ks);
+        // Unshifted keysym of every keycode, so hotkeys are looked up without Xlib
+        void updateKeymap()
+        {
+            for (uint32_t keycode = 8; keycode < 256; keycode++)
+                keycodeSyms[keycode].store((uint32_t) XkbKeycodeToKeysym(display, keycode, 0, 0), std::memory_order_relaxed);
+        }
 
-        return !!(keys_return[kc2 >> 3] & (1 << (kc2 & 7)));
-    }
+        // Pointer position relative to the focused window (the game)
+        void queryPointer()
+        {
+            Window       focused, root, child;
+            int          revertTo, rootX, rootY, x, y;
+            unsigned int mask;
 
-    // Helper to process a keycode and update state
-    static void processKeycode(KeyCode keycode, unsigned int state)
-    {
-        KeySym keysym = XkbKeycodeToKeysym(kbDisplay, keycode, 0, 0);
-
-        // Capture key name for keybind editor (skip modifier keys)
-        if (keysym != XK_Shift_L && keysym != XK_Shift_R &&
-            keysym != XK_Control_L && keysym != XK_Control_R &&
-            keysym != XK_Alt_L && keysym != XK_Alt_R &&
-            keysym != XK_Super_L && keysym != XK_Super_R)
-        {
-            const char* keyName = XKeysymToString(keysym);
-            if (keyName)
-                lastKeyNameAccumulator = keyName;
-        }
-
-        // Handle special keys
-        if (keysym == XK_BackSpace) backspacePressed = true;
-        else if (keysym == XK_Delete) deletePressed = true;
-        else if (keysym == XK_Return || keysym == XK_KP_Enter) enterPressed = true;
-        else if (keysym == XK_Left) leftPressed = true;
-        else if (keysym == XK_Right) rightPressed = true;
-        else if (keysym == XK_Home) homePressed = true;
-        else if (keysym == XK_End) endPressed = true;
-        else
-        {
-            // Check shifted state (from event state or keyboard query)
-            bool shifted = (state & ShiftMask) != 0;
-            if (!shifted)
-            {
-                char keys[32];
-                XQueryKeymap(kbDisplay, keys);
-                shifted = (keys[XKeysymToKeycode(kbDisplay, XK_Shift_L) >> 3] & (1 << (XKeysymToKeycode(kbDisplay, XK_Shift_L) & 7))) ||
-                          (keys[XKeysymToKeycode(kbDisplay, XK_Shift_R) >> 3] & (1 << (XKeysymToKeycode(kbDisplay, XK_Shift_R) & 7)));
-            }
+            XGetInputFocus(display, &focused, &revertTo);
+            if (focused == None || focused == PointerRoot)
+                focused = DefaultRootWindow(display);
 
-            KeySym actualSym = XkbKeycodeToKeysym(kbDisplay, keycode, 0, shifted ? 1 : 0);
-            if (actualSym >= 0x20 && actualSym <= 0x7E)
+            if (XQueryPointer(display, focused, &root, &child, &rootX, &rootY, &x, &y, &mask))
             {
-                typedCharsAccumulator += (char)actualSym;
+                pointerX.store(x, std::memory_order_relaxed);
+                pointerY.store(y, std::memory_order_relaxed);
+                pointerButtons.store(mask, std::memory_order_relaxed);
             }
         }
-    }
 
-    KeyboardState getKeyboardStateX11()
-    {
-        KeyboardState state;
+        void processKeyPress(KeyCode keycode, bool shifted)
+        {
+            KeySym keysym = XkbKeycodeToKeysym(display, keycode, 0, 0);
 
-        initKeyboardX11();
-        if (!kbDisplay || !xiInitialized)
-            return state;
+            std::lock_guard<std::mutex> l(keyboardMutex);
+
+            // Capture key name for keybind editor (skip modifier keys)
+            if (keysym != XK_Shift_L && keysym != XK_Shift_R &&
+                keysym != XK_Control_L && keysym != XK_Control_R &&
+                keysym != XK_Alt_L && keysym != XK_Alt_R &&
+                keysym != XK_Super_L && keysym != XK_Super_R)
+            {
+                const char* keyName = XKeysymToString(keysym);
+                if (keyName)
+                    keyboard.lastKeyName = keyName;
+            }
 
-        // Process keyboard events
-        while (XPending(kbDisplay) > 0)
+            // Handle special keys
+            if (keysym == XK_BackSpace) keyboard.backspace = true;
+            else if (keysym == XK_Delete) keyboard.del = true;
+            else if (keysym == XK_Return || keysym == XK_KP_Enter) keyboard.enter = true;
+            else if (keysym == XK_Left) keyboard.left = true;
+            else if (keysym == XK_Right) keyboard.right = true;
+            else if (keysym == XK_Home) keyboard.home = true;
+            else if (keysym == XK_End) keyboard.end = true;
+            else
+            {
+                KeySym actualSym = XkbKeycodeToKeysym(display, keycode, 0, shifted ? 1 : 0);
+                if (actualSym >= 0x20 && actualSym <= 0x7E)
+                    keyboard.typedChars += (char) actualSym;
+            }
+        }
+
+        void grabInput()
         {
-            XEvent ev;
-            XNextEvent(kbDisplay, &ev);
+            Window root = DefaultRootWindow(display);
+
+            // Grab both keyboard and mouse
+            int kbResult = XGrabKeyboard(display, root, False, GrabModeAsync, GrabModeAsync, CurrentTime);
+            int ptrResult = XGrabPointer(display, root, False,
+                                         ButtonPressMask | ButtonReleaseMask | PointerMotionMask,
+                                         GrabModeAsync, GrabModeAsync, None, None, CurrentTime);
 
-            // Handle regular KeyPress events (from grab)
-            if (ev.type == KeyPress)
+            if (kbResult == GrabSuccess && ptrResult == GrabSuccess)
             {
-                processKeycode(ev.xkey.keycode, ev.xkey.state);
+                grabbed = true;
+                Logger::debug("Input grabbed for overlay");
             }
-            // Handle XInput2 raw events (normal operation)
-            else if (ev.xcookie.type == GenericEvent && ev.xcookie.extension == xiOpcode &&
-                XGetEventData(kbDisplay, &ev.xcookie))
+            else
             {
-                if (ev.xcookie.evtype == XI_RawKeyPress)
-                {
-                    XIRawEvent* rawEvent = (XIRawEvent*)ev.xcookie.data;
-                    processKeycode(rawEvent->detail, 0);
-                }
-                XFreeEventData(kbDisplay, &ev.xcookie);
+                if (kbResult == GrabSuccess)
+                    XUngrabKeyboard(display, CurrentTime);
+                if (ptrResult == GrabSuccess)
+                    XUngrabPointer(display, CurrentTime);
+                grabRequested = false;  // Don't retry every event
+                Logger::debug("Failed to grab input");
             }
         }
 
-        state.typedChars = typedCharsAccumulator;
-        state.lastKeyName = lastKeyNameAccumulator;
-        state.backspace = backspacePressed;
-        state.del = deletePressed;
-        state.enter = enterPressed;
-        state.left = leftPressed;
-        state.right = rightPressed;
-        state.home = homePressed;
-        state.end = endPressed;
-
-        // Reset accumulators
-        typedCharsAccumulator.clear();
-        lastKeyNameAccumulator.clear();
-        backspacePressed = false;
-        deletePressed = false;
-        enterPressed = false;
-        leftPressed = false;
-        rightPressed = false;
-        homePressed = false;
-        endPressed = false;
-
-        return state;
+        void ungrabInput()
+        {
+            XUngrabKeyboard(display, CurrentTime);
+            XUngrabPointer(display, CurrentTime);
+            grabbed = false;
+            Logger::debug("Input released from overlay");
+        }
+
+        std::once_flag    startFlag;
+        std::thread       thread;
+        Display*          display  = nullptr;
+        int               xiOpcode = 0;
+        int               wakeFd   = -1;
+        std::atomic<bool> stopRequested{false};
+        std::atomic<bool> grabRequested{false};
+        bool              grabbed = false;  // Input thread only
+
+        // Published state
+        std::atomic<uint64_t> pressedKeys[4] = {};  // Bit per keycode
+        std::atomic<uint32_t> keycodeSyms[256] = {};
+        std::atomic<int>      pointerX{0};
+        std::atomic<int>      pointerY{0};
+        std::atomic<uint32_t> pointerButtons{0};
+        std::atomic<int>      scrollSteps{0};  // Positive = up, since the last getMouseState
+
+        std::mutex    keyboardMutex;  // Typed text since the last takeKeyboardState
+        KeyboardState keyboard;
+    };
+
+    static InputThreadX11 inputThread;
+
+    uint32_t convertToKeySymX11(std::string key)
+    {
+        // TODO what if X11 isn't loaded?
+        uint32_t result = (uint32_t) XStringToKeysym(key.c_str());
+        if (!result)
+        {
+            Logger::err("invalid key");
+        }
+        return result;
+    }
+
+    bool isKeyPressedX11(uint32_t ks)
+    {
+        return inputThread.start() && inputThread.isKeySymPressed(ks);
+    }
+
+    KeyboardState getKeyboardStateX11()
+    {
+        if (!inputThread.start())
+            return KeyboardState();
+        return inputThread.takeKeyboardState();
+    }
+
+    MouseState getMouseStateX11(bool takeScroll)
+    {
+        if (!inputThread.start())
+            return MouseState();
+        return inputThread.getMouseState(takeScroll);
     }
 
-    void* getKeyboardDisplay()
+    void setInputGrabX11(bool grab)
     {
-        initKeyboardX11();
-        return kbDisplay;
+        inputThread.setGrab(grab);
     }
 
 } // namespace vkBasalt
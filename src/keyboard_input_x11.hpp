@@ -3,13 +3,16 @@
 #include <cstdint>
 #include <string>
 #include "keyboard_input.hpp"
+#include "mouse_input.hpp"
 
 namespace vkBasalt
 {
+    // X11 input is read by a dedicated thread (XInput2 raw events), these only read what it published
     uint32_t convertToKeySymX11(std::string key);
     bool     isKeyPressedX11(uint32_t ks);
     KeyboardState getKeyboardStateX11();
+    MouseState    getMouseStateX11(bool takeScroll);
 
-    // For input blocking - returns the keyboard display connection
-    void* getKeyboardDisplay();
+    // For input blocking - the grab is done by the input thread
+    void setInputGrabX11(bool grab);
 } // namespace vkBasalt
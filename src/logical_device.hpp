@@ -6,9 +6,13 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <future>
+#include <unordered_set>
 
 #include "vulkan_include.hpp"
 #include "vkdispatch.hpp"
+#include "frame_sync.hpp"
 
 namespace vkBasalt
 {
@@ -22,13 +26,25 @@ namespace vkBasalt
         VkDevice                 device;
         VkPhysicalDevice         physicalDevice;
         VkInstance               instance;
-        VkQueue                  queue;
+        VkQueue                  queue;  // Layer submits, the app's first graphics queue or one of our own
+        bool                     separateQueue;  // queue is our own (effectQueue setting), the app never submits to it
         uint32_t                 queueFamilyIndex;
+        VkSemaphore              queueHandoffSemaphore;  // Orders our queue after the app's when present waits on nothing
+        VkSemaphore              queueReturnSemaphore;   // Orders the app's queue after our effect submits (separate queue only)
         VkCommandPool            commandPool;
+        VkPipelineCache          pipelineCache;
+        std::mutex               pipelineCacheLock;  // Serializes saves, they run from different threads
+        std::future<void>        pipelineCacheSave;  // Background save, done before the cache is destroyed (globalLock)
+        size_t                   pipelineCacheSavedSize;  // Size last written to disk, to skip redundant saves (pipelineCacheLock)
         bool                     supportsMutableFormat;
+        bool                     supportsStorageWrite;  // Compute effects can write the layer's images
+        bool                     supportsDynamicRendering;  // ReShade passes are recorded without render pass and framebuffer objects
+        std::unordered_set<VkImage> storageImages;      // Fake and swapchain images created with storage usage
+        std::mutex               depthLock;  // Guards the depth tracking, image calls don't take globalLock
         std::vector<VkImage>     depthImages;
         std::vector<VkFormat>    depthFormats;
         std::vector<VkImageView> depthImageViews;
+        FrameSync                frameSync;  // Deferred destruction and batched uploads
 
         // Persistent overlay state that survives swapchain recreation
         std::unique_ptr<OverlayPersistentState> overlayPersistentState;
@@ -7,7 +7,11 @@ namespace vkBasalt
         if (imageCount > 0)
         {
             effects.clear();
+            effectBindings.clear();
             defaultTransfer.reset();
+            stencilAttachment.reset();
+            renderTargetPool.reset();
+            uniformRing.reset();
 
             pLogicalDevice->vkd.FreeCommandBuffers(
                 pLogicalDevice->device, pLogicalDevice->commandPool, commandBuffersEffect.size(), commandBuffersEffect.data());
@@ -22,10 +26,13 @@ namespace vkBasalt
                 pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, fakeImages[i], nullptr);
             }
 
+            for (const auto& set : pingPongSets)
+                destroyFakeImageSet(pLogicalDevice, set);
+            pingPongSets.clear();
+
             for (unsigned int i = 0; i < imageCount; i++)
             {
                 pLogicalDevice->vkd.DestroySemaphore(pLogicalDevice->device, semaphores[i], nullptr);
-                pLogicalDevice->vkd.DestroySemaphore(pLogicalDevice->device, overlaySemaphores[i], nullptr);
             }
             Logger::debug("after DestroySemaphore");
 
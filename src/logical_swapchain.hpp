@@ -12,11 +12,24 @@
 #include "vulkan_include.hpp"
 
 #include "logical_device.hpp"
+#include "fake_swapchain.hpp"
+#include "stencil_attachment.hpp"
+#include "render_target_pool.hpp"
+#include "uniform_ring.hpp"
 
 namespace vkBasalt
 {
     class Config;
 
+    // What an effect of the chain was built from, so an incremental reload can keep it if nothing changed
+    struct EffectBinding
+    {
+        std::string             key;     // Effect identity (name, type, macros, baked parameters)
+        VkImage                 input;   // First input image, identifies the fake image slot read
+        VkImage                 output;  // First output image
+        std::shared_ptr<Effect> effect;
+    };
+
     // for each swapchain, we have the Images and the other stuff we need to execute the compute shader
     struct LogicalSwapchain
     {
@@ -25,17 +38,22 @@ namespace vkBasalt
         VkExtent2D                           imageExtent;
         VkFormat                             format;
         uint32_t                             imageCount;
+        bool                                 storageUsage = false;  // images were created with storage usage
         std::vector<VkImage>                 images;
         std::vector<VkImageView>             imageViews;  // for overlay rendering
-        std::vector<VkImage>                 fakeImages;
-        size_t                               maxEffectSlots = 0;  // Max number of effects supported
+        std::vector<VkImage>                 fakeImages;    // App's images, then the final output set without mutable format
+        std::vector<FakeImageSet>            pingPongSets;  // Between effects, allocated for the current chain length
+        std::shared_ptr<StencilAttachment>   stencilAttachment;  // Shared by the ReShade effects, allocated by the first one using stencil
+        std::shared_ptr<RenderTargetPool>    renderTargetPool;   // Memory of the ReShade effects' transient render targets
+        std::shared_ptr<UniformRing>         uniformRing;        // Uniforms of the current effects, rebuilt with the command buffers
         std::vector<VkCommandBuffer>         commandBuffersEffect;
         std::vector<VkCommandBuffer>         commandBuffersNoEffect;
         std::vector<VkSemaphore>             semaphores;
-        std::vector<VkSemaphore>             overlaySemaphores;
         std::vector<std::shared_ptr<Effect>> effects;
+        std::vector<EffectBinding>           effectBindings;  // Configured effects in effects (no pass-through)
         std::shared_ptr<Effect>              defaultTransfer;
         VkDeviceMemory                       fakeImageMemory;
+        VkDeviceSize                         fakeImageMemorySize = 0;
 
         void destroy();
         void reloadEffects(Config* pConfig);
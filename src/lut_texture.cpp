@@ -0,0 +1,82 @@
+#include "lut_texture.hpp"
+
+#include <stdexcept>
+
+#include "image.hpp"
+#include "image_view.hpp"
+#include "lut_cube.hpp"
+
+#include "stb_image.h"
+
+namespace vkBasalt
+{
+    LutTexture createLutTexture(LogicalDevice* pLogicalDevice, const std::string& lutFile)
+    {
+        if (lutFile.empty())
+        {
+            throw std::runtime_error("LUT effect requires 'lutFile' to be set in config");
+        }
+
+        LutTexture lutTexture;
+        int        height = 0;
+        LutCube    lutCube;
+        stbi_uc*   pixels   = nullptr;
+        int32_t    usingPNG = (int32_t)(lutFile.find(".cube") == std::string::npos && lutFile.find(".CUBE") == std::string::npos);
+        if (!usingPNG)
+        {
+            lutCube = LutCube(lutFile);
+            pixels  = lutCube.colorCube.data();
+            height  = lutCube.size;
+            if (height == 0 || pixels == nullptr)
+            {
+                throw std::runtime_error("Failed to load LUT cube file: " + lutFile);
+            }
+        }
+        else
+        {
+            int channels, width;
+            pixels = stbi_load(lutFile.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+            if (pixels == nullptr)
+            {
+                throw std::runtime_error("Failed to load LUT image file: " + lutFile);
+            }
+            if (width != height * height)
+            {
+                stbi_image_free(pixels);
+                throw std::runtime_error("Invalid LUT image dimensions (width must equal height*height): " + lutFile);
+            }
+        }
+
+        lutTexture.size   = height;
+        lutTexture.flipGB = usingPNG;
+
+        VkExtent3D lutImageExtent = {(uint32_t) height, (uint32_t) height, (uint32_t) height};
+
+        lutTexture.image = createImages(pLogicalDevice,
+                                        1,
+                                        lutImageExtent,
+                                        VK_FORMAT_R8G8B8A8_UNORM, // TODO search for format and save it
+                                        VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                        lutTexture.memory)[0];
+
+        uploadToImage(pLogicalDevice, lutTexture.image, lutImageExtent, height * height * height * 4, pixels);
+
+        if (usingPNG)
+        {
+            stbi_image_free(pixels);
+        }
+
+        lutTexture.view =
+            createImageViews(pLogicalDevice, VK_FORMAT_R8G8B8A8_UNORM, std::vector<VkImage>(1, lutTexture.image), VK_IMAGE_VIEW_TYPE_3D)[0];
+
+        return lutTexture;
+    }
+
+    void destroyLutTexture(LogicalDevice* pLogicalDevice, const LutTexture& lutTexture)
+    {
+        pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, lutTexture.view, nullptr);
+        pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, lutTexture.image, nullptr);
+        pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, lutTexture.memory, nullptr);
+    }
+} // namespace vkBasalt
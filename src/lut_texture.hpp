@@ -0,0 +1,27 @@
+#ifndef LUT_TEXTURE_HPP_INCLUDED
+#define LUT_TEXTURE_HPP_INCLUDED
+#include <string>
+
+#include "vulkan_include.hpp"
+
+#include "logical_device.hpp"
+
+namespace vkBasalt
+{
+    // 3D texture of a .cube or .png LUT, used by the lut effect and by effects a lut was fused into
+    struct LutTexture
+    {
+        VkImage        image  = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView    view   = VK_NULL_HANDLE;
+        int32_t        size   = 0;  // Edge length of the cube
+        int32_t        flipGB = 0;  // PNG LUTs store green and blue swapped
+    };
+
+    // Loads lutFile, throws if it is missing or invalid
+    LutTexture createLutTexture(LogicalDevice* pLogicalDevice, const std::string& lutFile);
+
+    void destroyLutTexture(LogicalDevice* pLogicalDevice, const LutTexture& lutTexture);
+} // namespace vkBasalt
+
+#endif // LUT_TEXTURE_HPP_INCLUDED
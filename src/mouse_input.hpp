@@ -15,7 +15,8 @@ namespace vkBasalt
         float scrollDelta = 0.0f;  // Positive = up, negative = down
     };
 
-    MouseState getMouseState();
+    // takeScroll: consume the scroll since the last call (the overlay does), otherwise scrollDelta stays 0
+    MouseState getMouseState(bool takeScroll = true);
 
 } // namespace vkBasalt
 
@@ -161,10 +161,10 @@ namespace vkBasalt
             ImGui_ImplVulkan_Shutdown();
         ImGui::DestroyContext();
 
-        for (auto fence : commandBufferFences)
+        for (auto framebuffer : framebuffers)
         {
-            if (fence != VK_NULL_HANDLE)
-                pLogicalDevice->vkd.DestroyFence(pLogicalDevice->device, fence, nullptr);
+            if (framebuffer != VK_NULL_HANDLE)
+                pLogicalDevice->vkd.DestroyFramebuffer(pLogicalDevice->device, framebuffer, nullptr);
         }
         if (commandPool != VK_NULL_HANDLE)
             pLogicalDevice->vkd.DestroyCommandPool(pLogicalDevice->device, commandPool, nullptr);
@@ -268,6 +268,27 @@ namespace vkBasalt
             }
         }
 
+        // Enabled techniques, only where they differ from the shader's defaults (format: effectName.techniques = A:B)
+        for (const auto& effectName : selectedEffects)
+        {
+            auto techniques = pEffectRegistry->getTechniques(effectName);
+            if (std::all_of(techniques.begin(), techniques.end(), [](const auto& t) { return t.enabled == t.defaultEnabled; }))
+                continue;
+
+            ConfigParam cp;
+            cp.effectName = effectName;
+            cp.paramName = "techniques";
+            for (const auto& technique : techniques)
+            {
+                if (!technique.enabled)
+                    continue;
+                if (!cp.value.empty())
+                    cp.value += ":";
+                cp.value += technique.name;
+            }
+            params.push_back(cp);
+        }
+
         // Collect disabled effects (from registry)
         std::vector<std::string> disabledEffects;
         for (const auto& effect : selectedEffects)
@@ -369,10 +390,11 @@ namespace vkBasalt
         VkSubpassDependency dependency = {};
         dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
         dependency.dstSubpass = 0;
-        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        // Submitted in the same batch as the effects, so wait for whatever wrote the image before
+        dependency.srcStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
         dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = 0;
-        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dependency.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
         VkRenderPassCreateInfo renderPassInfo = {};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -394,6 +416,7 @@ namespace vkBasalt
         initInfo.QueueFamily = pLogicalDevice->queueFamilyIndex;
         initInfo.Queue = pLogicalDevice->queue;
         initInfo.DescriptorPool = descriptorPool;
+        initInfo.PipelineCache = pLogicalDevice->pipelineCache;
         initInfo.MinImageCount = 2;
         initInfo.ImageCount = 2;
         initInfo.PipelineInfoMain.RenderPass = renderPass;
@@ -420,13 +443,9 @@ namespace vkBasalt
         allocInfo.commandBufferCount = imageCount;
         pLogicalDevice->vkd.AllocateCommandBuffers(pLogicalDevice->device, &allocInfo, commandBuffers.data());
 
-        // Create fences for command buffer synchronization (signaled initially so first frame doesn't wait)
-        commandBufferFences.resize(imageCount);
-        VkFenceCreateInfo fenceInfo = {};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-        for (uint32_t i = 0; i < imageCount; i++)
-            pLogicalDevice->vkd.CreateFence(pLogicalDevice->device, &fenceInfo, nullptr, &commandBufferFences[i]);
+        // Command buffers are tracked with the device's submit serials (0 = never submitted)
+        commandBufferSerials.assign(imageCount, 0);
+        framebuffers.assign(imageCount, VK_NULL_HANDLE);
 
         Logger::debug("ImGui Vulkan backend initialized");
     }
@@ -440,10 +459,10 @@ namespace vkBasalt
         currentWidth = width;
         currentHeight = height;
 
-        // Wait for previous use of this command buffer to complete
-        VkFence fence = commandBufferFences[imageIndex];
-        pLogicalDevice->vkd.WaitForFences(pLogicalDevice->device, 1, &fence, VK_TRUE, UINT64_MAX);
-        pLogicalDevice->vkd.ResetFences(pLogicalDevice->device, 1, &fence);
+        // Wait for previous use of this command buffer (and its framebuffer) to complete
+        waitForSubmit(pLogicalDevice, commandBufferSerials[imageIndex]);
+        if (framebuffers[imageIndex] != VK_NULL_HANDLE)
+            pLogicalDevice->vkd.DestroyFramebuffer(pLogicalDevice->device, framebuffers[imageIndex], nullptr);
 
         VkCommandBuffer cmd = commandBuffers[imageIndex];
 
@@ -453,8 +472,8 @@ namespace vkBasalt
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         pLogicalDevice->vkd.BeginCommandBuffer(cmd, &beginInfo);
 
-        // Create framebuffer for this image view
-        VkFramebuffer framebuffer;
+        // Create framebuffer for this image view, kept until the command buffer is reused
+        VkFramebuffer& framebuffer = framebuffers[imageIndex];
         VkFramebufferCreateInfo fbInfo = {};
         fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         fbInfo.renderPass = renderPass;
@@ -599,9 +618,6 @@ namespace vkBasalt
 
         pLogicalDevice->vkd.EndCommandBuffer(cmd);
 
-        // Destroy framebuffer (created per-frame)
-        pLogicalDevice->vkd.DestroyFramebuffer(pLogicalDevice->device, framebuffer, nullptr);
-
         return cmd;
     }
 
@@ -28,6 +28,7 @@ namespace vkBasalt
         std::string configPath;
         std::string configName;  // Just the filename (e.g., "tunic.conf")
         bool effectsEnabled = true;
+        VkDeviceSize effectImageMemory = 0;  // Bytes of fake/ping-pong images allocated for all swapchains
         // Parameters now read directly from EffectRegistry
     };
 
@@ -89,12 +90,17 @@ namespace vkBasalt
         void setSelectedEffects(const std::vector<std::string>& effects,
                                 const std::vector<std::string>& disabledEffects = {});
 
+        // Parameter being edited in the main view, index 1-based in getParametersForEffect order (0 if none)
+        const std::string& getActiveParamEffect() const { return activeParamEffect; }
+        uint32_t getActiveParamIndex() const { return activeParamIndex; }
+
         VkCommandBuffer recordFrame(uint32_t imageIndex, VkImageView imageView, uint32_t width, uint32_t height);
 
-        // Get fence for command buffer synchronization (used by basalt.cpp submit)
-        VkFence getCommandBufferFence(uint32_t imageIndex) const
+        // Layer submit the recorded command buffer went in, recordFrame waits for it before reusing the buffer
+        void setFrameSubmitted(uint32_t imageIndex, uint64_t submitSerial)
         {
-            return (imageIndex < commandBufferFences.size()) ? commandBufferFences[imageIndex] : VK_NULL_HANDLE;
+            if (imageIndex < commandBufferSerials.size())
+                commandBufferSerials[imageIndex] = submitSerial;
         }
 
     private:
@@ -119,7 +125,8 @@ namespace vkBasalt
         VkRenderPass renderPass = VK_NULL_HANDLE;
         VkCommandPool commandPool = VK_NULL_HANDLE;
         std::vector<VkCommandBuffer> commandBuffers;
-        std::vector<VkFence> commandBufferFences;  // Fences to track command buffer completion
+        std::vector<uint64_t> commandBufferSerials;  // FrameSync serial of the last submit using each command buffer
+        std::vector<VkFramebuffer> framebuffers;     // Per image, alive while its command buffer may be in flight
         VkFormat swapchainFormat = VK_FORMAT_UNDEFINED;
         uint32_t imageCount = 0;
         OverlayState state;
@@ -149,7 +156,6 @@ namespace vkBasalt
         int listeningForKey = 0;  // 0=none, 1=toggle, 2=reload, 3=overlay
         bool settingsSaved = false;  // True when settings saved, cleared by basalt.cpp
         bool shaderPathsChanged = false;  // True when shader manager saved, cleared by basalt.cpp
-        size_t maxEffects = 10;  // Cached from settingsManager for VRAM estimates
 
         // UI state for debug window
         int debugWindowTab = 0;  // 0=Registry, 1=Log
@@ -158,6 +164,8 @@ namespace vkBasalt
         int dragSourceIndex = -1;   // Index of effect being dragged, -1 if none
         int dragTargetIndex = -1;   // Index where effect will be dropped
         bool isDragging = false;    // True while actively dragging
+        std::string activeParamEffect;  // Parameter being edited, for "overlay_active" uniforms
+        uint32_t activeParamIndex = 0;
         bool applyRequested = false;
         bool toggleEffectsRequested = false;
         bool paramsDirty = false;  // True when params changed, waiting for debounce
@@ -166,7 +174,7 @@ namespace vkBasalt
         bool initialized = false;
         bool backendInitialized = false;
         bool dockLayoutInitialized = false;  // True after default dock layout is set up
-        uint32_t currentWidth = 1920;   // Current swapchain resolution for VRAM estimates
+        uint32_t currentWidth = 1920;   // Current swapchain resolution, shown with the VRAM use
         uint32_t currentHeight = 1080;
         char saveConfigName[64] = "";
         std::string pendingConfigPath;
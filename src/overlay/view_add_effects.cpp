@@ -1,6 +1,5 @@
 #include "imgui_overlay.hpp"
 #include "effects/effect_registry.hpp"
-#include "settings_manager.hpp"
 
 #include <algorithm>
 #include <cstring>
@@ -63,17 +62,12 @@ namespace vkBasalt
         }
 
         // Add Effects mode - two column layout
-        size_t maxEffectsLimit = static_cast<size_t>(settingsManager.getMaxEffects());
         if (insertPosition >= 0)
-            ImGui::Text("Insert Effects at position %d (max %zu)", insertPosition, maxEffectsLimit);
+            ImGui::Text("Insert Effects at position %d", insertPosition);
         else
-            ImGui::Text("Add Effects (max %zu)", maxEffectsLimit);
+            ImGui::Text("Add Effects");
         ImGui::Separator();
 
-        size_t currentCount = selectedEffects.size();
-        size_t pendingCount = pendingAddEffects.size();
-        size_t totalCount = currentCount + pendingCount;
-
         // Built-in effects
         std::vector<std::string> builtinEffects = {"cas", "dls", "fxaa", "smaa", "deband", "lut"};
 
@@ -102,10 +96,6 @@ namespace vkBasalt
 
         // Helper to render add button for an effect
         auto renderAddButton = [&](const std::string& effectType, const std::string& tooltip = "") {
-            bool atLimit = totalCount >= maxEffectsLimit;
-            if (atLimit)
-                ImGui::BeginDisabled();
-
             if (ImGui::Button(effectType.c_str(), ImVec2(-1, 0)))
             {
                 std::string instanceName = getNextInstanceName(effectType);
@@ -116,8 +106,6 @@ namespace vkBasalt
             if (!tooltip.empty() && ImGui::IsItemHovered())
                 ImGui::SetTooltip("%s", tooltip.c_str());
 
-            if (atLimit)
-                ImGui::EndDisabled();
         };
 
         // Two column layout
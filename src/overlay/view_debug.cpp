@@ -1,6 +1,7 @@
 #include "imgui_overlay.hpp"
 #include "effects/effect_registry.hpp"
 #include "settings_manager.hpp"
+#include "reshade_cache.hpp"
 #include "logger.hpp"
 
 #include <cctype>
@@ -56,6 +57,8 @@ namespace vkBasalt
 
                 const auto& effects = pEffectRegistry->getAllEffects();
                 ImGui::Text("Total Effects: %zu", effects.size());
+                ImGui::TextDisabled("Shader Cache: %u hits, %u misses",
+                    ReshadeModuleCache::getHits(), ReshadeModuleCache::getMisses());
                 ImGui::Separator();
 
                 for (const auto& effect : effects)
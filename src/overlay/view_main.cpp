@@ -49,6 +49,8 @@ namespace vkBasalt
 
         // Get a mutable copy of selected effects for this frame
         std::vector<std::string> selectedEffects = pEffectRegistry->getSelectedEffects();
+        activeParamEffect.clear();
+        activeParamIndex = 0;
 
         // Normal mode - show config and effect controls
 
@@ -71,8 +73,13 @@ namespace vkBasalt
         ImGui::SetNextItemWidth(120);
         ImGui::InputText("##configname", saveConfigName, sizeof(saveConfigName));
 
+        // Effects still compiling have no parameters yet, saving now would drop their values
+        bool anyCompiling = false;
+        for (const auto& effectName : selectedEffects)
+            anyCompiling = anyCompiling || pEffectRegistry->isEffectCompiling(effectName);
+
         ImGui::SameLine();
-        ImGui::BeginDisabled(saveConfigName[0] == '\0');
+        ImGui::BeginDisabled(saveConfigName[0] == '\0' || anyCompiling);
         if (ImGui::Button("Save"))
             saveCurrentConfig();
         ImGui::EndDisabled();
@@ -136,10 +143,16 @@ namespace vkBasalt
                 }
             }
 
+            // ReShade parameters are read from the registry every frame when live, no rebuild needed
+            bool liveParams = settingsManager.getLiveParams() && !pEffectRegistry->isEffectBuiltIn(effectName);
+
             // Check if effect failed to compile
             bool effectFailed = pEffectRegistry ? pEffectRegistry->hasEffectFailed(effectName) : false;
             std::string effectError = effectFailed && pEffectRegistry ? pEffectRegistry->getEffectError(effectName) : "";
 
+            // Parameters are not known until the background compile finishes
+            bool effectCompiling = pEffectRegistry ? pEffectRegistry->isEffectCompiling(effectName) : false;
+
             // Checkbox to enable/disable effect (read/write via registry)
             // Disabled for failed effects
             if (effectFailed)
@@ -163,7 +176,8 @@ namespace vkBasalt
             if (effectFailed)
                 ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
 
-            bool treeOpen = ImGui::TreeNode("effect", "%s%s", effectName.c_str(), effectFailed ? " (FAILED)" : "");
+            bool treeOpen = ImGui::TreeNode("effect", "%s%s", effectName.c_str(),
+                                            effectFailed ? " (FAILED)" : effectCompiling ? " (compiling...)" : "");
 
             if (effectFailed)
                 ImGui::PopStyleColor();
@@ -201,8 +215,11 @@ namespace vkBasalt
                         if (editor)
                             editor->resetToDefault(*param);
                     }
-                    paramsDirty = true;
-                    lastChangeTime = std::chrono::steady_clock::now();
+                    if (!liveParams)
+                    {
+                        paramsDirty = true;
+                        lastChangeTime = std::chrono::steady_clock::now();
+                    }
                 }
 
                 ImGui::Separator();
@@ -242,6 +259,13 @@ namespace vkBasalt
                 continue;
             }
 
+            if (effectCompiling)
+            {
+                ImGui::TextDisabled("Compiling...");
+                ImGui::TreePop();
+                continue;
+            }
+
             // Show preprocessor definitions first (ReShade effects only)
             if (pEffectRegistry)
             {
@@ -280,16 +304,41 @@ namespace vkBasalt
                 }
             }
 
+            // Techniques are all compiled, switching one only re-records the command buffers
+            auto techniques = pEffectRegistry->getTechniques(effectName);
+            if (techniques.size() > 1 && ImGui::TreeNode("techniques", "Techniques (%zu)", techniques.size()))
+            {
+                for (size_t techIdx = 0; techIdx < techniques.size(); techIdx++)
+                {
+                    ImGui::PushID(static_cast<int>(techIdx + 2000));
+                    if (ImGui::Checkbox(techniques[techIdx].name.c_str(), &techniques[techIdx].enabled))
+                    {
+                        pEffectRegistry->setTechniqueEnabled(effectName, techniques[techIdx].name, techniques[techIdx].enabled);
+                        paramsDirty = true;
+                        lastChangeTime = std::chrono::steady_clock::now();
+                    }
+                    ImGui::PopID();
+                }
+                ImGui::TreePop();
+            }
+
             // Show parameters for this effect
             auto effectParams = pEffectRegistry->getParametersForEffect(effectName);
             for (size_t paramIdx = 0; paramIdx < effectParams.size(); paramIdx++)
             {
                 ImGui::PushID(static_cast<int>(paramIdx));
-                if (renderFieldEditor(*effectParams[paramIdx]))
+                ImGui::BeginGroup();
+                if (renderFieldEditor(*effectParams[paramIdx]) && !liveParams)
                 {
                     paramsDirty = true;
                     lastChangeTime = std::chrono::steady_clock::now();
                 }
+                ImGui::EndGroup();
+                if (ImGui::IsItemActive())
+                {
+                    activeParamEffect = effectName;
+                    activeParamIndex = static_cast<uint32_t>(paramIdx + 1);
+                }
                 ImGui::PopID();
             }
 
@@ -85,34 +85,13 @@ namespace vkBasalt
             ImGui::EndTooltip();
         }
 
-        ImGui::Text("Max Effects (requires restart):");
-        if (ImGui::IsItemHovered())
-        {
-            ImGui::BeginTooltip();
-            ImGui::Text("Maximum number of effects that can be active simultaneously.");
-            ImGui::Text("Changes require restarting the application.");
-            ImGui::Spacing();
-            ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.4f, 1.0f), "Warning: High values use significant VRAM");
-            ImGui::EndTooltip();
-        }
-        ImGui::SetNextItemWidth(100);
-        int maxEffectsVal = settingsManager.getMaxEffects();
-        if (ImGui::InputInt("##maxEffects", &maxEffectsVal))
-        {
-            maxEffectsVal = std::clamp(maxEffectsVal, 1, 200);
-            settingsManager.setMaxEffects(maxEffectsVal);
-            maxEffects = static_cast<size_t>(maxEffectsVal);
-            saveSettings();
-        }
-
-        // Show VRAM estimate based on current resolution (2 images per slot, 4 bytes per pixel)
-        float bytesPerSlot = 2.0f * currentWidth * currentHeight * 4.0f;
-        int estimatedVramMB = static_cast<int>((maxEffectsVal * bytesPerSlot) / (1024.0f * 1024.0f));
+        // Show the memory actually allocated for the effect chain's images
+        int effectImageMB = static_cast<int>(state.effectImageMemory / (1024 * 1024));
+        ImGui::Text("Effect Images:");
         ImGui::SameLine();
-        if (maxEffectsVal > 20)
-            ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "~%d MB @ %ux%u", estimatedVramMB, currentWidth, currentHeight);
-        else
-            ImGui::TextDisabled("~%d MB @ %ux%u", estimatedVramMB, currentWidth, currentHeight);
+        ImGui::TextDisabled("%d MB @ %ux%u", effectImageMB, currentWidth, currentHeight);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("VRAM used by the images effects read and write.\nGrows with the first few effects of the chain, longer chains reuse the same images.");
 
         bool autoApply = settingsManager.getAutoApply();
         if (ImGui::Checkbox("Auto-apply Changes", &autoApply))
@@ -139,6 +118,16 @@ namespace vkBasalt
             ImGui::Unindent();
         }
 
+        bool liveParams = settingsManager.getLiveParams();
+        if (ImGui::Checkbox("Live Parameter Updates", &liveParams))
+        {
+            settingsManager.setLiveParams(liveParams);
+            saveSettings();
+            markDirty();  // Shaders must be recompiled with the new uniform layout
+        }
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("ReShade parameters are sent through a uniform buffer and apply on the next frame.\nDisable to bake them into the shaders as constants (recompiles on every change).");
+
         ImGui::Spacing();
         ImGui::Text("Startup Behavior");
         ImGui::Separator();
@@ -161,6 +150,15 @@ namespace vkBasalt
         if (ImGui::IsItemHovered())
             ImGui::SetTooltip("Enable depth buffer capture for effects that use depth.\nMay impact performance. Most effects don't need this.\nChanges require restarting the application.");
 
+        bool effectQueue = settingsManager.getEffectQueue();
+        if (ImGui::Checkbox("Separate Effect Queue (requires restart)", &effectQueue))
+        {
+            settingsManager.setEffectQueue(effectQueue);
+            saveSettings();
+        }
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("Run effects on a graphics queue of their own, so the game's next frame can overlap with them.\nOnly used if the GPU exposes a spare queue. Changes require restarting the application.");
+
         ImGui::Spacing();
         ImGui::Text("Debug");
         ImGui::Separator();
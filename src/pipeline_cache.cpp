@@ -0,0 +1,172 @@
+#include "pipeline_cache.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <unistd.h>
+
+#include "config_serializer.hpp"
+
+namespace vkBasalt
+{
+    namespace
+    {
+        std::string getPipelineCachePath(LogicalDevice* pLogicalDevice)
+        {
+            VkPhysicalDeviceProperties properties;
+            pLogicalDevice->vki.GetPhysicalDeviceProperties(pLogicalDevice->physicalDevice, &properties);
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "pipelines_%04x_%04x_", properties.vendorID, properties.deviceID);
+
+            // No config dir, no disk cache (the path would otherwise resolve to /cache)
+            std::string baseDir = ConfigSerializer::getBaseConfigDir();
+            if (baseDir.empty())
+                return "";
+
+            std::string path = baseDir + "/cache/" + name;
+            for (uint32_t i = 0; i < VK_UUID_SIZE; i++)
+            {
+                char hex[3];
+                std::snprintf(hex, sizeof(hex), "%02x", properties.pipelineCacheUUID[i]);
+                path += hex;
+            }
+            return path + ".bin";
+        }
+
+        // Drivers validate the header themselves, but some crash on garbage instead of ignoring it
+        bool isValidCacheData(LogicalDevice* pLogicalDevice, const std::vector<char>& data)
+        {
+            VkPipelineCacheHeaderVersionOne header;
+            if (data.size() < sizeof(header))
+                return false;
+            std::memcpy(&header, data.data(), sizeof(header));
+
+            VkPhysicalDeviceProperties properties;
+            pLogicalDevice->vki.GetPhysicalDeviceProperties(pLogicalDevice->physicalDevice, &properties);
+
+            return header.headerSize >= sizeof(header)
+                && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+                && header.vendorID == properties.vendorID
+                && header.deviceID == properties.deviceID
+                && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+    } // namespace
+
+    VkPipelineCache createPipelineCache(LogicalDevice* pLogicalDevice)
+    {
+        std::vector<char> data;
+        std::string       path = getPipelineCachePath(pLogicalDevice);
+
+        std::ifstream file;
+        if (!path.empty())
+            file.open(path, std::ios::binary);
+        if (file.is_open())
+        {
+            data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            if (!isValidCacheData(pLogicalDevice, data))
+            {
+                Logger::warn("ignoring stale pipeline cache: " + path);
+                data.clear();
+            }
+        }
+
+        VkPipelineCacheCreateInfo createInfo;
+        createInfo.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.pNext           = nullptr;
+        createInfo.flags           = 0;
+        createInfo.initialDataSize = data.size();
+        createInfo.pInitialData    = data.empty() ? nullptr : data.data();
+
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+        VkResult        result        = pLogicalDevice->vkd.CreatePipelineCache(pLogicalDevice->device, &createInfo, nullptr, &pipelineCache);
+        if (result != VK_SUCCESS && !data.empty())
+        {
+            // Retry without the initial data rather than running without a cache
+            Logger::warn("driver rejected pipeline cache, starting empty");
+            createInfo.initialDataSize = 0;
+            createInfo.pInitialData    = nullptr;
+            result = pLogicalDevice->vkd.CreatePipelineCache(pLogicalDevice->device, &createInfo, nullptr, &pipelineCache);
+        }
+        ASSERT_VULKAN(result);
+        if (result != VK_SUCCESS)
+            return VK_NULL_HANDLE;
+
+        pLogicalDevice->pipelineCacheSavedSize = data.size();
+        Logger::debug("created pipeline cache (" + std::to_string(data.size()) + " bytes loaded)");
+        return pipelineCache;
+    }
+
+    void savePipelineCache(LogicalDevice* pLogicalDevice)
+    {
+        if (pLogicalDevice->pipelineCache == VK_NULL_HANDLE)
+            return;
+
+        std::string path = getPipelineCachePath(pLogicalDevice);
+        if (path.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(pLogicalDevice->pipelineCacheLock);
+
+        size_t   size   = 0;
+        VkResult result = pLogicalDevice->vkd.GetPipelineCacheData(pLogicalDevice->device, pLogicalDevice->pipelineCache, &size, nullptr);
+        if (result != VK_SUCCESS || size == pLogicalDevice->pipelineCacheSavedSize)
+            return;
+
+        std::vector<char> data(size);
+        result = pLogicalDevice->vkd.GetPipelineCacheData(pLogicalDevice->device, pLogicalDevice->pipelineCache, &size, data.data());
+        if (result != VK_SUCCESS)
+            return;
+        data.resize(size);
+
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+        // Write to a temp file and rename so another process never reads a partial cache
+        std::string tmpPath = path + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(reinterpret_cast<uintptr_t>(pLogicalDevice));
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.good())
+            {
+                Logger::warn("could not write pipeline cache: " + tmpPath);
+                return;
+            }
+            file.write(data.data(), data.size());
+        }
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(tmpPath.c_str());
+            return;
+        }
+
+        pLogicalDevice->pipelineCacheSavedSize = size;
+        Logger::debug("saved pipeline cache (" + std::to_string(size) + " bytes)");
+    }
+
+    void savePipelineCacheInBackground(LogicalDevice* pLogicalDevice)
+    {
+        // A save still running is followed by the one at device destruction
+        auto& save = pLogicalDevice->pipelineCacheSave;
+        if (save.valid() && save.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+
+        save = std::async(std::launch::async, savePipelineCache, pLogicalDevice);
+    }
+
+    void destroyPipelineCache(LogicalDevice* pLogicalDevice)
+    {
+        if (pLogicalDevice->pipelineCacheSave.valid())
+            pLogicalDevice->pipelineCacheSave.wait();
+        if (pLogicalDevice->pipelineCache == VK_NULL_HANDLE)
+            return;
+
+        savePipelineCache(pLogicalDevice);
+        pLogicalDevice->vkd.DestroyPipelineCache(pLogicalDevice->device, pLogicalDevice->pipelineCache, nullptr);
+        pLogicalDevice->pipelineCache = VK_NULL_HANDLE;
+    }
+} // namespace vkBasalt
@@ -0,0 +1,25 @@
+#ifndef PIPELINE_CACHE_HPP_INCLUDED
+#define PIPELINE_CACHE_HPP_INCLUDED
+#include <string>
+
+#include "vulkan_include.hpp"
+
+#include "logical_device.hpp"
+
+namespace vkBasalt
+{
+    // Create the device-level pipeline cache, seeded from disk if a matching cache file exists.
+    // Files are keyed by vendor, device and driver UUID, so a driver update starts from an empty cache.
+    VkPipelineCache createPipelineCache(LogicalDevice* pLogicalDevice);
+
+    // Write the pipeline cache back to disk (skipped if nothing was added since the last save)
+    void savePipelineCache(LogicalDevice* pLogicalDevice);
+
+    // savePipelineCache on a background thread, so the present path doesn't wait for the file
+    void savePipelineCacheInBackground(LogicalDevice* pLogicalDevice);
+
+    // Save and destroy the pipeline cache
+    void destroyPipelineCache(LogicalDevice* pLogicalDevice);
+}
+
+#endif // PIPELINE_CACHE_HPP_INCLUDED
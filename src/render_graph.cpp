@@ -0,0 +1,107 @@
+#include "render_graph.hpp"
+
+#include <unordered_map>
+
+#include "util.hpp"
+
+namespace vkBasalt
+{
+    namespace
+    {
+        constexpr VkAccessFlags writeAccess = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+                                              | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+        // Barriers for the next vkCmdPipelineBarrier, merged over all images
+        struct BarrierBatch
+        {
+            VkPipelineStageFlags              srcStages = 0;
+            VkPipelineStageFlags              dstStages = 0;
+            std::vector<VkImageMemoryBarrier> barriers;
+
+            void add(VkImage image, const ImageState& from, const ImageState& to, bool discard)
+            {
+                VkImageMemoryBarrier barrier;
+                barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                barrier.pNext               = nullptr;
+                barrier.srcAccessMask       = from.access & writeAccess;  // Reads only need the execution dependency
+                barrier.dstAccessMask       = to.access;
+                barrier.oldLayout           = discard ? VK_IMAGE_LAYOUT_UNDEFINED : from.layout;
+                barrier.newLayout           = to.layout;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image               = image;
+
+                barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+                barrier.subresourceRange.baseMipLevel   = 0;
+                barrier.subresourceRange.levelCount     = 1;
+                barrier.subresourceRange.baseArrayLayer = 0;
+                barrier.subresourceRange.layerCount     = 1;
+
+                barriers.push_back(barrier);
+                srcStages |= from.stage;
+                dstStages |= to.stage;
+            }
+
+            void record(LogicalDevice* pLogicalDevice, VkCommandBuffer commandBuffer)
+            {
+                if (barriers.empty())
+                    return;
+                pLogicalDevice->vkd.CmdPipelineBarrier(
+                    commandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr, barriers.size(), barriers.data());
+                *this = BarrierBatch();
+            }
+        };
+    } // namespace
+
+    void recordEffectChain(LogicalDevice*                              pLogicalDevice,
+                           const std::vector<std::shared_ptr<Effect>>& effects,
+                           uint32_t                                    imageIndex,
+                           VkCommandBuffer                             commandBuffer)
+    {
+        if (effects.empty())
+            return;
+
+        // The app's image was presented by the app, the semaphore wait of the submit covers its writes.
+        // Everything else is written by the chain before it is read, so earlier content never matters.
+        ImageState presented = {VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0};
+        ImageState unused    = {VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0};
+
+        std::unordered_map<VkImage, ImageState> states;
+        VkImage                                 chainInput  = effects.front()->getImageUses(imageIndex).input;
+        VkImage                                 chainOutput = effects.back()->getImageUses(imageIndex).output;
+        states[chainInput]                                  = presented;
+
+        BarrierBatch batch;
+        for (auto& effect : effects)
+        {
+            EffectImageUses uses = effect->getImageUses(imageIndex);
+
+            auto input = states.emplace(uses.input, unused).first;
+            // Reads after reads in the same layout need nothing
+            if (input->second.layout != uses.inputState.layout || (input->second.access & writeAccess))
+                batch.add(uses.input, input->second, uses.inputState, false);
+            input->second = uses.inputState;
+
+            // The output is overwritten, only the previous uses have to be done first
+            auto output = states.emplace(uses.output, unused).first;
+            batch.add(uses.output, output->second, uses.outputState, true);
+
+            batch.record(pLogicalDevice, commandBuffer);
+
+            Logger::debug("before applying effect " + convertToString(effect));
+            effect->applyEffect(imageIndex, commandBuffer);
+            output->second = uses.outputStateAfter;
+        }
+
+        // The app renders to its image again and the output is presented (after the overlay, which waits for all commands)
+        ImageState present = {VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0};
+        for (VkImage image : {chainInput, chainOutput})
+        {
+            ImageState& state = states[image];
+            if (state.layout != present.layout || (state.access & writeAccess))
+                batch.add(image, state, present, false);
+            state = present;
+        }
+        batch.record(pLogicalDevice, commandBuffer);
+    }
+} // namespace vkBasalt
@@ -0,0 +1,24 @@
+#ifndef RENDER_GRAPH_HPP_INCLUDED
+#define RENDER_GRAPH_HPP_INCLUDED
+#include <vector>
+#include <memory>
+
+#include "vulkan_include.hpp"
+
+#include "logical_device.hpp"
+
+#include "effects/effect.hpp"
+
+namespace vkBasalt
+{
+    // Records the effects of a chain for one image index with the barriers between them.
+    // Every chain image is tracked through the chain, so an image is only transitioned when its next use needs
+    // another layout, and the barriers an effect needs are merged into one vkCmdPipelineBarrier.
+    // The app's image and the final output are left in PRESENT_SRC, intermediates in whatever their last use left.
+    void recordEffectChain(LogicalDevice*                              pLogicalDevice,
+                           const std::vector<std::shared_ptr<Effect>>& effects,
+                           uint32_t                                    imageIndex,
+                           VkCommandBuffer                             commandBuffer);
+} // namespace vkBasalt
+
+#endif // RENDER_GRAPH_HPP_INCLUDED
@@ -0,0 +1,258 @@
+#include "render_target_pool.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "memory.hpp"
+
+#include "reshade/spirv.hpp"
+
+namespace vkBasalt
+{
+    namespace
+    {
+        // What the functions of the module's SPIR-V refer to
+        struct SpirvFunctions
+        {
+            std::unordered_map<std::string, uint32_t>                  entryPoints;    // Function id by name
+            std::unordered_map<uint32_t, std::unordered_set<uint32_t>> referencedIds;  // Operands of every instruction, calls included
+        };
+
+        SpirvFunctions parseSpirvFunctions(const std::vector<uint32_t>& spirv)
+        {
+            SpirvFunctions functions;
+            uint32_t       function = 0;
+            for (size_t i = 5; i < spirv.size();)
+            {
+                uint32_t opcode    = spirv[i] & spv::OpCodeMask;
+                uint32_t wordCount = spirv[i] >> spv::WordCountShift;
+                if (wordCount == 0 || i + wordCount > spirv.size())
+                    break;
+
+                if (opcode == spv::OpEntryPoint && wordCount > 3)
+                    functions.entryPoints[reinterpret_cast<const char*>(&spirv[i + 3])] = spirv[i + 2];
+                else if (opcode == spv::OpFunction)
+                    function = spirv[i + 2];
+                else if (opcode == spv::OpFunctionEnd)
+                    function = 0;
+                else if (function)
+                    functions.referencedIds[function].insert(spirv.begin() + i + 1, spirv.begin() + i + wordCount);
+                i += wordCount;
+            }
+            return functions;
+        }
+
+        // Ids referenced by a function and everything it calls (literals may match too, which only makes this conservative)
+        void collectReferencedIds(const SpirvFunctions&         functions,
+                                  uint32_t                      function,
+                                  std::unordered_set<uint32_t>& visited,
+                                  std::unordered_set<uint32_t>& ids)
+        {
+            auto body = functions.referencedIds.find(function);
+            if (body == functions.referencedIds.end() || !visited.insert(function).second)
+                return;
+            for (uint32_t id : body->second)
+            {
+                ids.insert(id);
+                collectReferencedIds(functions, id, visited, ids);
+            }
+        }
+
+        // The pass replaces all of the target's content, nothing of the previous frame can show through.
+        // Only a full-size clear proves that, a draw may leave pixels out whatever its pass state says
+        // (the vertex shader decides what a triangle covers).
+        bool overwritesRenderTarget(const reshadefx::pass_info& pass, const reshadefx::texture_info& texture, VkExtent2D imageExtent)
+        {
+            uint32_t width  = pass.viewport_width ? pass.viewport_width : imageExtent.width;
+            uint32_t height = pass.viewport_height ? pass.viewport_height : imageExtent.height;
+            return pass.clear_render_targets && width == texture.width && height == texture.height;
+        }
+    } // namespace
+
+    std::unordered_map<std::string, RenderTargetLifetime> getTransientRenderTargets(const reshadefx::module& module, VkExtent2D imageExtent)
+    {
+        // The passes of all techniques in recording order, whichever of them are enabled only run a subset of these
+        std::vector<reshadefx::pass_info> passes;
+        std::vector<size_t>               passTechniques;
+        for (size_t t = 0; t < module.techniques.size(); t++)
+        {
+            passes.insert(passes.end(), module.techniques[t].passes.begin(), module.techniques[t].passes.end());
+            passTechniques.resize(passes.size(), t);
+        }
+        SpirvFunctions functions = parseSpirvFunctions(module.spirv);
+
+        // Textures each pass may sample
+        std::vector<std::unordered_set<std::string>> sampledTextures(passes.size());
+        for (size_t i = 0; i < passes.size(); i++)
+        {
+            std::unordered_set<uint32_t> visited, ids;
+            bool                         known = true;
+            for (const std::string& entryPoint : {passes[i].vs_entry_point, passes[i].ps_entry_point})
+            {
+                auto function = functions.entryPoints.find(entryPoint);
+                if (function == functions.entryPoints.end())
+                {
+                    known = false;
+                    break;
+                }
+                collectReferencedIds(functions, function->second, visited, ids);
+            }
+
+            for (const auto& sampler : module.samplers)
+            {
+                if (!known || ids.count(sampler.id))
+                    sampledTextures[i].insert(sampler.texture_name);
+            }
+        }
+
+        std::unordered_map<std::string, RenderTargetLifetime> transientTargets;
+        for (const auto& texture : module.textures)
+        {
+            // COLOR and DEPTH are the chain images, "source" textures are loaded once
+            if (!texture.semantic.empty()
+                || std::any_of(texture.annotations.begin(), texture.annotations.end(), [](const auto& a) { return a.name == "source"; }))
+                continue;
+
+            int32_t  firstPass = -1;
+            uint32_t lastPass  = 0;
+            bool     transient = true;
+            for (uint32_t i = 0; i < passes.size() && transient; i++)
+            {
+                const auto& targets = passes[i].render_target_names;
+                bool        written = std::find(std::begin(targets), std::end(targets), texture.unique_name) != std::end(targets);
+                bool        sampled = sampledTextures[i].count(texture.unique_name);
+                if (firstPass < 0 && written)
+                {
+                    firstPass = i;
+                    transient = !sampled && overwritesRenderTarget(passes[i], texture, imageExtent);
+                }
+                else if (firstPass < 0 && sampled)
+                {
+                    transient = false;
+                }
+                else if ((written || sampled) && passTechniques[i] != passTechniques[firstPass])
+                {
+                    transient = false;  // Another technique may run without the one that writes it
+                }
+                if (written || sampled)
+                    lastPass = i;
+            }
+
+            if (transient && firstPass >= 0)
+                transientTargets[texture.unique_name] = {(uint32_t) firstPass, lastPass};
+        }
+        return transientTargets;
+    }
+
+    RenderTargetBlock::~RenderTargetBlock()
+    {
+        pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, memory, nullptr);
+    }
+
+    RenderTargetPool::RenderTargetPool(LogicalDevice* pLogicalDevice)
+    {
+        this->pLogicalDevice = pLogicalDevice;
+    }
+
+    std::vector<std::shared_ptr<RenderTargetBlock>> RenderTargetPool::bindRenderTargets(const std::vector<PooledRenderTarget>& renderTargets)
+    {
+        // Targets of the effect whose pass ranges don't overlap share a slot, in the order they are first written
+        struct Slot
+        {
+            VkDeviceSize         size;
+            uint32_t             memoryTypeBits;
+            uint32_t             lastPass;
+            std::vector<VkImage> images;
+        };
+        std::vector<const PooledRenderTarget*> order;
+        for (const auto& renderTarget : renderTargets)
+            order.push_back(&renderTarget);
+        std::stable_sort(order.begin(), order.end(), [](const auto* a, const auto* b) { return a->lifetime.firstPass < b->lifetime.firstPass; });
+
+        std::vector<Slot> slots;
+        for (const auto* renderTarget : order)
+        {
+            VkMemoryRequirements requirements;
+            pLogicalDevice->vkd.GetImageMemoryRequirements(pLogicalDevice->device, renderTarget->image, &requirements);
+
+            // Prefer the smallest free slot it fits in, then the largest one to grow
+            auto better = [&](const Slot& a, const Slot& b) {
+                bool aFits = a.size >= requirements.size;
+                bool bFits = b.size >= requirements.size;
+                if (aFits != bFits)
+                    return aFits;
+                return aFits ? a.size < b.size : a.size > b.size;
+            };
+
+            Slot* slot = nullptr;
+            for (auto& candidate : slots)
+            {
+                if (candidate.lastPass >= renderTarget->lifetime.firstPass || !(candidate.memoryTypeBits & requirements.memoryTypeBits))
+                    continue;
+                if (!slot || better(candidate, *slot))
+                    slot = &candidate;
+            }
+            if (!slot)
+            {
+                slots.push_back({0, requirements.memoryTypeBits, 0, {}});
+                slot = &slots.back();
+            }
+            slot->size = std::max(slot->size, requirements.size);
+            slot->memoryTypeBits &= requirements.memoryTypeBits;
+            slot->lastPass = renderTarget->lifetime.lastPass;
+            slot->images.push_back(renderTarget->image);
+        }
+
+        // Every slot takes its own block, largest first so they get the large blocks of other effects
+        blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [](const auto& block) { return block.expired(); }), blocks.end());
+        std::sort(slots.begin(), slots.end(), [](const Slot& a, const Slot& b) { return a.size > b.size; });
+
+        std::vector<std::shared_ptr<RenderTargetBlock>> acquired;
+        std::unordered_set<RenderTargetBlock*>          taken;
+        VkDeviceSize                                    allocatedSize = 0;
+        for (const auto& slot : slots)
+        {
+            std::shared_ptr<RenderTargetBlock> block;
+            for (const auto& weakBlock : blocks)
+            {
+                auto candidate = weakBlock.lock();
+                if (!candidate || taken.count(candidate.get()) || candidate->size < slot.size
+                    || !(slot.memoryTypeBits & (1u << candidate->memoryTypeIndex)))
+                    continue;
+                if (!block || candidate->size < block->size)
+                    block = candidate;
+            }
+
+            if (!block)
+            {
+                block                  = std::make_shared<RenderTargetBlock>();
+                block->pLogicalDevice  = pLogicalDevice;
+                block->size            = slot.size;
+                block->memoryTypeIndex = findMemoryTypeIndex(pLogicalDevice, slot.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+                VkMemoryAllocateInfo memoryAllocateInfo;
+                memoryAllocateInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                memoryAllocateInfo.pNext           = nullptr;
+                memoryAllocateInfo.allocationSize  = block->size;
+                memoryAllocateInfo.memoryTypeIndex = block->memoryTypeIndex;
+
+                VkResult result = pLogicalDevice->vkd.AllocateMemory(pLogicalDevice->device, &memoryAllocateInfo, nullptr, &block->memory);
+                ASSERT_VULKAN(result);
+                blocks.push_back(block);
+                allocatedSize += block->size;
+            }
+
+            for (VkImage image : slot.images)
+            {
+                VkResult result = pLogicalDevice->vkd.BindImageMemory(pLogicalDevice->device, image, block->memory, 0);
+                ASSERT_VULKAN(result);
+            }
+            taken.insert(block.get());
+            acquired.push_back(block);
+        }
+
+        Logger::debug("pooled " + std::to_string(renderTargets.size()) + " render targets in " + std::to_string(slots.size()) + " slots, "
+                      + std::to_string(allocatedSize) + " new bytes");
+        return acquired;
+    }
+} // namespace vkBasalt
@@ -0,0 +1,59 @@
+#ifndef RENDER_TARGET_POOL_HPP_INCLUDED
+#define RENDER_TARGET_POOL_HPP_INCLUDED
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+
+#include "vulkan_include.hpp"
+
+#include "logical_device.hpp"
+
+#include "reshade/effect_module.hpp"
+
+namespace vkBasalt
+{
+    // Passes (of all techniques, numbered in order) that use a render target whose content never outlives the effect
+    struct RenderTargetLifetime
+    {
+        uint32_t firstPass;  // Completely overwrites it before any pass samples it
+        uint32_t lastPass;
+    };
+
+    // Render targets that every frame are completely written before anything samples them, by unique_name.
+    // The others keep their content between frames (accumulation, previous frame copies) and need their own memory.
+    std::unordered_map<std::string, RenderTargetLifetime> getTransientRenderTargets(const reshadefx::module& module, VkExtent2D imageExtent);
+
+    // Memory that transient render targets of different effects (or different passes) are bound to one after another
+    struct RenderTargetBlock
+    {
+        LogicalDevice* pLogicalDevice;
+        VkDeviceMemory memory;
+        VkDeviceSize   size;
+        uint32_t       memoryTypeIndex;
+
+        ~RenderTargetBlock();
+    };
+
+    struct PooledRenderTarget
+    {
+        VkImage              image;  // Created without memory (see createUnboundImage)
+        RenderTargetLifetime lifetime;
+    };
+
+    // Transient render targets of a swapchain's effects. Effects run one after another, so targets of different effects
+    // can share memory, as can targets of one effect whose pass ranges don't overlap.
+    // Whoever writes a target first has to transition it from VK_IMAGE_LAYOUT_UNDEFINED, after the previous uses of the memory.
+    struct RenderTargetPool
+    {
+        LogicalDevice*                                pLogicalDevice;
+        std::vector<std::weak_ptr<RenderTargetBlock>> blocks;  // Alive as long as an effect has an image bound to them
+
+        RenderTargetPool(LogicalDevice* pLogicalDevice);
+
+        // Binds the render targets of one effect, the returned blocks must be kept as long as the images exist
+        std::vector<std::shared_ptr<RenderTargetBlock>> bindRenderTargets(const std::vector<PooledRenderTarget>& renderTargets);
+    };
+} // namespace vkBasalt
+
+#endif // RENDER_TARGET_POOL_HPP_INCLUDED
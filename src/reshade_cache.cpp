@@ -0,0 +1,538 @@
+#include "reshade_cache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <functional>
+#include <unistd.h>
+
+#include "config_serializer.hpp"
+#include "logger.hpp"
+
+namespace vkBasalt
+{
+    std::atomic<uint32_t> ReshadeModuleCache::hits   = 0;
+    std::atomic<uint32_t> ReshadeModuleCache::misses = 0;
+
+    namespace
+    {
+        // Bump whenever the serialized layout or the reshadefx codegen changes
+        constexpr uint32_t cacheMagic   = 0x4D42564B; // "KVBM"
+        constexpr uint32_t cacheVersion = 1;
+
+        // 64-bit FNV-1a, run with two offset bases to get a 128-bit key
+        struct Hasher
+        {
+            uint64_t a = 0xcbf29ce484222325ull;
+            uint64_t b = 0x84222325cbf29ce4ull;
+
+            void add(const void* data, size_t size)
+            {
+                const uint8_t* bytes = static_cast<const uint8_t*>(data);
+                for (size_t i = 0; i < size; i++)
+                {
+                    a = (a ^ bytes[i]) * 0x100000001b3ull;
+                    b = (b ^ bytes[i]) * 0x100000001b3ull;
+                }
+            }
+
+            void add(const std::string& str)
+            {
+                uint64_t size = str.size();
+                add(&size, sizeof(size));
+                add(str.data(), str.size());
+            }
+        };
+
+        class Writer
+        {
+        public:
+            std::string data;
+
+            void u8(uint8_t value) { data.push_back(static_cast<char>(value)); }
+            void u32(uint32_t value) { data.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+            void f32(float value) { data.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+            void str(const std::string& value)
+            {
+                u32(static_cast<uint32_t>(value.size()));
+                data.append(value);
+            }
+
+            void type(const reshadefx::type& value)
+            {
+                u8(value.base);
+                u32(value.rows);
+                u32(value.cols);
+                u32(value.qualifiers);
+                u32(static_cast<uint32_t>(value.array_length));
+                u32(value.definition);
+            }
+
+            void constant(const reshadefx::constant& value)
+            {
+                for (uint32_t i = 0; i < 16; i++)
+                    u32(value.as_uint[i]);
+                str(value.string_data);
+                u32(static_cast<uint32_t>(value.array_data.size()));
+                for (const auto& element : value.array_data)
+                    constant(element);
+            }
+
+            void annotations(const std::vector<reshadefx::annotation>& values)
+            {
+                u32(static_cast<uint32_t>(values.size()));
+                for (const auto& annotation : values)
+                {
+                    type(annotation.type);
+                    str(annotation.name);
+                    constant(annotation.value);
+                }
+            }
+
+            void uniform(const reshadefx::uniform_info& value)
+            {
+                str(value.name);
+                type(value.type);
+                u32(value.size);
+                u32(value.offset);
+                annotations(value.annotations);
+                u8(value.has_initializer_value);
+                constant(value.initializer_value);
+            }
+
+            void pass(const reshadefx::pass_info& value)
+            {
+                for (const auto& target : value.render_target_names)
+                    str(target);
+                str(value.vs_entry_point);
+                str(value.ps_entry_point);
+                u8(value.clear_render_targets);
+                u8(value.srgb_write_enable);
+                u8(value.blend_enable);
+                u8(value.stencil_enable);
+                u8(value.color_write_mask);
+                u8(value.stencil_read_mask);
+                u8(value.stencil_write_mask);
+                u8(static_cast<uint8_t>(value.blend_op));
+                u8(static_cast<uint8_t>(value.blend_op_alpha));
+                u8(static_cast<uint8_t>(value.src_blend));
+                u8(static_cast<uint8_t>(value.dest_blend));
+                u8(static_cast<uint8_t>(value.src_blend_alpha));
+                u8(static_cast<uint8_t>(value.dest_blend_alpha));
+                u8(static_cast<uint8_t>(value.stencil_comparison_func));
+                u32(value.stencil_reference_value);
+                u8(static_cast<uint8_t>(value.stencil_op_pass));
+                u8(static_cast<uint8_t>(value.stencil_op_fail));
+                u8(static_cast<uint8_t>(value.stencil_op_depth_fail));
+                u32(value.num_vertices);
+                u8(static_cast<uint8_t>(value.topology));
+                u32(value.viewport_width);
+                u32(value.viewport_height);
+            }
+
+            void module(const reshadefx::module& value)
+            {
+                u32(static_cast<uint32_t>(value.spirv.size()));
+                data.append(reinterpret_cast<const char*>(value.spirv.data()), value.spirv.size() * sizeof(uint32_t));
+
+                u32(static_cast<uint32_t>(value.entry_points.size()));
+                for (const auto& entryPoint : value.entry_points)
+                {
+                    str(entryPoint.name);
+                    u8(entryPoint.is_pixel_shader);
+                }
+
+                u32(static_cast<uint32_t>(value.textures.size()));
+                for (const auto& texture : value.textures)
+                {
+                    u32(texture.id);
+                    u32(texture.binding);
+                    str(texture.semantic);
+                    str(texture.unique_name);
+                    annotations(texture.annotations);
+                    u32(texture.width);
+                    u32(texture.height);
+                    u32(texture.levels);
+                    u32(static_cast<uint32_t>(texture.format));
+                }
+
+                u32(static_cast<uint32_t>(value.samplers.size()));
+                for (const auto& sampler : value.samplers)
+                {
+                    u32(sampler.id);
+                    u32(sampler.binding);
+                    u32(sampler.texture_binding);
+                    str(sampler.unique_name);
+                    str(sampler.texture_name);
+                    annotations(sampler.annotations);
+                    u32(static_cast<uint32_t>(sampler.filter));
+                    u32(static_cast<uint32_t>(sampler.address_u));
+                    u32(static_cast<uint32_t>(sampler.address_v));
+                    u32(static_cast<uint32_t>(sampler.address_w));
+                    f32(sampler.min_lod);
+                    f32(sampler.max_lod);
+                    f32(sampler.lod_bias);
+                    u8(sampler.srgb);
+                }
+
+                u32(static_cast<uint32_t>(value.uniforms.size()));
+                for (const auto& uniformInfo : value.uniforms)
+                    uniform(uniformInfo);
+
+                u32(static_cast<uint32_t>(value.spec_constants.size()));
+                for (const auto& specConstant : value.spec_constants)
+                    uniform(specConstant);
+
+                u32(static_cast<uint32_t>(value.techniques.size()));
+                for (const auto& technique : value.techniques)
+                {
+                    str(technique.name);
+                    u32(static_cast<uint32_t>(technique.passes.size()));
+                    for (const auto& passInfo : technique.passes)
+                        pass(passInfo);
+                    annotations(technique.annotations);
+                }
+
+                u32(value.total_uniform_size);
+                u32(value.num_sampler_bindings);
+                u32(value.num_texture_bindings);
+            }
+        };
+
+        // Reads back what Writer produced; any out-of-bounds read marks the entry as corrupt
+        class Reader
+        {
+        public:
+            Reader(const std::string& data) : data(data) {}
+
+            bool ok = true;
+
+            uint8_t u8()
+            {
+                uint8_t value = 0;
+                raw(&value, sizeof(value));
+                return value;
+            }
+            uint32_t u32()
+            {
+                uint32_t value = 0;
+                raw(&value, sizeof(value));
+                return value;
+            }
+            float f32()
+            {
+                float value = 0.0f;
+                raw(&value, sizeof(value));
+                return value;
+            }
+            std::string str()
+            {
+                uint32_t size = u32();
+                if (!check(size))
+                    return "";
+                std::string value = data.substr(pos, size);
+                pos += size;
+                return value;
+            }
+
+            // Element counts are bounded by the remaining data so a corrupt count can't trigger a huge allocation
+            uint32_t count()
+            {
+                uint32_t value = u32();
+                return check(value) ? value : 0;
+            }
+
+            reshadefx::type type()
+            {
+                reshadefx::type value;
+                value.base         = static_cast<reshadefx::type::datatype>(u8());
+                value.rows         = u32();
+                value.cols         = u32();
+                value.qualifiers   = u32();
+                value.array_length = static_cast<int>(u32());
+                value.definition   = u32();
+                return value;
+            }
+
+            reshadefx::constant constant()
+            {
+                reshadefx::constant value = {};
+                for (uint32_t i = 0; i < 16; i++)
+                    value.as_uint[i] = u32();
+                value.string_data = str();
+                value.array_data.resize(count());
+                for (auto& element : value.array_data)
+                    element = constant();
+                return value;
+            }
+
+            std::vector<reshadefx::annotation> annotations()
+            {
+                std::vector<reshadefx::annotation> values(count());
+                for (auto& annotation : values)
+                {
+                    annotation.type  = type();
+                    annotation.name  = str();
+                    annotation.value = constant();
+                }
+                return values;
+            }
+
+            reshadefx::uniform_info uniform()
+            {
+                reshadefx::uniform_info value;
+                value.name                  = str();
+                value.type                  = type();
+                value.size                  = u32();
+                value.offset                = u32();
+                value.annotations           = annotations();
+                value.has_initializer_value = u8();
+                value.initializer_value     = constant();
+                return value;
+            }
+
+            reshadefx::pass_info pass()
+            {
+                reshadefx::pass_info value;
+                for (auto& target : value.render_target_names)
+                    target = str();
+                value.vs_entry_point          = str();
+                value.ps_entry_point          = str();
+                value.clear_render_targets    = u8();
+                value.srgb_write_enable       = u8();
+                value.blend_enable            = u8();
+                value.stencil_enable          = u8();
+                value.color_write_mask        = u8();
+                value.stencil_read_mask       = u8();
+                value.stencil_write_mask      = u8();
+                value.blend_op                = static_cast<reshadefx::pass_blend_op>(u8());
+                value.blend_op_alpha          = static_cast<reshadefx::pass_blend_op>(u8());
+                value.src_blend               = static_cast<reshadefx::pass_blend_func>(u8());
+                value.dest_blend              = static_cast<reshadefx::pass_blend_func>(u8());
+                value.src_blend_alpha         = static_cast<reshadefx::pass_blend_func>(u8());
+                value.dest_blend_alpha        = static_cast<reshadefx::pass_blend_func>(u8());
+                value.stencil_comparison_func = static_cast<reshadefx::pass_stencil_func>(u8());
+                value.stencil_reference_value = u32();
+                value.stencil_op_pass         = static_cast<reshadefx::pass_stencil_op>(u8());
+                value.stencil_op_fail         = static_cast<reshadefx::pass_stencil_op>(u8());
+                value.stencil_op_depth_fail   = static_cast<reshadefx::pass_stencil_op>(u8());
+                value.num_vertices            = u32();
+                value.topology                = static_cast<reshadefx::primitive_topology>(u8());
+                value.viewport_width          = u32();
+                value.viewport_height         = u32();
+                return value;
+            }
+
+            void module(reshadefx::module& value)
+            {
+                uint32_t spirvSize = u32();
+                if (!check(static_cast<size_t>(spirvSize) * sizeof(uint32_t)))
+                    return;
+                value.spirv.resize(spirvSize);
+                raw(value.spirv.data(), spirvSize * sizeof(uint32_t));
+
+                value.entry_points.resize(count());
+                for (auto& entryPoint : value.entry_points)
+                {
+                    entryPoint.name            = str();
+                    entryPoint.is_pixel_shader = u8();
+                }
+
+                value.textures.resize(count());
+                for (auto& texture : value.textures)
+                {
+                    texture.id          = u32();
+                    texture.binding     = u32();
+                    texture.semantic    = str();
+                    texture.unique_name = str();
+                    texture.annotations = annotations();
+                    texture.width       = u32();
+                    texture.height      = u32();
+                    texture.levels      = u32();
+                    texture.format      = static_cast<reshadefx::texture_format>(u32());
+                }
+
+                value.samplers.resize(count());
+                for (auto& sampler : value.samplers)
+                {
+                    sampler.id              = u32();
+                    sampler.binding         = u32();
+                    sampler.texture_binding = u32();
+                    sampler.unique_name     = str();
+                    sampler.texture_name    = str();
+                    sampler.annotations     = annotations();
+                    sampler.filter          = static_cast<reshadefx::texture_filter>(u32());
+                    sampler.address_u       = static_cast<reshadefx::texture_address_mode>(u32());
+                    sampler.address_v       = static_cast<reshadefx::texture_address_mode>(u32());
+                    sampler.address_w       = static_cast<reshadefx::texture_address_mode>(u32());
+                    sampler.min_lod         = f32();
+                    sampler.max_lod         = f32();
+                    sampler.lod_bias        = f32();
+                    sampler.srgb            = u8();
+                }
+
+                value.uniforms.resize(count());
+                for (auto& uniformInfo : value.uniforms)
+                    uniformInfo = uniform();
+
+                value.spec_constants.resize(count());
+                for (auto& specConstant : value.spec_constants)
+                    specConstant = uniform();
+
+                value.techniques.resize(count());
+                for (auto& technique : value.techniques)
+                {
+                    technique.name = str();
+                    technique.passes.resize(count());
+                    for (auto& passInfo : technique.passes)
+                        passInfo = pass();
+                    technique.annotations = annotations();
+                }
+
+                value.total_uniform_size   = u32();
+                value.num_sampler_bindings = u32();
+                value.num_texture_bindings = u32();
+            }
+
+            bool atEnd() const { return pos == data.size(); }
+
+        private:
+            const std::string& data;
+            size_t             pos = 0;
+
+            bool check(size_t size)
+            {
+                if (!ok || size > data.size() - pos)
+                {
+                    ok = false;
+                    return false;
+                }
+                return true;
+            }
+
+            void raw(void* dst, size_t size)
+            {
+                if (!check(size))
+                    return;
+                std::memcpy(dst, data.data() + pos, size);
+                pos += size;
+            }
+        };
+
+        std::string getEntryPath(const std::string& key)
+        {
+            std::string cacheDir = ReshadeModuleCache::getCacheDir();
+            if (cacheDir.empty())
+                return "";
+            return cacheDir + "/" + key + ".fxmod";
+        }
+    } // anonymous namespace
+
+    std::string ReshadeModuleCache::getCacheDir()
+    {
+        std::string baseDir = ConfigSerializer::getBaseConfigDir();
+        if (baseDir.empty())
+            return "";
+        return baseDir + "/cache";
+    }
+
+    std::string ReshadeModuleCache::computeKey(const std::string&                                      preprocessedSource,
+                                               const std::vector<std::pair<std::string, std::string>>& macros,
+                                               uint32_t                                                codegenFlags)
+    {
+        Hasher hasher;
+        hasher.add(&cacheVersion, sizeof(cacheVersion));
+        hasher.add(&codegenFlags, sizeof(codegenFlags));
+        for (const auto& [name, value] : macros)
+        {
+            hasher.add(name);
+            hasher.add(value);
+        }
+        hasher.add(preprocessedSource);
+
+        char key[33];
+        std::snprintf(key, sizeof(key), "%016llx%016llx", (unsigned long long) hasher.a, (unsigned long long) hasher.b);
+        return key;
+    }
+
+    bool ReshadeModuleCache::load(const std::string& key, reshadefx::module& module)
+    {
+        std::string path = getEntryPath(key);
+        std::ifstream file(path, std::ios::binary);
+        if (path.empty() || !file.is_open())
+        {
+            misses++;
+            return false;
+        }
+
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Reader reader(data);
+        reshadefx::module cached;
+        if (reader.u32() != cacheMagic || reader.u32() != cacheVersion)
+        {
+            misses++;
+            return false;
+        }
+        reader.module(cached);
+
+        if (!reader.ok || !reader.atEnd())
+        {
+            Logger::warn("shader cache: ignoring corrupt entry " + path);
+            misses++;
+            return false;
+        }
+
+        module = std::move(cached);
+        hits++;
+        Logger::debug("shader cache: hit " + key);
+        return true;
+    }
+
+    bool ReshadeModuleCache::store(const std::string& key, const reshadefx::module& module)
+    {
+        std::string cacheDir = getCacheDir();
+        if (cacheDir.empty())
+            return false;
+
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDir, ec);
+
+        Writer writer;
+        writer.u32(cacheMagic);
+        writer.u32(cacheVersion);
+        writer.module(module);
+
+        std::string path    = getEntryPath(key);
+        // Unique per process and thread, effects may be compiled on several threads at once
+        std::string tmpPath = path + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                Logger::warn("shader cache: could not write " + tmpPath);
+                return false;
+            }
+            file.write(writer.data.data(), writer.data.size());
+            if (!file.good())
+            {
+                file.close();
+                std::remove(tmpPath.c_str());
+                return false;
+            }
+        }
+
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+        Logger::debug("shader cache: stored " + key);
+        return true;
+    }
+
+} // namespace vkBasalt
@@ -0,0 +1,45 @@
+#ifndef RESHADE_CACHE_HPP_INCLUDED
+#define RESHADE_CACHE_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <atomic>
+#include <cstdint>
+
+#include "reshade/effect_module.hpp"
+
+namespace vkBasalt
+{
+    // Content-addressed on-disk cache of compiled ReShade modules.
+    // Entries live in ~/.config/vkBasalt-overlay/cache/ and are keyed by the preprocessed source,
+    // the macro set and the codegen flags, so a changed include or macro simply misses.
+    class ReshadeModuleCache
+    {
+    public:
+        // Compute the cache key (hex string) for a preprocessed effect
+        static std::string computeKey(const std::string&                                      preprocessedSource,
+                                      const std::vector<std::pair<std::string, std::string>>& macros,
+                                      uint32_t                                                codegenFlags);
+
+        // Load a cached module, returns false on a miss or a corrupt entry
+        static bool load(const std::string& key, reshadefx::module& module);
+
+        // Store a compiled module (written to a temp file and renamed, safe with concurrent processes)
+        static bool store(const std::string& key, const reshadefx::module& module);
+
+        // Get the cache directory path (~/.config/vkBasalt-overlay/cache/)
+        static std::string getCacheDir();
+
+        // Lookup statistics for the debug window
+        static uint32_t getHits() { return hits; }
+        static uint32_t getMisses() { return misses; }
+
+    private:
+        static std::atomic<uint32_t> hits;
+        static std::atomic<uint32_t> misses;
+    };
+
+} // namespace vkBasalt
+
+#endif // RESHADE_CACHE_HPP_INCLUDED
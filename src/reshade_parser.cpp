@@ -11,6 +11,7 @@
 
 #include "logger.hpp"
 #include "config_serializer.hpp"
+#include "reshade_cache.hpp"
 
 namespace vkBasalt
 {
@@ -69,21 +70,69 @@ namespace vkBasalt
             return items;
         }
 
-        void setupPreprocessor(reshadefx::preprocessor& pp)
+        std::vector<std::pair<std::string, std::string>> buildMacros(const ReshadeCompileOptions& options)
         {
-            pp.add_macro_definition("__RESHADE__", std::to_string(INT_MAX));
-            pp.add_macro_definition("__RESHADE_PERFORMANCE_MODE__", "1");
-            pp.add_macro_definition("__RENDERER__", "0x20000");
-            pp.add_macro_definition("BUFFER_WIDTH", "1920");
-            pp.add_macro_definition("BUFFER_HEIGHT", "1080");
-            pp.add_macro_definition("BUFFER_RCP_WIDTH", "(1.0 / BUFFER_WIDTH)");
-            pp.add_macro_definition("BUFFER_RCP_HEIGHT", "(1.0 / BUFFER_HEIGHT)");
-            pp.add_macro_definition("BUFFER_COLOR_DEPTH", "8");
-
-            // Add all discovered shader paths from shader manager
-            ShaderManagerConfig shaderMgrConfig = ConfigSerializer::loadShaderManagerConfig();
-            for (const auto& path : shaderMgrConfig.discoveredShaderPaths)
-                pp.add_include_path(path);
+            std::vector<std::pair<std::string, std::string>> macros = {
+                {"__RESHADE__", std::to_string(INT_MAX)},
+                {"__RESHADE_PERFORMANCE_MODE__", "1"},
+                {"__RENDERER__", "0x20000"},
+                {"BUFFER_WIDTH", std::to_string(options.bufferWidth)},
+                {"BUFFER_HEIGHT", std::to_string(options.bufferHeight)},
+                {"BUFFER_RCP_WIDTH", "(1.0 / BUFFER_WIDTH)"},
+                {"BUFFER_RCP_HEIGHT", "(1.0 / BUFFER_HEIGHT)"},
+                {"BUFFER_COLOR_DEPTH", std::to_string(options.colorDepth)},
+            };
+
+            // Custom definitions come last so they override anything above.
+            // Values left at the shader's default are skipped, the shader defines them itself
+            // (and predefining them would be reported as a redefinition)
+            for (const auto& def : options.customDefs)
+            {
+                if (def.value != def.defaultValue)
+                    macros.emplace_back(def.name, def.value);
+            }
+
+            return macros;
+        }
+
+        // Bit flags of the codegen options, part of the module cache key
+        uint32_t codegenFlags(bool uniformsToSpecConstants)
+        {
+            return (uniformsToSpecConstants ? 1u : 0u) | (1u << 1) /* vulkan semantics */ | (1u << 2) /* debug info */ | (1u << 3) /* flip */;
+        }
+
+        // Preprocessor diagnostics other than the redefinition of a macro the options override.
+        // The shader defining an overridden macro itself is expected, the override wins.
+        std::string unexpectedPreprocessorErrors(const std::string& errors, const ReshadeCompileOptions& options)
+        {
+            std::set<std::string> overridden;
+            for (const auto& def : options.customDefs)
+            {
+                if (def.value != def.defaultValue)
+                    overridden.insert(def.name);
+            }
+
+            std::string unexpected;
+            size_t      start = 0;
+            while (start < errors.size())
+            {
+                size_t      end  = errors.find('\n', start);
+                std::string line = errors.substr(start, end == std::string::npos ? std::string::npos : end - start);
+                start            = end == std::string::npos ? errors.size() : end + 1;
+                if (line.empty())
+                    continue;
+
+                const std::string redefinition = "preprocessor error: redefinition of '";
+                size_t            namePos      = line.find(redefinition);
+                if (namePos != std::string::npos && line.back() == '\'')
+                {
+                    namePos += redefinition.size();
+                    if (overridden.count(line.substr(namePos, line.size() - 1 - namePos)))
+                        continue;
+                }
+                unexpected += line + '\n';
+            }
+            return unexpected;
         }
 
         void applyFloatRange(FloatParam& p, const auto& annotations)
@@ -321,47 +370,141 @@ namespace vkBasalt
         }
     } // anonymous namespace
 
-    std::vector<std::unique_ptr<EffectParam>> parseReshadeEffect(
+    bool CompiledReshadeEffect::matches(const ReshadeCompileOptions& options) const
+    {
+        return uniformsToSpecConstants == options.uniformsToSpecConstants && macros == buildMacros(options);
+    }
+
+    std::shared_ptr<CompiledReshadeEffect> compileReshadeEffect(
         const std::string& effectName,
         const std::string& effectPath,
-        Config* pConfig)
+        const ReshadeCompileOptions& options)
     {
-        std::vector<std::unique_ptr<EffectParam>> params;
+        auto compiled = std::make_shared<CompiledReshadeEffect>();
+        compiled->effectName = effectName;
+        compiled->filePath = effectPath;
+        compiled->macros = buildMacros(options);
+        compiled->uniformsToSpecConstants = options.uniformsToSpecConstants;
+
+        try
+        {
+            // Setup preprocessor with macros and include paths
+            reshadefx::preprocessor preprocessor;
+            for (const auto& macro : compiled->macros)
+                preprocessor.add_macro_definition(macro.first, macro.second);
+
+            ShaderManagerConfig shaderMgrConfig = ConfigSerializer::loadShaderManagerConfig();
+            for (const auto& path : shaderMgrConfig.discoveredShaderPaths)
+                preprocessor.add_include_path(path);
+
+            // Try to load and preprocess the file
+            bool loaded = preprocessor.append_file(effectPath);
+            std::string ppErrors = preprocessor.errors();
+            if (!loaded && ppErrors.empty())
+            {
+                compiled->errorMessage = "Failed to load shader file";
+                return compiled;
+            }
+
+            compiled->usedMacros = preprocessor.used_macro_definitions();
+
+            // Check for preprocessor errors. An overridden macro the shader also defines unconditionally
+            // is reported as a redefinition, but the override wins and the output is still usable.
+            // Anything else fails the effect (and keeps it out of the module cache).
+            if (!ppErrors.empty())
+            {
+                std::string unexpected = unexpectedPreprocessorErrors(ppErrors, options);
+                if (!unexpected.empty())
+                {
+                    compiled->errorMessage = "Preprocessor errors: " + unexpected;
+                    return compiled;
+                }
+                Logger::warn("reshade_parser preprocessor errors in " + effectName + ": " + ppErrors);
+                compiled->errorMessage = "Warnings: " + ppErrors;
+            }
+
+            // Preprocessing always runs since its output (with all includes resolved) is the cache key,
+            // only parsing and SPIR-V generation are skipped on a hit
+            std::string cacheKey = ReshadeModuleCache::computeKey(
+                preprocessor.output(), compiled->macros, codegenFlags(options.uniformsToSpecConstants));
+            if (ReshadeModuleCache::load(cacheKey, compiled->module))
+            {
+                Logger::debug("loaded reshade module from cache: " + effectName);
+                compiled->success = true;
+                return compiled;
+            }
+
+            // Try to parse the shader
+            reshadefx::parser parser;
+            auto codegen = std::unique_ptr<reshadefx::codegen>(
+                reshadefx::create_codegen_spirv(true, true, options.uniformsToSpecConstants, true));
 
-        // Setup preprocessor
-        reshadefx::preprocessor preprocessor;
-        setupPreprocessor(preprocessor);
+            if (!parser.parse(std::move(preprocessor.output()), codegen.get()))
+            {
+                compiled->errorMessage = "Parse errors: " + parser.errors();
+                return compiled;
+            }
 
-        if (!preprocessor.append_file(effectPath))
+            // Check for parse warnings/errors
+            std::string parseErrors = parser.errors();
+            if (!parseErrors.empty())
+            {
+                // Some shaders have warnings but still work
+                compiled->errorMessage += (compiled->errorMessage.empty() ? "Warnings: " : "") + parseErrors;
+            }
+
+            codegen->write_result(compiled->module);
+            compiled->success = true;
+
+            ReshadeModuleCache::store(cacheKey, compiled->module);
+        }
+        catch (const std::exception& e)
         {
-            Logger::err("reshade_parser: failed to load shader file: " + effectPath);
-            return params;
+            compiled->success = false;
+            compiled->errorMessage = "Exception: " + std::string(e.what());
+        }
+        catch (...)
+        {
+            compiled->success = false;
+            compiled->errorMessage = "Unknown exception during compilation";
         }
 
-        std::string errors = preprocessor.errors();
-        if (!errors.empty())
-            Logger::err("reshade_parser preprocessor errors: " + errors);
+        return compiled;
+    }
 
-        // Parse
-        reshadefx::parser parser;
-        auto codegen = std::unique_ptr<reshadefx::codegen>(
-            reshadefx::create_codegen_spirv(true, true, true, true));
+    void loadReshadeTextures(CompiledReshadeEffect& compiled)
+    {
+        if (!compiled.success)
+            return;
 
-        if (!parser.parse(std::move(preprocessor.output()), codegen.get()))
+        std::vector<std::string> searchPaths;
+        bool searchPathsLoaded = false;
+        for (const auto& texture : compiled.module.textures)
         {
-            errors = parser.errors();
-            if (!errors.empty())
-                Logger::err("reshade_parser parse errors: " + errors);
-            return params;
+            if (findAnnotation(texture.annotations, "source") == texture.annotations.end())
+                continue;
+
+            // Only read the shader manager config if the effect has file textures
+            if (!searchPathsLoaded)
+            {
+                searchPaths = ConfigSerializer::loadShaderManagerConfig().discoveredTexturePaths;
+                searchPathsLoaded = true;
+            }
+
+            compiled.textures[texture.unique_name] = loadReshadeTexture(texture, searchPaths);
         }
+    }
 
-        errors = parser.errors();
-        if (!errors.empty())
-            Logger::err("reshade_parser parse errors: " + errors);
+    std::vector<std::unique_ptr<EffectParam>> parseReshadeEffect(
+        const CompiledReshadeEffect& compiled,
+        Config* pConfig)
+    {
+        std::vector<std::unique_ptr<EffectParam>> params;
+        if (!compiled.success)
+            return params;
 
-        // Extract module and convert uniforms to parameters
-        reshadefx::module module;
-        codegen->write_result(module);
+        const std::string& effectName = compiled.effectName;
+        const reshadefx::module& module = compiled.module;
 
         // Process spec_constants
         // Note: float2/float3/float4 are split into multiple scalar spec_constants with the same name
@@ -506,75 +649,13 @@ namespace vkBasalt
         const std::string& effectName,
         const std::string& effectPath)
     {
+        auto compiled = compileReshadeEffect(effectName, effectPath, ReshadeCompileOptions());
+
         ShaderTestResult result;
         result.effectName = effectName;
         result.filePath = effectPath;
-
-        try
-        {
-            // Setup preprocessor with include paths
-            reshadefx::preprocessor preprocessor;
-            setupPreprocessor(preprocessor);
-
-            // Try to load and preprocess the file
-            if (!preprocessor.append_file(effectPath))
-            {
-                result.success = false;
-                result.errorMessage = "Failed to load shader file";
-                std::string ppErrors = preprocessor.errors();
-                if (!ppErrors.empty())
-                    result.errorMessage += ": " + ppErrors;
-                return result;
-            }
-
-            // Check for preprocessor errors
-            std::string ppErrors = preprocessor.errors();
-            if (!ppErrors.empty())
-            {
-                result.success = false;
-                result.errorMessage = "Preprocessor errors: " + ppErrors;
-                return result;
-            }
-
-            // Try to parse the shader
-            reshadefx::parser parser;
-            auto codegen = std::unique_ptr<reshadefx::codegen>(
-                reshadefx::create_codegen_spirv(true, true, true, true));
-
-            if (!parser.parse(std::move(preprocessor.output()), codegen.get()))
-            {
-                result.success = false;
-                result.errorMessage = "Parse errors: " + parser.errors();
-                return result;
-            }
-
-            // Check for parse warnings/errors
-            std::string parseErrors = parser.errors();
-            if (!parseErrors.empty())
-            {
-                // Some shaders have warnings but still work
-                result.success = true;
-                result.errorMessage = "Warnings: " + parseErrors;
-                return result;
-            }
-
-            // Try to generate code
-            reshadefx::module module;
-            codegen->write_result(module);
-
-            result.success = true;
-        }
-        catch (const std::exception& e)
-        {
-            result.success = false;
-            result.errorMessage = "Exception: " + std::string(e.what());
-        }
-        catch (...)
-        {
-            result.success = false;
-            result.errorMessage = "Unknown exception during compilation";
-        }
-
+        result.success = compiled->success;
+        result.errorMessage = compiled->errorMessage;
         return result;
     }
 
@@ -609,23 +690,13 @@ namespace vkBasalt
     };
 
     std::vector<PreprocessorDefinition> extractPreprocessorDefinitions(
-        const std::string& effectName,
-        const std::string& effectPath)
+        const CompiledReshadeEffect& compiled)
     {
         std::vector<PreprocessorDefinition> defs;
+        const std::string& effectName = compiled.effectName;
 
-        // Setup preprocessor
-        reshadefx::preprocessor preprocessor;
-        setupPreprocessor(preprocessor);
-
-        if (!preprocessor.append_file(effectPath))
-        {
-            Logger::err("extractPreprocessorDefinitions: failed to load shader: " + effectPath);
-            return defs;
-        }
-
-        // Get all macros that were actually used in the shader
-        auto usedMacros = preprocessor.used_macro_definitions();
+        // Macros that were actually used in the shader
+        const auto& usedMacros = compiled.usedMacros;
 
         for (const auto& [name, value] : usedMacros)
         {
@@ -656,4 +727,34 @@ namespace vkBasalt
         return defs;
     }
 
+    std::vector<TechniqueState> extractTechniques(const reshadefx::module& module)
+    {
+        auto annotationSet = [](const reshadefx::technique_info& technique, const std::string& name, bool& value) {
+            auto it = std::find_if(technique.annotations.begin(), technique.annotations.end(),
+                [&name](const auto& a) { return a.name == name; });
+            if (it == technique.annotations.end())
+                return false;
+            value = it->type.is_floating_point() ? it->value.as_float[0] != 0.0f : it->value.as_uint[0] != 0;
+            return true;
+        };
+
+        std::vector<TechniqueState> techniques;
+        for (size_t i = 0; i < module.techniques.size(); i++)
+        {
+            const auto& technique = module.techniques[i];
+
+            bool enabled = false;
+            bool hidden  = false;
+            if (!annotationSet(technique, "enabled", enabled))
+                enabled = !(annotationSet(technique, "hidden", hidden) && hidden) && i == 0;
+
+            TechniqueState state;
+            state.name = technique.name;
+            state.enabled = enabled;
+            state.defaultEnabled = enabled;
+            techniques.push_back(state);
+        }
+        return techniques;
+    }
+
 } // namespace vkBasalt
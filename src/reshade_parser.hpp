@@ -4,10 +4,15 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
+#include <unordered_map>
+#include <cstdint>
 
 #include "effects/effect_config.hpp"
 #include "effects/params/effect_param.hpp"
 #include "config.hpp"
+#include "reshade/effect_module.hpp"
+#include "reshade_texture.hpp"
 
 namespace vkBasalt
 {
@@ -20,13 +25,49 @@ namespace vkBasalt
         std::string errorMessage;   // Error message if failed
     };
 
-    // Parse a ReShade .fx file and extract its parameters without creating Vulkan resources.
-    // effectName: display name for the effect (used in EffectParam.effectName)
-    // effectPath: full path to the .fx file
-    // pConfig: config for getting includePath and current param values
-    std::vector<std::unique_ptr<EffectParam>> parseReshadeEffect(
+    // Inputs that change the compiled module (everything else comes from the .fx file itself)
+    struct ReshadeCompileOptions
+    {
+        uint32_t bufferWidth = 1920;
+        uint32_t bufferHeight = 1080;
+        uint32_t colorDepth = 8;
+        bool uniformsToSpecConstants = true;           // False when ReShade params live in the uniform buffer
+        std::vector<PreprocessorDefinition> customDefs; // User-configurable macros
+    };
+
+    // Result of one preprocess/parse/codegen run over a ReShade effect.
+    // Shared by the registry (errors, parameters, macros) and ReshadeEffect (module),
+    // so an effect is compiled once instead of once per consumer.
+    struct CompiledReshadeEffect
+    {
+        std::string effectName;
+        std::string filePath;
+        bool success = false;
+        std::string errorMessage;   // Error if failed, warnings if succeeded
+        reshadefx::module module;
+        std::vector<std::pair<std::string, std::string>> macros;      // Macros passed to the preprocessor
+        std::vector<std::pair<std::string, std::string>> usedMacros;  // Macros referenced by the shader
+        bool uniformsToSpecConstants = true;
+        std::unordered_map<std::string, ReshadeTextureData> textures;  // "source" textures by unique_name (see loadReshadeTextures)
+
+        // Check if this result can be reused for a compile with the given options
+        bool matches(const ReshadeCompileOptions& options) const;
+    };
+
+    // Compile a ReShade .fx file without creating Vulkan resources (uses the on-disk module cache).
+    std::shared_ptr<CompiledReshadeEffect> compileReshadeEffect(
         const std::string& effectName,
         const std::string& effectPath,
+        const ReshadeCompileOptions& options);
+
+    // Decode the "source" textures of a successfully compiled effect into compiled.textures,
+    // so ReshadeEffect only has to upload them.
+    void loadReshadeTextures(CompiledReshadeEffect& compiled);
+
+    // Extract the parameters of a compiled ReShade effect.
+    // pConfig: config for getting current param values
+    std::vector<std::unique_ptr<EffectParam>> parseReshadeEffect(
+        const CompiledReshadeEffect& compiled,
         Config* pConfig);
 
     // Test a ReShade .fx shader for compilation errors without creating Vulkan resources.
@@ -35,12 +76,15 @@ namespace vkBasalt
         const std::string& effectName,
         const std::string& effectPath);
 
-    // Extract user-configurable preprocessor definitions from a ReShade shader.
+    // Extract user-configurable preprocessor definitions from a compiled ReShade effect.
     // These are macros used via #ifndef/#ifdef that aren't built-in (like __RESHADE__).
-    // Returns empty vector for built-in effects or if no user macros are found.
+    // Returns empty vector if no user macros are found.
     std::vector<PreprocessorDefinition> extractPreprocessorDefinitions(
-        const std::string& effectName,
-        const std::string& effectPath);
+        const CompiledReshadeEffect& compiled);
+
+    // Techniques of a compiled ReShade module in declaration order, enabled as ReShade would by default:
+    // an "enabled" annotation decides, hidden techniques are off, otherwise only the first one runs.
+    std::vector<TechniqueState> extractTechniques(const reshadefx::module& module);
 
 } // namespace vkBasalt
 
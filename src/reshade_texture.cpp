@@ -0,0 +1,99 @@
+#include "reshade_texture.hpp"
+
+#include <cstdio>
+#include <algorithm>
+
+#include "logger.hpp"
+
+#include "stb_image.h"
+#include "stb_image_dds.h"
+#include "stb_image_resize.h"
+
+namespace vkBasalt
+{
+    ReshadeTextureData loadReshadeTexture(const reshadefx::texture_info& info, const std::vector<std::string>& searchPaths)
+    {
+        // Channels decoded from the file, and channels kept for the texture format
+        int desiredChannels;
+        int textureChannels;
+        switch (info.format)
+        {
+            case reshadefx::texture_format::r8:
+                desiredChannels = STBI_grey;
+                textureChannels = 1;
+                break;
+            case reshadefx::texture_format::rg8:
+                desiredChannels = STBI_rgb_alpha; // TODO why doesn't STBI_grey_alpha work?
+                textureChannels = 2;
+                break;
+            case reshadefx::texture_format::rgba8:
+                desiredChannels = STBI_rgb_alpha;
+                textureChannels = 4;
+                break;
+            default:
+                Logger::err("unsupported texture upload format" + std::to_string(static_cast<uint32_t>(info.format)));
+                desiredChannels = STBI_rgb_alpha;
+                textureChannels = 4;
+                break;
+        }
+
+        ReshadeTextureData result;
+        result.pixels.resize(static_cast<size_t>(info.width) * info.height * textureChannels);
+
+        const auto source = std::find_if(info.annotations.begin(), info.annotations.end(), [](const auto& a) { return a.name == "source"; });
+        if (source == info.annotations.end())
+            return result;
+
+        // Search for texture in discovered paths from shader manager
+        std::string textureName = source->value.string_data;
+        FILE* file = nullptr;
+        for (const auto& texPath : searchPaths)
+        {
+            std::string filePath = texPath + "/" + textureName;
+            file = fopen(filePath.c_str(), "rb");
+            if (file != nullptr)
+                break;
+        }
+
+        if (file == nullptr)
+        {
+            Logger::err("couldn't open texture: " + textureName + " (searched " + std::to_string(searchPaths.size()) + " directories)");
+            return result;
+        }
+
+        int      width;
+        int      height;
+        int      channels;
+        stbi_uc* pixels = stbi_dds_test_file(file) ? stbi_dds_load_from_file(file, &width, &height, &channels, desiredChannels)
+                                                   : stbi_load_from_file(file, &width, &height, &channels, desiredChannels);
+        fclose(file);
+
+        if (pixels == nullptr)
+        {
+            Logger::err("couldn't decode texture: " + textureName);
+            return result;
+        }
+
+        std::vector<stbi_uc> resizedPixels;
+        const stbi_uc*       extentPixels = pixels;
+        if (static_cast<uint32_t>(width) != info.width || static_cast<uint32_t>(height) != info.height)
+        {
+            resizedPixels.resize(static_cast<size_t>(info.width) * info.height * desiredChannels);
+            stbir_resize_uint8(pixels, width, height, 0, resizedPixels.data(), info.width, info.height, 0, desiredChannels);
+            extentPixels = resizedPixels.data();
+        }
+
+        // change RGBA to RG
+        size_t pixelCount = static_cast<size_t>(info.width) * info.height;
+        for (size_t j = 0; j < pixelCount; j++)
+        {
+            for (int c = 0; c < textureChannels; c++)
+                result.pixels[j * textureChannels + c] = extentPixels[j * desiredChannels + c];
+        }
+
+        stbi_image_free(pixels);
+        result.loaded = true;
+        return result;
+    }
+
+} // namespace vkBasalt
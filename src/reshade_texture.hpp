@@ -0,0 +1,26 @@
+#ifndef RESHADE_TEXTURE_HPP_INCLUDED
+#define RESHADE_TEXTURE_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "reshade/effect_module.hpp"
+
+namespace vkBasalt
+{
+    // Pixels of a ReShade "source" texture, decoded from its image file and ready for uploadToImage
+    struct ReshadeTextureData
+    {
+        std::vector<uint8_t> pixels;  // Texture extent, tightly packed with the texture format's channel count
+        bool loaded = false;          // False if the file was missing or undecodable (pixels are then zero)
+    };
+
+    // Decode the image named by a texture's "source" annotation, resized to the texture extent.
+    // No Vulkan calls, so this can run on the compile threads.
+    // searchPaths: directories searched for the file (discovered texture paths of the shader manager)
+    ReshadeTextureData loadReshadeTexture(const reshadefx::texture_info& info, const std::vector<std::string>& searchPaths);
+
+} // namespace vkBasalt
+
+#endif // RESHADE_TEXTURE_HPP_INCLUDED
@@ -1,13 +1,13 @@
 #include "reshade_uniforms.hpp"
 
 #include <cstring>
-#include <ctime>
 #include <cstdlib>
 #include <cmath>
 
 #include <algorithm>
 
 #include "logger.hpp"
+#include "effects/effect_registry.hpp"
 
 namespace vkBasalt
 {
@@ -15,71 +15,126 @@ namespace vkBasalt
     {
         for (auto& uniform : module.uniforms)
         {
-            auto source = std::find_if(uniform.annotations.begin(), uniform.annotations.end(), [](const auto& a) {
-                              return a.name == "source";
-                          })->value.string_data;
-            Logger::debug(source);
+            auto source = std::find_if(uniform.annotations.begin(), uniform.annotations.end(), [](const auto& a) { return a.name == "source"; });
+            Logger::debug(source != uniform.annotations.end() ? source->value.string_data : "parameter " + uniform.name);
             Logger::debug("size: " + std::to_string(uniform.size));
             Logger::debug("offset: " + std::to_string(uniform.offset));
         }
     }
 
-    std::vector<std::shared_ptr<ReshadeUniform>> createReshadeUniforms(reshadefx::module module)
-    {
-        std::vector<std::shared_ptr<ReshadeUniform>> uniforms;
+    ReshadeUniforms createReshadeUniforms(reshadefx::module module, EffectRegistry* pEffectRegistry, std::string effectName)
+    {
+        ReshadeUniforms uniforms;
+        auto            addOnChange = [&](ReshadeUniform* pUniform) {
+            uniforms.all.push_back(std::shared_ptr<ReshadeUniform>(pUniform));
+            uniforms.onChange.push_back(pUniform);
+        };
+        auto addPerFrame = [&](PerFrameSource source, ReshadeUniform* pUniform) {
+            uniforms.all.push_back(std::shared_ptr<ReshadeUniform>(pUniform));
+            uniforms.perFrame.push_back({source, pUniform});
+        };
+
         for (auto& uniform : module.uniforms)
         {
-            auto source = std::find_if(uniform.annotations.begin(), uniform.annotations.end(), [](const auto& a) {
-                              return a.name == "source";
-                          })->value.string_data;
+            auto sourceAnnotation =
+                std::find_if(uniform.annotations.begin(), uniform.annotations.end(), [](const auto& a) { return a.name == "source"; });
+            if (sourceAnnotation == uniform.annotations.end())
+            {
+                addOnChange(new ParameterUniform(uniform, pEffectRegistry, effectName));
+                continue;
+            }
+            auto source = sourceAnnotation->value.string_data;
             if (source == "frametime")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new FrameTimeUniform(uniform)));
+                addPerFrame(PerFrameSource::FrameTime, new FrameTimeUniform(uniform));
             }
             else if (source == "framecount")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new FrameCountUniform(uniform)));
+                addPerFrame(PerFrameSource::FrameCount, new FrameCountUniform(uniform));
             }
             else if (source == "date")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new DateUniform(uniform)));
+                addPerFrame(PerFrameSource::Date, new DateUniform(uniform));
             }
             else if (source == "timer")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new TimerUniform(uniform)));
+                addPerFrame(PerFrameSource::Timer, new TimerUniform(uniform));
             }
             else if (source == "pingpong")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new PingPongUniform(uniform)));
+                addPerFrame(PerFrameSource::PingPong, new PingPongUniform(uniform));
             }
             else if (source == "random")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new RandomUniform(uniform)));
+                addPerFrame(PerFrameSource::Random, new RandomUniform(uniform));
             }
             else if (source == "key")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new KeyUniform(uniform)));
+                addPerFrame(PerFrameSource::Key, new KeyUniform(uniform));
             }
             else if (source == "mousebutton")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new MouseButtonUniform(uniform)));
+                addPerFrame(PerFrameSource::MouseButton, new MouseButtonUniform(uniform));
             }
             else if (source == "mousepoint")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new MousePointUniform(uniform)));
+                addPerFrame(PerFrameSource::MousePoint, new MousePointUniform(uniform));
             }
             else if (source == "mousedelta")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new MouseDeltaUniform(uniform)));
+                addPerFrame(PerFrameSource::MouseDelta, new MouseDeltaUniform(uniform));
             }
+            else if (source == "overlay_open")
+            {
+                addPerFrame(PerFrameSource::OverlayOpen, new OverlayOpenUniform(uniform));
+            }
+            else if (source == "overlay_active")
+            {
+                addPerFrame(PerFrameSource::OverlayActive, new OverlayActiveUniform(uniform, effectName));
+            }
+            else if (source == "screenshot")
+            {
+                addPerFrame(PerFrameSource::Screenshot, new ScreenshotUniform(uniform));
+            }
+            // Depth availability is constant until it is hooked up (see the TODO below)
             else if (source == "bufready_depth")
             {
-                uniforms.push_back(std::shared_ptr<ReshadeUniform>(new DepthUniform(uniform)));
+                addOnChange(new DepthUniform(uniform));
             }
         }
         return uniforms;
     }
 
+    void ReshadeUniforms::updateOnChange(uint8_t* buffer, const FrameContext& frame)
+    {
+        for (auto* pUniform : onChange)
+            pUniform->update(buffer, frame);
+    }
+
+    void ReshadeUniforms::updatePerFrame(uint8_t* buffer, const FrameContext& frame)
+    {
+        // The classes are final, so these calls are direct
+        for (const auto& uniform : perFrame)
+        {
+            switch (uniform.source)
+            {
+                case PerFrameSource::FrameTime: static_cast<FrameTimeUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::FrameCount: static_cast<FrameCountUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::Date: static_cast<DateUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::Timer: static_cast<TimerUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::PingPong: static_cast<PingPongUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::Random: static_cast<RandomUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::Key: static_cast<KeyUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::MouseButton: static_cast<MouseButtonUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::MousePoint: static_cast<MousePointUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::MouseDelta: static_cast<MouseDeltaUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::OverlayOpen: static_cast<OverlayOpenUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::OverlayActive: static_cast<OverlayActiveUniform*>(uniform.pUniform)->update(buffer, frame); break;
+                case PerFrameSource::Screenshot: static_cast<ScreenshotUniform*>(uniform.pUniform)->update(buffer, frame); break;
+            }
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////
     FrameTimeUniform::FrameTimeUniform(reshadefx::uniform_info uniformInfo)
     {
@@ -88,17 +143,12 @@ namespace vkBasalt
         {
             Logger::err("Tried to create a FrameTimeUniform from a non frametime uniform_info");
         }
-        lastFrame = std::chrono::high_resolution_clock::now();
-        offset    = uniformInfo.offset;
-        size      = uniformInfo.size;
+        offset = uniformInfo.offset;
+        size   = uniformInfo.size;
     }
-    void FrameTimeUniform::update(void* mapedBuffer)
+    void FrameTimeUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        auto                                     currentFrame = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<float, std::milli> duration     = currentFrame - lastFrame;
-        lastFrame                                             = currentFrame;
-        float frametime                                       = duration.count();
-        std::memcpy((uint8_t*) mapedBuffer + offset, &(frametime), sizeof(float));
+        std::memcpy((uint8_t*) mapedBuffer + offset, &(frame.frameTime), sizeof(float));
     }
     FrameTimeUniform::~FrameTimeUniform()
     {
@@ -115,10 +165,9 @@ namespace vkBasalt
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void FrameCountUniform::update(void* mapedBuffer)
+    void FrameCountUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        std::memcpy((uint8_t*) mapedBuffer + offset, &(count), sizeof(int32_t));
-        count++;
+        std::memcpy((uint8_t*) mapedBuffer + offset, &(frame.frameCount), sizeof(int32_t));
     }
     FrameCountUniform::~FrameCountUniform()
     {
@@ -135,17 +184,9 @@ namespace vkBasalt
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void DateUniform::update(void* mapedBuffer)
+    void DateUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        auto        now         = std::chrono::system_clock::now();
-        std::time_t nowC        = std::chrono::system_clock::to_time_t(now);
-        struct tm*  currentTime = std::localtime(&nowC);
-        float       year        = 1900.0f + static_cast<float>(currentTime->tm_year);
-        float       month       = 1.0f + static_cast<float>(currentTime->tm_mon);
-        float       day         = static_cast<float>(currentTime->tm_mday);
-        float       seconds     = static_cast<float>((currentTime->tm_hour * 60 + currentTime->tm_min) * 60 + currentTime->tm_sec);
-        float       date[]      = {year, month, day, seconds};
-        std::memcpy((uint8_t*) mapedBuffer + offset, date, sizeof(float) * 4);
+        std::memcpy((uint8_t*) mapedBuffer + offset, frame.date, sizeof(float) * 4);
     }
     DateUniform::~DateUniform()
     {
@@ -159,16 +200,12 @@ namespace vkBasalt
         {
             Logger::err("Tried to create a TimerUniform from a non timer uniform_info");
         }
-        start  = std::chrono::high_resolution_clock::now();
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void TimerUniform::update(void* mapedBuffer)
+    void TimerUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        auto                                     currentFrame = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<float, std::milli> duration     = currentFrame - start;
-        float                                    timer        = duration.count();
-        std::memcpy((uint8_t*) mapedBuffer + offset, &(timer), sizeof(float));
+        std::memcpy((uint8_t*) mapedBuffer + offset, &(frame.timer), sizeof(float));
     }
     TimerUniform::~TimerUniform()
     {
@@ -211,22 +248,18 @@ namespace vkBasalt
                 stepAnnotation->type.is_floating_point() ? stepAnnotation->value.as_float[1] : static_cast<float>(stepAnnotation->value.as_int[1]);
         }
 
-        lastFrame = std::chrono::high_resolution_clock::now();
-
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void PingPongUniform::update(void* mapedBuffer)
+    void PingPongUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        auto currentFrame = std::chrono::high_resolution_clock::now();
-
-        std::chrono::duration<float, std::ratio<1>> frameTime = currentFrame - lastFrame;
+        float frameTime = frame.frameTime / 1000.0f;
 
         float increment = stepMax == 0 ? stepMin : (stepMin + std::fmod(static_cast<float>(std::rand()), stepMax - stepMin + 1.0f));
         if (currentValue[1] >= 0)
         {
             increment = std::max(increment - std::max(0.0f, smoothing - (max - currentValue[0])), 0.05f);
-            increment *= frameTime.count();
+            increment *= frameTime;
 
             if ((currentValue[0] += increment) >= max)
             {
@@ -236,7 +269,7 @@ namespace vkBasalt
         else
         {
             increment = std::max(increment - std::max(0.0f, smoothing - (currentValue[0] - min)), 0.05f);
-            increment *= frameTime.count();
+            increment *= frameTime;
 
             if ((currentValue[0] -= increment) <= min)
             {
@@ -272,7 +305,7 @@ namespace vkBasalt
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void RandomUniform::update(void* mapedBuffer)
+    void RandomUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
         int32_t value = min + (std::rand() % (max - min + 1));
         std::memcpy((uint8_t*) mapedBuffer + offset, &(value), sizeof(int32_t));
@@ -282,6 +315,39 @@ namespace vkBasalt
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    namespace
+    {
+        // "keycode" (also the mouse button index) and "mode" annotations
+        void parseButtonAnnotations(const reshadefx::uniform_info& uniformInfo, uint32_t& code, ButtonMode& mode)
+        {
+            if (auto codeAnnotation =
+                    std::find_if(uniformInfo.annotations.begin(), uniformInfo.annotations.end(), [](const auto& a) { return a.name == "keycode"; });
+                codeAnnotation != uniformInfo.annotations.end())
+            {
+                code = codeAnnotation->type.is_integral() ? codeAnnotation->value.as_uint[0] : static_cast<uint32_t>(codeAnnotation->value.as_float[0]);
+            }
+            if (auto modeAnnotation =
+                    std::find_if(uniformInfo.annotations.begin(), uniformInfo.annotations.end(), [](const auto& a) { return a.name == "mode"; });
+                modeAnnotation != uniformInfo.annotations.end())
+            {
+                if (modeAnnotation->value.string_data == "press")
+                    mode = ButtonMode::Press;
+                else if (modeAnnotation->value.string_data == "toggle")
+                    mode = ButtonMode::Toggle;
+            }
+        }
+
+        VkBool32 getButtonValue(ButtonMode mode, bool down, bool pressed, bool& toggled)
+        {
+            switch (mode)
+            {
+                case ButtonMode::Press: return pressed;
+                case ButtonMode::Toggle: return toggled ^= pressed;
+                default: return down;
+            }
+        }
+    } // namespace
+
     KeyUniform::KeyUniform(reshadefx::uniform_info uniformInfo)
     {
         auto source = std::find_if(uniformInfo.annotations.begin(), uniformInfo.annotations.end(), [](const auto& a) { return a.name == "source"; });
@@ -289,16 +355,20 @@ namespace vkBasalt
         {
             Logger::err("Tried to create a KeyUniform from a non key uniform_info");
         }
+        parseButtonAnnotations(uniformInfo, keyCode, mode);
+        watchKey(keyCode);
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void KeyUniform::update(void* mapedBuffer)
+    void KeyUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        VkBool32 keyDown = VK_FALSE; // TODO
+        bool     known   = keyCode < frame.keysDown.size();
+        VkBool32 keyDown = getButtonValue(mode, known && frame.keysDown[keyCode], known && frame.keysPressed[keyCode], toggled);
         std::memcpy((uint8_t*) mapedBuffer + offset, &(keyDown), sizeof(VkBool32));
     }
     KeyUniform::~KeyUniform()
     {
+        unwatchKey(keyCode);
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -309,12 +379,15 @@ namespace vkBasalt
         {
             Logger::err("Tried to create a MouseButtonUniform from a non mousebutton uniform_info");
         }
+        parseButtonAnnotations(uniformInfo, button, mode);
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void MouseButtonUniform::update(void* mapedBuffer)
+    void MouseButtonUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        VkBool32 keyDown = VK_FALSE; // TODO
+        // Only left, right and middle are tracked
+        bool     known   = button < 3;
+        VkBool32 keyDown = getButtonValue(mode, known && frame.mouseDown[button], known && frame.mousePressed[button], toggled);
         std::memcpy((uint8_t*) mapedBuffer + offset, &(keyDown), sizeof(VkBool32));
     }
     MouseButtonUniform::~MouseButtonUniform()
@@ -332,10 +405,9 @@ namespace vkBasalt
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void MousePointUniform::update(void* mapedBuffer)
+    void MousePointUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        float point[2] = {0.0f, 0.0f}; // TODO
-        std::memcpy((uint8_t*) mapedBuffer + offset, point, sizeof(float) * 2);
+        std::memcpy((uint8_t*) mapedBuffer + offset, frame.mousePoint, sizeof(float) * 2);
     }
     MousePointUniform::~MousePointUniform()
     {
@@ -352,15 +424,164 @@ namespace vkBasalt
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void MouseDeltaUniform::update(void* mapedBuffer)
+    void MouseDeltaUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
-        float delta[2] = {0.0f, 0.0f}; // TODO
-        std::memcpy((uint8_t*) mapedBuffer + offset, delta, sizeof(float) * 2);
+        std::memcpy((uint8_t*) mapedBuffer + offset, frame.mouseDelta, sizeof(float) * 2);
     }
     MouseDeltaUniform::~MouseDeltaUniform()
     {
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    OverlayOpenUniform::OverlayOpenUniform(reshadefx::uniform_info uniformInfo)
+    {
+        auto source = std::find_if(uniformInfo.annotations.begin(), uniformInfo.annotations.end(), [](const auto& a) { return a.name == "source"; });
+        if (source->value.string_data != "overlay_open")
+        {
+            Logger::err("Tried to create an OverlayOpenUniform from a non overlay_open uniform_info");
+        }
+        offset = uniformInfo.offset;
+        size   = uniformInfo.size;
+    }
+    void OverlayOpenUniform::update(void* mapedBuffer, const FrameContext& frame)
+    {
+        VkBool32 overlayOpen = frame.overlayOpen;
+        std::memcpy((uint8_t*) mapedBuffer + offset, &(overlayOpen), sizeof(VkBool32));
+    }
+    OverlayOpenUniform::~OverlayOpenUniform()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    OverlayActiveUniform::OverlayActiveUniform(reshadefx::uniform_info uniformInfo, std::string effectName)
+    {
+        auto source = std::find_if(uniformInfo.annotations.begin(), uniformInfo.annotations.end(), [](const auto& a) { return a.name == "source"; });
+        if (source->value.string_data != "overlay_active")
+        {
+            Logger::err("Tried to create an OverlayActiveUniform from a non overlay_active uniform_info");
+        }
+        this->effectName = effectName;
+        offset           = uniformInfo.offset;
+        size             = uniformInfo.size;
+    }
+    void OverlayActiveUniform::update(void* mapedBuffer, const FrameContext& frame)
+    {
+        uint32_t active = frame.activeParamIndex && frame.activeParamEffect == effectName ? frame.activeParamIndex : 0;
+        std::memcpy((uint8_t*) mapedBuffer + offset, &(active), sizeof(uint32_t));
+    }
+    OverlayActiveUniform::~OverlayActiveUniform()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ScreenshotUniform::ScreenshotUniform(reshadefx::uniform_info uniformInfo)
+    {
+        auto source = std::find_if(uniformInfo.annotations.begin(), uniformInfo.annotations.end(), [](const auto& a) { return a.name == "source"; });
+        if (source->value.string_data != "screenshot")
+        {
+            Logger::err("Tried to create a ScreenshotUniform from a non screenshot uniform_info");
+        }
+        offset = uniformInfo.offset;
+        size   = uniformInfo.size;
+    }
+    void ScreenshotUniform::update(void* mapedBuffer, const FrameContext& frame)
+    {
+        VkBool32 screenshot = frame.screenshot;
+        std::memcpy((uint8_t*) mapedBuffer + offset, &(screenshot), sizeof(VkBool32));
+    }
+    ScreenshotUniform::~ScreenshotUniform()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ParameterUniform::ParameterUniform(reshadefx::uniform_info uniformInfo, EffectRegistry* pEffectRegistry, std::string effectName)
+    {
+        this->pEffectRegistry = pEffectRegistry;
+        this->effectName      = effectName;
+        name                  = uniformInfo.name;
+        type                  = uniformInfo.type;
+        defaultValue          = uniformInfo.initializer_value;
+        offset                = uniformInfo.offset;
+        size                  = uniformInfo.size;
+        resolveParam();
+    }
+    void ParameterUniform::resolveParam()
+    {
+        if (!pEffectRegistry)
+            return;
+        paramSetGeneration = pEffectRegistry->getParameterSetGeneration();
+        param              = pEffectRegistry->getParameter(effectName, name);
+    }
+    void ParameterUniform::update(void* mapedBuffer, const FrameContext& frame)
+    {
+        uint8_t* dst = (uint8_t*) mapedBuffer + offset;
+
+        // Matrices and arrays are not exposed as parameters, keep their initializer with the std140 row/element stride
+        if (type.is_matrix() || type.is_array())
+        {
+            const uint32_t rowStride     = type.is_matrix() ? 16 : 4;
+            const uint32_t elementStride = (type.rows * rowStride + 15) & ~15u;
+            const uint32_t elementCount  = type.is_array() ? static_cast<uint32_t>(defaultValue.array_data.size()) : 1;
+            for (uint32_t element = 0; element < elementCount; element++)
+            {
+                const reshadefx::constant& value = type.is_array() ? defaultValue.array_data[element] : defaultValue;
+                for (uint32_t row = 0; row < type.rows; row++)
+                {
+                    std::memcpy(dst + element * elementStride + row * rowStride, &value.as_uint[row * type.cols], sizeof(uint32_t) * type.cols);
+                }
+            }
+            return;
+        }
+
+        uint32_t components = std::min<uint32_t>(type.rows, 4);
+        uint32_t data[4];
+        std::memcpy(data, defaultValue.as_uint, sizeof(data));
+
+        // Get parameter from EffectRegistry (the single source of truth), fall back to the initializer
+        if (pEffectRegistry && pEffectRegistry->getParameterSetGeneration() != paramSetGeneration)
+            resolveParam();
+        if (param)
+        {
+            switch (param->getType())
+            {
+                case ParamType::Float: std::memcpy(data, &static_cast<FloatParam*>(param)->value, sizeof(float)); break;
+                case ParamType::Int: std::memcpy(data, &static_cast<IntParam*>(param)->value, sizeof(int32_t)); break;
+                case ParamType::Uint: data[0] = static_cast<UintParam*>(param)->value; break;
+                case ParamType::Bool: data[0] = static_cast<BoolParam*>(param)->value ? 1 : 0; break;
+                case ParamType::FloatVec:
+                {
+                    auto* p    = static_cast<FloatVecParam*>(param);
+                    components = std::min(components, p->componentCount);
+                    std::memcpy(data, p->value, sizeof(float) * components);
+                    break;
+                }
+                case ParamType::IntVec:
+                {
+                    auto* p    = static_cast<IntVecParam*>(param);
+                    components = std::min(components, p->componentCount);
+                    std::memcpy(data, p->value, sizeof(int32_t) * components);
+                    break;
+                }
+                case ParamType::UintVec:
+                {
+                    auto* p    = static_cast<UintVecParam*>(param);
+                    components = std::min(components, p->componentCount);
+                    std::memcpy(data, p->value, sizeof(uint32_t) * components);
+                    break;
+                }
+            }
+        }
+        else if (type.is_boolean())
+        {
+            data[0] = defaultValue.as_uint[0] ? 1 : 0;
+        }
+
+        std::memcpy(dst, data, sizeof(uint32_t) * components);
+    }
+    ParameterUniform::~ParameterUniform()
+    {
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////
     DepthUniform::DepthUniform(reshadefx::uniform_info uniformInfo)
     {
@@ -372,7 +593,7 @@ namespace vkBasalt
         offset = uniformInfo.offset;
         size   = uniformInfo.size;
     }
-    void DepthUniform::update(void* mapedBuffer)
+    void DepthUniform::update(void* mapedBuffer, const FrameContext& frame)
     {
         VkBool32 hasDepth = VK_FALSE; // TODO
         std::memcpy((uint8_t*) mapedBuffer + offset, &(hasDepth), sizeof(VkBool32));
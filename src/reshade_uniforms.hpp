@@ -12,14 +12,19 @@
 
 #include "reshade/effect_module.hpp"
 
+#include "frame_context.hpp"
+
 namespace vkBasalt
 {
+    class EffectRegistry;
+    class EffectParam;
+
     void enumerateReshadeUniforms(reshadefx::module module);
 
     class ReshadeUniform
     {
     public:
-        void virtual update(void* mapedBuffer) = 0;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) = 0;
         virtual ~ReshadeUniform(){};
 
     protected:
@@ -27,59 +32,86 @@ namespace vkBasalt
         uint32_t size;
     };
 
-    std::vector<std::shared_ptr<ReshadeUniform>> createReshadeUniforms(reshadefx::module module);
+    // Sources whose value changes every frame, they are updated through a switch instead of virtual calls
+    enum class PerFrameSource
+    {
+        FrameTime,
+        FrameCount,
+        Date,
+        Timer,
+        PingPong,
+        Random,
+        Key,
+        MouseButton,
+        MousePoint,
+        MouseDelta,
+        OverlayOpen,
+        OverlayActive,
+        Screenshot,
+    };
+
+    struct PerFrameUniform
+    {
+        PerFrameSource  source;
+        ReshadeUniform* pUniform;
+    };
+
+    // The uniforms of an effect, classified by their source when the effect is created
+    struct ReshadeUniforms
+    {
+        std::vector<std::shared_ptr<ReshadeUniform>> all;
+        // Parameters and sources with a fixed value, they only need writing when a buffer is stale
+        // (new buffer or EffectRegistry::getParameterGeneration() changed)
+        std::vector<ReshadeUniform*> onChange;
+        std::vector<PerFrameUniform> perFrame;
+
+        void updateOnChange(uint8_t* buffer, const FrameContext& frame);
+        void updatePerFrame(uint8_t* buffer, const FrameContext& frame);
+    };
+
+    // Uniforms without a "source" annotation are user parameters, they are read from pEffectRegistry
+    ReshadeUniforms createReshadeUniforms(reshadefx::module module, EffectRegistry* pEffectRegistry, std::string effectName);
 
-    class FrameTimeUniform : public ReshadeUniform
+    class FrameTimeUniform final : public ReshadeUniform
     {
     public:
         FrameTimeUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~FrameTimeUniform();
-
-    private:
-        std::chrono::time_point<std::chrono::high_resolution_clock> lastFrame;
     };
 
-    class FrameCountUniform : public ReshadeUniform
+    class FrameCountUniform final : public ReshadeUniform
     {
     public:
         FrameCountUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~FrameCountUniform();
-
-    private:
-        int32_t count = 0;
     };
 
-    class DateUniform : public ReshadeUniform
+    class DateUniform final : public ReshadeUniform
     {
     public:
         DateUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~DateUniform();
     };
 
-    class TimerUniform : public ReshadeUniform
+    class TimerUniform final : public ReshadeUniform
     {
     public:
         TimerUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~TimerUniform();
-
-    private:
-        std::chrono::time_point<std::chrono::high_resolution_clock> start;
     };
 
-    class PingPongUniform : public ReshadeUniform
+    class PingPongUniform final : public ReshadeUniform
     {
     public:
         PingPongUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~PingPongUniform();
 
     private:
-        std::chrono::time_point<std::chrono::high_resolution_clock> lastFrame;
-
         float min             = 0.0f;
         float max             = 0.0f;
         float stepMin         = 0.0f;
@@ -88,11 +120,11 @@ namespace vkBasalt
         float currentValue[2] = {0.0f, 1.0f};
     };
 
-    class RandomUniform : public ReshadeUniform
+    class RandomUniform final : public ReshadeUniform
     {
     public:
         RandomUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~RandomUniform();
 
     private:
@@ -100,43 +132,108 @@ namespace vkBasalt
         int min = 0;
     };
 
-    class KeyUniform : public ReshadeUniform
+    // "mode" annotation of key and mouse button uniforms
+    enum class ButtonMode
+    {
+        Down,     // While held
+        Press,    // On the frame it went down
+        Toggle,   // Flips on every press
+    };
+
+    class KeyUniform final : public ReshadeUniform
     {
     public:
         KeyUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~KeyUniform();
+
+    private:
+        uint32_t   keyCode = 0;
+        ButtonMode mode    = ButtonMode::Down;
+        bool       toggled = false;
     };
 
-    class MouseButtonUniform : public ReshadeUniform
+    class MouseButtonUniform final : public ReshadeUniform
     {
     public:
         MouseButtonUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~MouseButtonUniform();
+
+    private:
+        uint32_t   button  = 0;
+        ButtonMode mode    = ButtonMode::Down;
+        bool       toggled = false;
     };
 
-    class MousePointUniform : public ReshadeUniform
+    class MousePointUniform final : public ReshadeUniform
     {
     public:
         MousePointUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~MousePointUniform();
     };
 
-    class MouseDeltaUniform : public ReshadeUniform
+    class MouseDeltaUniform final : public ReshadeUniform
     {
     public:
         MouseDeltaUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~MouseDeltaUniform();
     };
 
+    class ParameterUniform : public ReshadeUniform
+    {
+    public:
+        ParameterUniform(reshadefx::uniform_info uniformInfo, EffectRegistry* pEffectRegistry, std::string effectName);
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
+        virtual ~ParameterUniform();
+
+    private:
+        EffectRegistry*     pEffectRegistry;
+        std::string         effectName;
+        std::string         name;
+        reshadefx::type     type;
+        reshadefx::constant defaultValue;
+        EffectParam*        param = nullptr;  // Looked up once per registry parameter set, not every update
+        uint64_t            paramSetGeneration = 0;
+
+        void resolveParam();
+    };
+
+    class OverlayOpenUniform final : public ReshadeUniform
+    {
+    public:
+        OverlayOpenUniform(reshadefx::uniform_info uniformInfo);
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
+        virtual ~OverlayOpenUniform();
+    };
+
+    // Index of the parameter of this effect that is being edited in the overlay, 0 if none
+    class OverlayActiveUniform final : public ReshadeUniform
+    {
+    public:
+        OverlayActiveUniform(reshadefx::uniform_info uniformInfo, std::string effectName);
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
+        virtual ~OverlayActiveUniform();
+
+    private:
+        std::string effectName;
+    };
+
+    class ScreenshotUniform final : public ReshadeUniform
+    {
+    public:
+        ScreenshotUniform(reshadefx::uniform_info uniformInfo);
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
+        virtual ~ScreenshotUniform();
+    };
+
     class DepthUniform : public ReshadeUniform
     {
     public:
         DepthUniform(reshadefx::uniform_info uniformInfo);
-        void virtual update(void* mapedBuffer) override;
+        void virtual update(void* mapedBuffer, const FrameContext& frame) override;
         virtual ~DepthUniform();
     };
 } // namespace vkBasalt
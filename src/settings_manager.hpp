@@ -27,28 +27,30 @@ namespace vkBasalt
         bool save();
 
         // Getters
-        int getMaxEffects() const { return settings.maxEffects; }
         bool getOverlayBlockInput() const { return settings.overlayBlockInput; }
         const std::string& getToggleKey() const { return settings.toggleKey; }
         const std::string& getReloadKey() const { return settings.reloadKey; }
         const std::string& getOverlayKey() const { return settings.overlayKey; }
         bool getEnableOnLaunch() const { return settings.enableOnLaunch; }
         bool getDepthCapture() const { return settings.depthCapture; }
+        bool getEffectQueue() const { return settings.effectQueue; }
         bool getAutoApply() const { return settings.autoApply; }
         int getAutoApplyDelay() const { return settings.autoApplyDelay; }
         bool getShowDebugWindow() const { return settings.showDebugWindow; }
+        bool getLiveParams() const { return settings.liveParams; }
 
         // Setters (update in-memory state, call save() to persist)
-        void setMaxEffects(int value) { settings.maxEffects = value; }
         void setOverlayBlockInput(bool value) { settings.overlayBlockInput = value; }
         void setToggleKey(const std::string& value) { settings.toggleKey = value; }
         void setReloadKey(const std::string& value) { settings.reloadKey = value; }
         void setOverlayKey(const std::string& value) { settings.overlayKey = value; }
         void setEnableOnLaunch(bool value) { settings.enableOnLaunch = value; }
         void setDepthCapture(bool value) { settings.depthCapture = value; }
+        void setEffectQueue(bool value) { settings.effectQueue = value; }
         void setAutoApply(bool value) { settings.autoApply = value; }
         void setAutoApplyDelay(int value) { settings.autoApplyDelay = value; }
         void setShowDebugWindow(bool value) { settings.showDebugWindow = value; }
+        void setLiveParams(bool value) { settings.liveParams = value; }
 
         // Get raw settings struct (for bulk operations)
         const VkBasaltSettings& getSettings() const { return settings; }
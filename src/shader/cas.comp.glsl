@@ -0,0 +1,107 @@
+// LICENSE
+// =======
+// Copyright (c) 2017-2019 Advanced Micro Devices, Inc. All rights reserved.
+// -------
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation
+// files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy,
+// modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+// -------
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+// Software.
+// -------
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "compute_effect.h"
+#include "fused_lut.h"
+
+layout(set=0, binding=0) uniform sampler2D img;
+
+layout (constant_id = 0) const float sharpness = 0.4;
+
+// The 3x3 neighbourhoods of a workgroup overlap, so its pixels plus a one pixel border are fetched once
+#define TILE_SIZE (COMPUTE_GROUP_SIZE + 2)
+shared vec4 tile[TILE_SIZE][TILE_SIZE];
+
+vec4 loadPixel(ivec2 pixel, ivec2 size)
+{
+    return textureLod(img, pixelCoord(clamp(pixel, ivec2(0), size - 1), size), 0.0f);
+}
+
+vec3 tileColor(ivec2 local, int x, int y)
+{
+    return tile[local.y + 1 + y][local.x + 1 + x].rgb;
+}
+
+void main()
+{
+    ivec2 size   = textureSize(img, 0);
+    ivec2 origin = ivec2(gl_WorkGroupID.xy) * COMPUTE_GROUP_SIZE - 1;
+    for (uint i = gl_LocalInvocationIndex; i < TILE_SIZE * TILE_SIZE; i += COMPUTE_GROUP_SIZE * COMPUTE_GROUP_SIZE)
+    {
+        ivec2 local = ivec2(i % TILE_SIZE, i / TILE_SIZE);
+        tile[local.y][local.x] = loadPixel(origin + local, size);
+    }
+    barrier();
+
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, size)))
+        return;
+    ivec2 local = ivec2(gl_LocalInvocationID.xy);
+
+    // fetch a 3x3 neighborhood around the pixel 'e',
+    //  a b c
+    //  d(e)f
+    //  g h i
+    vec4 inputColor = tile[local.y + 1][local.x + 1];
+    float alpha = inputColor.a;
+
+    vec3 a = tileColor(local, -1, -1);
+    vec3 b = tileColor(local,  0, -1);
+    vec3 c = tileColor(local,  1, -1);
+    vec3 d = tileColor(local, -1,  0);
+    vec3 e = inputColor.rgb;
+    vec3 f = tileColor(local,  1,  0);
+    vec3 g = tileColor(local, -1,  1);
+    vec3 h = tileColor(local,  0,  1);
+    vec3 i = tileColor(local,  1,  1);
+
+    // Soft min and max.
+    //  a b c             b
+    //  d e f * 0.5  +  d e f * 0.5
+    //  g h i             h
+    // These are 2.0x bigger (factored out the extra multiply).
+
+    vec3 mnRGB  = min(min(min(d,e),min(f,b)),h);
+    vec3 mnRGB2 = min(min(min(mnRGB,a),min(g,c)),i);
+    mnRGB += mnRGB2;
+
+    vec3 mxRGB  = max(max(max(d,e),max(f,b)),h);
+    vec3 mxRGB2 = max(max(max(mxRGB,a),max(g,c)),i);
+    mxRGB += mxRGB2;
+
+    // Smooth minimum distance to signal limit divided by smooth max.
+
+    vec3 rcpMxRGB = vec3(1)/mxRGB;
+    vec3 ampRGB = clamp((min(mnRGB,2.0-mxRGB) * rcpMxRGB),0,1);
+
+    // Shaping amount of sharpening.
+    ampRGB = inversesqrt(ampRGB);
+    float peak = 8.0 - 3.0 * sharpness;
+    vec3 wRGB = -vec3(1)/(ampRGB * peak);
+    vec3 rcpWeightRGB = vec3(1)/(1.0 + 4.0 * wRGB);
+
+    //                          0 w 0
+    //  Filter shape:           w 1 w
+    //                          0 w 0  
+
+    vec3 window = (b + d) + (f + h);
+    vec3 outColor = clamp((window * wRGB + e) * rcpWeightRGB,0,1);
+
+    storeColor(pixel, applyFusedStages(vec4(outColor,alpha)));
+}
@@ -15,6 +15,9 @@
 // COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 // ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE
 #version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "fused_lut.h"
 
 layout(set=0, binding=0) uniform sampler2D img;
 
@@ -77,5 +80,5 @@ void main()
     vec3 window = (b + d) + (f + h);
     vec3 outColor = clamp((window * wRGB + e) * rcpWeightRGB,0,1);
 
-    fragColor = vec4(outColor,alpha);
+    fragColor = applyFusedStages(vec4(outColor,alpha));
 }
@@ -0,0 +1,30 @@
+// Shared by the compute variants of the builtin effects.
+// Binding 0 is the input (same as the fragment shaders), binding 1 the output written as a storage image.
+// The output is always viewed as UNORM, so sRGB outputs are encoded here instead of by the image view.
+
+#include "compute_interface.h"
+
+layout(local_size_x = COMPUTE_GROUP_SIZE, local_size_y = COMPUTE_GROUP_SIZE) in;
+
+layout(set=0, binding=1) uniform writeonly image2D outImg;
+
+layout(constant_id = OUTPUT_SRGB_CONSTANT_ID) const bool outputSrgb = false;
+
+vec3 encodeSrgb(vec3 color)
+{
+    color = clamp(color, 0.0, 1.0);
+    return mix(color * 12.92, 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055, greaterThan(color, vec3(0.0031308)));
+}
+
+void storeColor(ivec2 pixel, vec4 color)
+{
+    if (outputSrgb)
+        color.rgb = encodeSrgb(color.rgb);
+    imageStore(outImg, pixel, color);
+}
+
+// Texture coordinate of a pixel center, what the fragment shaders get as textureCoord
+vec2 pixelCoord(ivec2 pixel, ivec2 size)
+{
+    return (vec2(pixel) + 0.5) / vec2(size);
+}
@@ -0,0 +1,15 @@
+// Values the compute shaders and SimpleEffect have to agree on.
+// Plain defines only, this is included from GLSL (compute_effect.h, fused_lut.h) and C++ (effect_simple.hpp).
+
+#ifndef COMPUTE_INTERFACE_H_INCLUDED
+#define COMPUTE_INTERFACE_H_INCLUDED
+
+#define COMPUTE_GROUP_SIZE 16
+
+// Specialization constant ids, the ones below 50 belong to the individual effects
+#define FUSED_LUT_SIZE_CONSTANT_ID 50
+#define FUSED_LUT_FLIP_GB_CONSTANT_ID 51
+#define FUSED_LUT_INPUT_LEVELS_CONSTANT_ID 52
+#define OUTPUT_SRGB_CONSTANT_ID 100
+
+#endif // COMPUTE_INTERFACE_H_INCLUDED
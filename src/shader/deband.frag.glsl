@@ -23,6 +23,9 @@
  * SOFTWARE.
  */
 #version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "fused_lut.h"
 
 layout(set=0, binding=0) uniform sampler2D img;
 
@@ -162,5 +165,5 @@ void main()
 	//shift the color by dither_shift
 	res += dither_shift_RGB;
 
-    fragColor = vec4(res,ori_alpha.a);
+    fragColor = applyFusedStages(vec4(res,ori_alpha.a));
 }
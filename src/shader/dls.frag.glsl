@@ -21,6 +21,9 @@
 */
 
 #version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "fused_lut.h"
 
 layout(set=0, binding=0) uniform sampler2D img;
 
@@ -148,5 +151,5 @@ void main()
     x.y += delta;
     x.z += delta;
 
-    fragColor = x;
+    fragColor = applyFusedStages(x);
 }
@@ -0,0 +1,44 @@
+// Lut effect applied at the end of the effect it was fused into.
+// The FUSED_LUT variants of the shaders are compiled with it, the others pass the color through.
+
+#ifdef FUSED_LUT
+
+#include "compute_interface.h"
+
+layout(set=1, binding=0) uniform sampler3D fusedLut;
+
+//Only works with cubes not with cuboids
+layout(constant_id = FUSED_LUT_SIZE_CONSTANT_ID) const int fusedLutSize = 32;
+layout(constant_id = FUSED_LUT_FLIP_GB_CONSTANT_ID) const int fusedFlipGB = 0;
+// Highest value of the image the lut effect would read, 0 if it stores floats
+layout(constant_id = FUSED_LUT_INPUT_LEVELS_CONSTANT_ID) const int fusedInputLevels = 255;
+
+vec4 applyFusedStages(vec4 color)
+{
+    // The lut effect reads its input from an UNORM image, so it never sees values outside of [0,1]
+    color = clamp(color, 0.0, 1.0);
+    // and it reads them rounded to what the image stores, round the same way so both paths pick the same lut cells
+    if(fusedInputLevels != 0)
+    {
+        color.rgb = floor(color.rgb * float(fusedInputLevels) + 0.5) / float(fusedInputLevels);
+    }
+    if(fusedFlipGB != 0)
+    {
+        color = color.rbga;
+    }
+
+    //see https://developer.nvidia.com/gpugems/GPUGems2/gpugems2_chapter24.html
+    vec3 scale = (vec3(fusedLutSize) - 1.0) / vec3(fusedLutSize);
+    vec3 offset = 1.0 / (2.0 * vec3(fusedLutSize));
+
+    return vec4(textureLod(fusedLut, scale * color.rgb + offset, 0.0f).rgb, color.a);
+}
+
+#else
+
+vec4 applyFusedStages(vec4 color)
+{
+    return color;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#version 450
+#extension  GL_GOOGLE_include_directive : require
+
+#define FXAA_QUALITY_PRESET 39
+#define FXAA_GLSL_130 1
+#define FXAA_PC 1
+#define FXAA_GREEN_AS_LUMA 1
+
+#include "fxaa3_11.h"
+#include "compute_effect.h"
+
+layout(set=0, binding=0) uniform sampler2D img;
+
+layout (constant_id = 0) const float fxaaQualitySubpix = 0.75;
+layout (constant_id = 1) const float fxaaQualityEdgeThreshold = 0.125;
+layout (constant_id = 2) const float fxaaQualityEdgeThresholdMin = 0.0312;
+layout (constant_id = 3) const float screenWidth = 1920;
+layout (constant_id = 4) const float screenHeight = 1080;
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (pixel.x >= int(screenWidth) || pixel.y >= int(screenHeight))
+        return;
+
+    vec2 size = vec2(screenWidth,screenHeight);
+    vec2 fxaaQualityRcpFrame = vec2(1.0)/size;
+    vec4 zero = vec4(0.0);
+    vec2 textureCoord = (vec2(pixel) + 0.5) * fxaaQualityRcpFrame;
+    storeColor(pixel, FxaaPixelShader(textureCoord, zero, img, img, img, fxaaQualityRcpFrame, zero, zero, zero, fxaaQualitySubpix, fxaaQualityEdgeThreshold, fxaaQualityEdgeThresholdMin, 8.0, 0.125, 0.05, zero));
+}
@@ -0,0 +1,38 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "compute_effect.h"
+
+layout(set=0, binding=0) uniform sampler2D img;
+layout(set=1, binding=0) uniform sampler3D lut;
+
+//Only works with cubes not with cuboids
+layout(constant_id = 0) const int lutSize = 32;
+layout(constant_id = 1) const int flipGB = 0;
+
+#define textureLod0(img, coord) textureLod(img, coord, 0.0f)
+
+void main()
+{
+    ivec2 size  = textureSize(img, 0);
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, size)))
+        return;
+    vec2 textureCoord = pixelCoord(pixel, size);
+
+    vec4 color;
+    if(flipGB != 0)
+    {
+        color = textureLod0(img,textureCoord).rbga;
+    }
+    else
+    {
+        color = textureLod0(img,textureCoord);
+    }
+
+    //see https://developer.nvidia.com/gpugems/GPUGems2/gpugems2_chapter24.html
+    vec3 scale = (vec3(lutSize) - 1.0) / vec3(lutSize);
+    vec3 offset = 1.0 / (2.0 * vec3(lutSize));
+
+    storeColor(pixel, vec4(textureLod0(lut, scale * color.rgb + offset).rgb, color.a));
+}
@@ -5,26 +5,62 @@
 
 namespace vkBasalt
 {
+    const std::vector<uint32_t> cas_comp = {
+#include "cas.comp.h"
+    };
+
+    const std::vector<uint32_t> cas_comp_lut = {
+#include "cas.comp.lut.h"
+    };
+
     const std::vector<uint32_t> cas_frag = {
 #include "cas.frag.h"
     };
 
+    const std::vector<uint32_t> cas_frag_lut = {
+#include "cas.frag.lut.h"
+    };
+
     const std::vector<uint32_t> deband_frag = {
 #include "deband.frag.h"
     };
 
+    const std::vector<uint32_t> deband_frag_lut = {
+#include "deband.frag.lut.h"
+    };
+
+    const std::vector<uint32_t> dls_comp = {
+#include "dls.comp.h"
+    };
+
+    const std::vector<uint32_t> dls_comp_lut = {
+#include "dls.comp.lut.h"
+    };
+
     const std::vector<uint32_t> dls_frag = {
 #include "dls.frag.h"
     };
 
+    const std::vector<uint32_t> dls_frag_lut = {
+#include "dls.frag.lut.h"
+    };
+
     const std::vector<uint32_t> full_screen_triangle_vert = {
 #include "full_screen_triangle.vert.h"
     };
 
+    const std::vector<uint32_t> fxaa_comp = {
+#include "fxaa.comp.h"
+    };
+
     const std::vector<uint32_t> fxaa_frag = {
 #include "fxaa.frag.h"
     };
 
+    const std::vector<uint32_t> lut_comp = {
+#include "lut.comp.h"
+    };
+
     const std::vector<uint32_t> lut_frag = {
 #include "lut.frag.h"
     };
@@ -0,0 +1,42 @@
+#include "stencil_attachment.hpp"
+
+#include "image.hpp"
+#include "image_view.hpp"
+#include "format.hpp"
+
+namespace vkBasalt
+{
+    StencilAttachment::StencilAttachment(LogicalDevice* pLogicalDevice, VkExtent2D imageExtent)
+    {
+        this->pLogicalDevice = pLogicalDevice;
+        this->imageExtent    = imageExtent;
+        format               = getStencilFormat(pLogicalDevice);
+    }
+
+    VkImageView StencilAttachment::getImageView()
+    {
+        if (view != VK_NULL_HANDLE)
+            return view;
+
+        Logger::debug("creating shared stencil image, format: " + std::to_string(format));
+        image = createImages(pLogicalDevice,
+                             1,
+                             {imageExtent.width, imageExtent.height, 1},
+                             format,
+                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                             memory)[0];
+
+        view = createImageViews(pLogicalDevice, format, {image}, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)[0];
+        return view;
+    }
+
+    StencilAttachment::~StencilAttachment()
+    {
+        if (view == VK_NULL_HANDLE)
+            return;
+        pLogicalDevice->vkd.DestroyImageView(pLogicalDevice->device, view, nullptr);
+        pLogicalDevice->vkd.DestroyImage(pLogicalDevice->device, image, nullptr);
+        pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, memory, nullptr);
+    }
+} // namespace vkBasalt
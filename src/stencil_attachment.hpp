@@ -0,0 +1,31 @@
+#ifndef STENCIL_ATTACHMENT_HPP_INCLUDED
+#define STENCIL_ATTACHMENT_HPP_INCLUDED
+
+#include "vulkan_include.hpp"
+
+#include "logical_device.hpp"
+
+namespace vkBasalt
+{
+    // Depth/stencil scratch image of a swapchain, shared by its ReShade effects since they run one after another.
+    // The image is only allocated once an effect has a pass with stencil state.
+    struct StencilAttachment
+    {
+        LogicalDevice* pLogicalDevice;
+        VkExtent2D     imageExtent;
+        VkFormat       format = VK_FORMAT_UNDEFINED;
+        VkImage        image  = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkImageView    view   = VK_NULL_HANDLE;
+
+        StencilAttachment(LogicalDevice* pLogicalDevice, VkExtent2D imageExtent);
+        StencilAttachment(const StencilAttachment&)            = delete;
+        StencilAttachment& operator=(const StencilAttachment&) = delete;
+        ~StencilAttachment();
+
+        // Creates the image on first use
+        VkImageView getImageView();
+    };
+} // namespace vkBasalt
+
+#endif // STENCIL_ATTACHMENT_HPP_INCLUDED
@@ -0,0 +1,87 @@
+#include "uniform_ring.hpp"
+
+#include <cstring>
+
+#include "buffer.hpp"
+#include "descriptor_set.hpp"
+
+namespace vkBasalt
+{
+    UniformRing::~UniformRing()
+    {
+        pLogicalDevice->vkd.DestroyDescriptorPool(pLogicalDevice->device, descriptorPool, nullptr);
+        pLogicalDevice->vkd.DestroyDescriptorSetLayout(pLogicalDevice->device, descriptorSetLayout, nullptr);
+        pLogicalDevice->vkd.UnmapMemory(pLogicalDevice->device, memory);
+        pLogicalDevice->vkd.FreeMemory(pLogicalDevice->device, memory, nullptr);
+        pLogicalDevice->vkd.DestroyBuffer(pLogicalDevice->device, buffer, nullptr);
+    }
+
+    void UniformRing::waitForSlice(uint32_t imageIndex)
+    {
+        if (sliceSubmits[imageIndex] > pLogicalDevice->frameSync.completedSerial)
+            waitForSubmit(pLogicalDevice, sliceSubmits[imageIndex]);
+    }
+
+    std::shared_ptr<UniformRing> createUniformRing(LogicalDevice*                              pLogicalDevice,
+                                                   uint32_t                                    imageCount,
+                                                   const std::vector<std::shared_ptr<Effect>>& effects)
+    {
+        VkPhysicalDeviceProperties properties;
+        pLogicalDevice->vki.GetPhysicalDeviceProperties(pLogicalDevice->physicalDevice, &properties);
+        VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+        auto         align     = [alignment](VkDeviceSize size) { return (size + alignment - 1) / alignment * alignment; };
+
+        // Ranges of the effects in a slice, back to back
+        std::vector<VkDeviceSize> offsets(effects.size());
+        VkDeviceSize              sliceSize = 0;
+        uint32_t                  userCount = 0;
+        for (size_t i = 0; i < effects.size(); i++)
+        {
+            uint32_t size = effects[i]->getUniformSize();
+            if (!size)
+                continue;
+            offsets[i] = sliceSize;
+            sliceSize  = align(sliceSize + size);
+            userCount++;
+        }
+        if (!userCount)
+            return nullptr;
+
+        auto ring            = std::make_shared<UniformRing>();
+        ring->pLogicalDevice = pLogicalDevice;
+        ring->sliceSize      = sliceSize;
+        ring->sliceSubmits.resize(imageCount, 0);
+
+        createBuffer(pLogicalDevice,
+                     sliceSize * imageCount,
+                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                     ring->buffer,
+                     ring->memory);
+
+        void*    data;
+        VkResult result = pLogicalDevice->vkd.MapMemory(pLogicalDevice->device, ring->memory, 0, VK_WHOLE_SIZE, 0, &data);
+        ASSERT_VULKAN(result);
+        ring->mapped = static_cast<uint8_t*>(data);
+        std::memset(ring->mapped, 0, sliceSize * imageCount);
+
+        VkDescriptorPoolSize poolSize;
+        poolSize.type              = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        poolSize.descriptorCount   = userCount;
+        ring->descriptorPool      = createDescriptorPool(pLogicalDevice, {poolSize});
+        ring->descriptorSetLayout = createUniformBufferDescriptorSetLayout(pLogicalDevice);
+
+        for (size_t i = 0; i < effects.size(); i++)
+        {
+            uint32_t size = effects[i]->getUniformSize();
+            if (!size)
+                continue;
+            VkDescriptorSet descriptorSet =
+                writeBufferDescriptorSet(pLogicalDevice, ring->descriptorPool, ring->descriptorSetLayout, ring->buffer, size);
+            effects[i]->useUniformRing(ring.get(), descriptorSet, offsets[i]);
+        }
+
+        Logger::debug("uniform ring: " + std::to_string(userCount) + " effects, " + std::to_string(sliceSize) + " bytes per image");
+        return ring;
+    }
+} // namespace vkBasalt
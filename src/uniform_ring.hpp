@@ -0,0 +1,41 @@
+#ifndef UNIFORM_RING_HPP_INCLUDED
+#define UNIFORM_RING_HPP_INCLUDED
+#include <vector>
+#include <memory>
+
+#include "vulkan_include.hpp"
+
+#include "logical_device.hpp"
+
+#include "effects/effect.hpp"
+
+namespace vkBasalt
+{
+    // Uniforms of all effects of a swapchain in one persistently mapped, host coherent buffer.
+    // Every swapchain image has its own slice, so a frame never writes what an earlier one may still read.
+    // Effects bind their range as a dynamic uniform buffer at offset imageIndex * sliceSize + their offset.
+    struct UniformRing
+    {
+        LogicalDevice*        pLogicalDevice;
+        VkBuffer              buffer              = VK_NULL_HANDLE;
+        VkDeviceMemory        memory              = VK_NULL_HANDLE;
+        uint8_t*              mapped              = nullptr;
+        VkDeviceSize          sliceSize           = 0;
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool      descriptorPool      = VK_NULL_HANDLE;
+        std::vector<uint64_t> sliceSubmits;  // Last layer submit reading each slice
+
+        ~UniformRing();
+
+        // Block until no frame in flight reads the slice of this image anymore
+        void waitForSlice(uint32_t imageIndex);
+    };
+
+    // Lays out the uniforms of the effects in one ring and hands each effect its range (see Effect::useUniformRing).
+    // Returns nullptr if no effect has uniforms.
+    std::shared_ptr<UniformRing> createUniformRing(LogicalDevice*                              pLogicalDevice,
+                                                   uint32_t                                    imageCount,
+                                                   const std::vector<std::shared_ptr<Effect>>& effects);
+} // namespace vkBasalt
+
+#endif // UNIFORM_RING_HPP_INCLUDED
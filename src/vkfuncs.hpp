@@ -3,10 +3,12 @@
     FORVKFUNC(DestroyInstance) \
     FORVKFUNC(EnumerateDeviceExtensionProperties) \
     FORVKFUNC(GetInstanceProcAddr) \
+    FORVKFUNC(GetPhysicalDeviceFeatures) \
     FORVKFUNC(GetPhysicalDeviceFormatProperties) \
     FORVKFUNC(GetPhysicalDeviceMemoryProperties) \
     FORVKFUNC(GetPhysicalDeviceQueueFamilyProperties) \
-    FORVKFUNC(GetPhysicalDeviceProperties)
+    FORVKFUNC(GetPhysicalDeviceProperties) \
+    FORVKFUNC(GetPhysicalDeviceSurfaceCapabilitiesKHR)
 
 #define VK_DEVICE_FUNCS \
     FORVKFUNC(AllocateCommandBuffers) \
@@ -16,6 +18,7 @@
     FORVKFUNC(BindBufferMemory) \
     FORVKFUNC(BindImageMemory) \
     FORVKFUNC(CmdBeginRenderPass) \
+    FORVKFUNC(CmdBeginRendering) \
     FORVKFUNC(CmdBindDescriptorSets) \
     FORVKFUNC(CmdBindIndexBuffer) \
     FORVKFUNC(CmdBindPipeline) \
@@ -23,15 +26,18 @@
     FORVKFUNC(CmdBlitImage) \
     FORVKFUNC(CmdCopyBufferToImage) \
     FORVKFUNC(CmdCopyImage) \
+    FORVKFUNC(CmdDispatch) \
     FORVKFUNC(CmdDraw) \
     FORVKFUNC(CmdDrawIndexed) \
     FORVKFUNC(CmdEndRenderPass) \
+    FORVKFUNC(CmdEndRendering) \
     FORVKFUNC(CmdPipelineBarrier) \
     FORVKFUNC(CmdPushConstants) \
     FORVKFUNC(CmdSetScissor) \
     FORVKFUNC(CmdSetViewport) \
     FORVKFUNC(CreateBuffer) \
     FORVKFUNC(CreateCommandPool) \
+    FORVKFUNC(CreateComputePipelines) \
     FORVKFUNC(CreateDescriptorPool) \
     FORVKFUNC(CreateDescriptorSetLayout) \
     FORVKFUNC(CreateFence) \
@@ -39,6 +45,7 @@
     FORVKFUNC(CreateGraphicsPipelines) \
     FORVKFUNC(CreateImage) \
     FORVKFUNC(CreateImageView) \
+    FORVKFUNC(CreatePipelineCache) \
     FORVKFUNC(CreatePipelineLayout) \
     FORVKFUNC(CreateRenderPass) \
     FORVKFUNC(CreateSampler) \
@@ -55,6 +62,7 @@
     FORVKFUNC(DestroyImage) \
     FORVKFUNC(DestroyImageView) \
     FORVKFUNC(DestroyPipeline) \
+    FORVKFUNC(DestroyPipelineCache) \
     FORVKFUNC(DestroyPipelineLayout) \
     FORVKFUNC(DestroyRenderPass) \
     FORVKFUNC(DestroySampler) \
@@ -70,7 +78,9 @@
     FORVKFUNC(GetDeviceProcAddr) \
     FORVKFUNC(GetDeviceQueue) \
     FORVKFUNC(GetDeviceQueue2) \
+    FORVKFUNC(GetFenceStatus) \
     FORVKFUNC(GetImageMemoryRequirements) \
+    FORVKFUNC(GetPipelineCacheData) \
     FORVKFUNC(GetSwapchainImagesKHR) \
     FORVKFUNC(MapMemory) \
     FORVKFUNC(QueuePresentKHR) \